@@ -1,187 +1,30 @@
-#include "pico/stdlib.h"
-#include "hardware/clocks.h"
-#include "hardware/sync.h"
-#include <stdio.h>
+/*
+채널별 1ms x 5회 디바운스
+- DETECT_1/2/3 상승엣지(interrupt) → 채널마다 독립으로 1ms tick 5회 연속 HIGH면 그 채널 HIT 출력
+- 판정 로직은 pico_mnq/detect_engine.h (여기는 설정만)
+*/
 
-#define LED             PICO_DEFAULT_LED_PIN
+#define DETECT_STRATEGY             DETECT_STRATEGY_CHANNEL
 
-// 입력 (interrupt)
-#define DETECT_1        3
-#define DETECT_2        4
-#define DETECT_3        5
+// debounce: 1ms tick(gpio_get_all 1회로 전 채널 동시 샘플) 5회 연속 HIGH면 확정
+#define DETECT_CONFIRM_SAMPLES      5
+#define DETECT_SAMPLE_US            1000    // 1ms
 
-// 출력
-#define HIT_1           12   // DETECT_2용 출력
-#define HIT_2           13   // DETECT_1용 출력
-#define HIT_3           14   // DETECT_3용 출력
+// 채널 : X(입력, 출력, 통계 이름)
+#define DETECT_CHANNELS(X) \
+    X(DETECT_1, HIT_2, "detect1")   /* DETECT_1 → HIT_2 */ \
+    X(DETECT_2, HIT_1, "detect2")   /* DETECT_2 → HIT_1 */ \
+    X(DETECT_3, HIT_3, "detect3")   /* DETECT_3 → HIT_3 */
 
-// interrupt
-static volatile bool detect1_rise = false;
-static volatile bool detect2_rise = false;
-static volatile bool detect3_rise = false;
+// HIT 출력 펄스 길이 / 같은 HIT 핀 펄스 사이 최소 LOW 시간
+#define HIT_PULSE_US                10000   // 10ms
+#define HIT_MIN_GAP_US              5000    // 5ms
 
-static void gpio_irq_callback(uint gpio, uint32_t events);
-static void ConfigureGpio(void);
-static void StartSignal(void);
-static bool Readsignal_detect_1(void);
-static bool Readsignal_detect_2(void);
-static bool Readsignal_detect_3(void);
-static void SendSignal(void);
+// main loop 1회에 꺼내는 최대 이벤트 수
+#define EDGE_DRAIN_BATCH            8u
 
-int main(){
-    stdio_init_all();
-    sleep_ms(10);
+// 통계 히스토그램 bucket 폭 (1 << shift us)
+#define STAT_EDGE_SHIFT             9       // edge → confirm : 512us 폭 (~8ms)
+#define STAT_OUT_SHIFT              6       // confirm → HIT  : 64us 폭 (~1ms)
 
-    set_sys_clock_khz(125000, true);
-    busy_wait_ms(100);
-
-    ConfigureGpio();
-    sleep_ms(10);
-
-    StartSignal();
-    sleep_ms(10);
-
-    while(true){
-        
-        SendSignal();
-        tight_loop_contents();
-    }
-    return 0;
-}
-
-static void StartSignal(void){
-    gpio_put(LED, 1);
-    sleep_ms(3000);
-    gpio_put(LED, 0);
-    sleep_ms(1000);
-}
-
-static void ConfigureGpio(void){
-    gpio_init(LED);
-    gpio_set_dir(LED, GPIO_OUT);
-    gpio_put(LED, 0);
-
-    gpio_init(DETECT_1);
-    gpio_set_dir(DETECT_1, GPIO_IN);
-    gpio_pull_down(DETECT_1);
-    gpio_set_irq_enabled_with_callback(DETECT_1, GPIO_IRQ_EDGE_RISE, true, &gpio_irq_callback);
-
-    gpio_init(DETECT_2);
-    gpio_set_dir(DETECT_2, GPIO_IN);
-    gpio_pull_down(DETECT_2);
-    gpio_set_irq_enabled(DETECT_2, GPIO_IRQ_EDGE_RISE, true);
-
-    gpio_init(DETECT_3);
-    gpio_set_dir(DETECT_3, GPIO_IN);
-    gpio_pull_down(DETECT_3);
-    gpio_set_irq_enabled(DETECT_3, GPIO_IRQ_EDGE_RISE, true);
-
-    gpio_init(HIT_1);
-    gpio_set_dir(HIT_1, GPIO_OUT);
-    gpio_put(HIT_1, 0);
-
-    gpio_init(HIT_2);
-    gpio_set_dir(HIT_2, GPIO_OUT);
-    gpio_put(HIT_2, 0);
-
-    gpio_init(HIT_3);
-    gpio_set_dir(HIT_3, GPIO_OUT);
-    gpio_put(HIT_3, 0);
-}
-
-static void gpio_irq_callback(uint gpio, uint32_t events) {
-    if (events & GPIO_IRQ_EDGE_RISE) {
-        if (gpio == DETECT_1)      detect1_rise = true;
-        else if (gpio == DETECT_2) detect2_rise = true;
-        else if (gpio == DETECT_3) detect3_rise = true;
-    }
-}
-
-// DETECT_1 신호 high 신호인지 확인 1ms 당 5번 
-static bool Readsignal_detect_1(void){
-    if (gpio_get(DETECT_1) == 0) return false;
-
-    for(int i = 0; i < 5; i++){
-        if (gpio_get(DETECT_1) == 0) return false;
-        sleep_ms(1);
-    }
-    return true;
-}
-
-// DETECT_2 신호 high 신호인지 확인 1ms 당 5번 
-static bool Readsignal_detect_2(void){
-    if (gpio_get(DETECT_2) == 0) return false;
-
-    for(int i = 0; i < 5; i++){
-        if (gpio_get(DETECT_2) == 0) return false;
-        sleep_ms(1);
-    }
-    return true;
-}
-
-// DETECT_3 신호 high 신호인지 확인 1ms 당 5번 
-static bool Readsignal_detect_3(void){
-    if (gpio_get(DETECT_3) == 0) return false;
-
-    for(int i = 0; i < 5; i++){
-        if (gpio_get(DETECT_3) == 0) return false;
-        sleep_ms(1);
-    }
-    return true;
-}
-
-// HIT 단자로 신호 high 보내기 10ms초 동안
-static inline void AllHitOff(void){
-    gpio_put(LED, 0);
-    gpio_put(HIT_1, 0);
-    gpio_put(HIT_2, 0);
-    gpio_put(HIT_3, 0);
-}
-
-// HIT 단자로 신호 high 보내기: 10ms 동안 (해당 채널만)
-static void SendSignal(void){
-    bool d1, d2, d3;
-
-    // 플래그는 원자적으로 가져오고 즉시 클리어 (인터럽트 안전)
-    uint32_t irq_state = save_and_disable_interrupts();
-    d1 = detect1_rise; detect1_rise = false;
-    d2 = detect2_rise; detect2_rise = false;
-    d3 = detect3_rise; detect3_rise = false;
-    restore_interrupts(irq_state);
-
-    // DETECT_1 → HIT_2
-    if (d1) {
-        if (Readsignal_detect_1()){
-            gpio_put(LED, 1);
-            gpio_put(HIT_1, 0);
-            gpio_put(HIT_2, 1);
-            gpio_put(HIT_3, 0);
-            sleep_ms(10);
-        }
-        AllHitOff();
-    }
-
-    // DETECT_2 → HIT_1
-    if (d2) {
-        if (Readsignal_detect_2()){
-            gpio_put(LED, 1);
-            gpio_put(HIT_1, 1);
-            gpio_put(HIT_2, 0);
-            gpio_put(HIT_3, 0);
-            sleep_ms(10);
-        }
-        AllHitOff();
-    }
-
-    // DETECT_3 → HIT_3
-    if (d3) {
-        if (Readsignal_detect_3()){
-            gpio_put(LED, 1);
-            gpio_put(HIT_1, 0);
-            gpio_put(HIT_2, 0);
-            gpio_put(HIT_3, 1);
-            sleep_ms(10);
-        }
-        AllHitOff();
-    }
-}
\ No newline at end of file
+#include "pico_mnq/detect_engine.h"
@@ -3,6 +3,13 @@ import machine
 import utime
 import micropython
 
+# mnqdetect (pico_mnq/mnqdetect, user C module)가 들어간 펌웨어면 판정/HIT 펄스를 C(IRQ)에서 실행
+# 없으면 아래 Python 루프 (인터프리터/GC/print 지연이 판정 경로에 그대로 들어감)
+try:
+    import mnqdetect
+except ImportError:
+    mnqdetect = None
+
 DETECT_1 = 3
 DETECT_2 = 4
 DETECT_3 = 5
@@ -18,6 +25,40 @@ detect1 = Pin(DETECT_1, Pin.IN, Pin.PULL_DOWN)
 detect2 = Pin(DETECT_2, Pin.IN, Pin.PULL_DOWN)
 detect3 = Pin(DETECT_3, Pin.IN, Pin.PULL_DOWN)
 
+# Helpers (원본 로직 유지)
+def start_signal():
+    led.value(1)
+    utime.sleep_ms(3000)
+    led.value(0)
+    utime.sleep_ms(1000)
+
+if mnqdetect is not None:
+    import array
+
+    # 1ms x 5회 디바운스, HIT 10ms / 같은 핀 최소 LOW 5ms (1ms_x_5times.c와 같은 값)
+    mnqdetect.init(((DETECT_1, HIT_2), (DETECT_2, HIT_1), (DETECT_3, HIT_3)),
+                   samples=5, sample_us=1000, pulse_us=10000, gap_us=5000)
+    for p in (detect1, detect2, detect3):
+        p.irq(trigger=Pin.IRQ_RISING, handler=mnqdetect.edge, hard=True)
+
+    # 이벤트 수신 버퍼 (미리 할당, read는 할당 없음)
+    EV_MAX = 8
+    W = mnqdetect.EVENT_WORDS
+    ev = array.array('i', bytes(4 * W * EV_MAX))
+    NAMES = ("D1", "D2", "D3")
+
+    def native_loop():
+        # HIT 펄스는 이미 C에서 나감 → print는 판정 경로 밖
+        while True:
+            n = mnqdetect.read(ev)
+            for i in range(n):
+                k = i * W
+                print(NAMES[ev[k]], ev[k + 2], ev[k + 3])   # 채널, edge → confirm us, confirm → HIT us
+            utime.sleep_ms(10)
+
+    start_signal()
+    native_loop()
+
 hit1 = Pin(HIT_1, Pin.OUT); hit1.value(0)
 hit2 = Pin(HIT_2, Pin.OUT); hit2.value(0)
 hit3 = Pin(HIT_3, Pin.OUT); hit3.value(0)
@@ -43,13 +84,6 @@ detect1.irq(trigger=Pin.IRQ_RISING, handler=_irq_detect1)
 detect2.irq(trigger=Pin.IRQ_RISING, handler=_irq_detect2)
 detect3.irq(trigger=Pin.IRQ_RISING, handler=_irq_detect3)
 
-# Helpers (원본 로직 유지)
-def start_signal():
-    led.value(1)
-    utime.sleep_ms(3000)
-    led.value(0)
-    utime.sleep_ms(1000)
-
 def all_hit_off():
     led.value(0)
     hit1.value(0)
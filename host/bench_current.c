@@ -0,0 +1,544 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "current_sense.h"
+
+/*
+모터 전류 stall 검출기 벤치마크 (host, pico_mnq/current_sense.h만 사용 : 펌웨어/shim 없음)
+- 합성 : mnq_plant.h와 같은 전류 모델 (부하 + stall 전류 x (duty - 속도), 속도는 1차 지연)로 스트로크 전류 샘플을 만들어 판정
+         스트로크마다 arm, 정답/종류 틀림/누락/오검출, 판정 시각 (stall 시작 → 판정 샘플), 스트로크 최대 전류
+- 캡처 : -r 파일 = little-endian uint16 ADC 샘플 연속 (adc_sampler ring을 순서대로 덤프한 것 등)
+         -i 입력 수 / -c 입력 번호 : round robin 캡처에서 한 입력만, 스트로크 = idle 레벨 이상인 구간 (gap ms 이상 끊기면 끝)
+         -w 파일 : 합성 버퍼를 같은 형식으로 저장 (-p 패턴 1개, 입력 1개)
+- 같은 버퍼를 통째로 / 무작위 길이 block / 1 샘플씩 넣어 결과가 같은지 확인 (block_invariant)
+- 검출기 처리 속도 (host ns/sample, 참고용)
+- 결과는 JSON
+*/
+
+// mnq_plant.h 전류 모델 (ADC count)
+#define BENCH_I_LOAD            400
+#define BENCH_I_STALL           3000
+#define BENCH_SPEED_TAU_MS      15u
+
+// 스트로크 사이 모터 정지 구간, stall 뒤 정지까지 (펌웨어 브레이크 대신)
+#define BENCH_GAP_MS            50u
+#define BENCH_STALL_MS          40u
+
+// 잡음 스파이크 (spikes 패턴) : 간격, 값
+#define BENCH_SPIKE_MS          40u
+#define BENCH_SPIKE_LEVEL       3500
+
+// 속도 측정 반복 (통째로 판정)
+#define BENCH_SPEED_RUNS        20
+
+// ------------ 패턴 ------------
+typedef struct {
+    const char *name;
+    const char *desc;
+    uint32_t duty_pct;
+    uint32_t run_ms;            // 스트로크 길이 (stall이 없으면 여기서 정지)
+    uint32_t stall_ms;          // 스트로크 시작 → stall (0 = 없음)
+    csense_kind_t expect;
+    bool spikes;
+} bench_pattern_t;
+
+static const bench_pattern_t g_patterns[] = {
+    { "end",        "full duty into the end stop",                  100, 300, 300, CSENSE_STALL, false },
+    { "early_jam",  "full duty, blocked right after blanking",      100, 300, 30,  CSENSE_STALL, false },
+    { "inrush",     "full duty, stops without stalling",            100, 300, 0,   CSENSE_NONE,  false },
+    { "spikes",     "end stop with short spikes (must be ignored)", 100, 300, 300, CSENSE_STALL, true  },
+    { "cruise_end", "half duty into the end stop (below level)",    50,  300, 300, CSENSE_RISE,  false },
+};
+
+#define PATTERN_COUNT   (int)(sizeof(g_patterns) / sizeof(g_patterns[0]))
+
+// ------------ 설정 ------------
+static uint32_t cfg_rate_hz = 5000;
+static uint32_t cfg_strokes = 100;
+static uint32_t cfg_noise = 30;
+static uint32_t cfg_seed = 1;
+static const char *cfg_only = NULL;
+
+// 캡처 : round robin 입력 수 / 입력 번호, 스트로크 구분
+static uint32_t cfg_inputs = 1;
+static uint32_t cfg_channel = 0;
+static uint32_t cfg_idle = 150;
+static uint32_t cfg_gap_ms = 10;
+
+// 판정 파라미터 (sub_pcb_mnq.c 기본값)
+static uint32_t cfg_blank_ms = 20;
+static uint32_t cfg_stall_level = 3200;
+static uint32_t cfg_rise = 800;
+static uint32_t cfg_confirm_n = 5;
+static uint32_t cfg_avg_shift = 5;
+
+static uint32_t ms_to_index(uint64_t ms) {
+    return (uint32_t)(ms * cfg_rate_hz / 1000u);
+}
+
+static double samples_to_us(uint64_t n) {
+    return (double)n * 1e6 / cfg_rate_hz;
+}
+
+static csense_cfg_t make_cfg(void) {
+    return (csense_cfg_t){
+        .blank_n = (uint16_t)ms_to_index(cfg_blank_ms),
+        .stall_level = (uint16_t)cfg_stall_level,
+        .rise = (uint16_t)cfg_rise,
+        .confirm_n = (uint16_t)cfg_confirm_n,
+        .avg_shift = (uint8_t)cfg_avg_shift,
+    };
+}
+
+// ------------ 버퍼 / 스트로크 ------------
+typedef struct {
+    uint32_t start, end;        // 샘플 [start, end), 채널 기준
+    uint32_t stall;             // stall 시작 샘플 (UINT32_MAX = 없음)
+} stroke_t;
+
+typedef struct {
+    bool hit;
+    csense_event_t ev;
+    uint16_t peak, run_peak;
+} stroke_out_t;
+
+static uint16_t *g_raw = NULL;
+static uint16_t *g_buf = NULL;          // 채널 첫 샘플 (캡처는 입력 cfg_inputs개 interleave)
+static uint32_t g_buf_n = 0;            // 채널 기준 샘플 수
+static uint32_t g_stride = 1;
+static stroke_t *g_strokes = NULL;
+static uint32_t g_stroke_n = 0;
+
+static stroke_out_t *g_whole, *g_rand, *g_single;
+
+// ------------ 판정 실행 ------------
+// block : 0 = 통째로, 1 = 1 샘플씩, 그 외 = 무작위 길이 (1 ~ block)
+// 스트로크 시작 샘플에서 arm, 끝 샘플에서 최대 전류 기록 → disarm (block은 경계에서 끊음)
+static void decode(const csense_cfg_t *cfg, uint32_t block, stroke_out_t *o) {
+    csense_t d;
+    uint32_t rng = 12345u;
+
+    csense_init(&d, cfg);
+    memset(o, 0, sizeof(*o) * (g_stroke_n ? g_stroke_n : 1u));
+    uint32_t at = 0;
+    uint32_t k = 0;             // 지금 / 다음 스트로크
+    bool in = false;
+    while (at < g_buf_n) {
+        if (k < g_stroke_n && !in && at == g_strokes[k].start) {
+            csense_arm(&d, at);
+            in = true;
+        }
+        uint32_t stop = g_buf_n;
+        if (k < g_stroke_n) stop = in ? g_strokes[k].end : g_strokes[k].start;
+
+        uint32_t len = stop - at;
+        if (block == 1) {
+            len = 1;
+        } else if (block > 1) {
+            rng = rng * 1103515245u + 12345u;
+            uint32_t r = 1u + (rng >> 8) % block;
+            if (r < len) len = r;
+        }
+        if (in) {
+            csense_event_t ev;
+            if (csense_feed(&d, &g_buf[(uint64_t)at * g_stride], len, g_stride, at, &ev)) {
+                o[k].hit = true;
+                o[k].ev = ev;
+            }
+        }
+        at += len;
+        if (in && at == g_strokes[k].end) {
+            o[k].peak = d.peak;
+            o[k].run_peak = d.run_peak;
+            csense_disarm(&d);
+            in = false;
+            k++;
+        }
+    }
+}
+
+static bool same_out(const stroke_out_t *a, const stroke_out_t *b) {
+    for (uint32_t i = 0; i < g_stroke_n; i++) {
+        if (a[i].hit != b[i].hit || a[i].peak != b[i].peak || a[i].run_peak != b[i].run_peak) return false;
+        if (!a[i].hit) continue;
+        if (a[i].ev.kind != b[i].ev.kind || a[i].ev.idx != b[i].ev.idx || a[i].ev.over_idx != b[i].ev.over_idx ||
+            a[i].ev.level != b[i].ev.level || a[i].ev.base != b[i].ev.base) return false;
+    }
+    return true;
+}
+
+// 통째 / 무작위 block / 1 샘플씩 비교
+static bool check_invariant(const csense_cfg_t *cfg) {
+    size_t n = g_stroke_n ? g_stroke_n : 1u;
+    free(g_whole);
+    free(g_rand);
+    free(g_single);
+    g_whole = calloc(n, sizeof(stroke_out_t));
+    g_rand = calloc(n, sizeof(stroke_out_t));
+    g_single = calloc(n, sizeof(stroke_out_t));
+    if (!g_whole || !g_rand || !g_single) {
+        perror("calloc");
+        exit(2);
+    }
+    decode(cfg, 0, g_whole);
+    decode(cfg, 97, g_rand);
+    decode(cfg, 1, g_single);
+    return same_out(g_whole, g_rand) && same_out(g_whole, g_single);
+}
+
+static double speed_ns_per_sample(const csense_cfg_t *cfg) {
+    stroke_out_t *o = calloc(g_stroke_n ? g_stroke_n : 1u, sizeof(stroke_out_t));
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int r = 0; o && r < BENCH_SPEED_RUNS; r++) decode(cfg, 0, o);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    free(o);
+    double ns = (double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec);
+    return g_buf_n ? ns / ((double)g_buf_n * BENCH_SPEED_RUNS) : 0.0;
+}
+
+// ------------ 합성 버퍼 ------------
+static uint32_t g_rng = 1;
+
+static uint32_t rnd(void) {
+    g_rng = g_rng * 1103515245u + 12345u;
+    return g_rng >> 16;
+}
+
+// -noise ~ +noise
+static int32_t noise(void) {
+    return cfg_noise ? (int32_t)(rnd() % (2u * cfg_noise + 1u)) - (int32_t)cfg_noise : 0;
+}
+
+static uint16_t clamp_adc(int32_t v) {
+    return (uint16_t)(v < 0 ? 0 : (v > 4095 ? 4095 : v));
+}
+
+static void alloc_buf(uint32_t n, uint32_t strokes) {
+    free(g_raw);
+    free(g_strokes);
+    g_raw = g_buf = calloc(n ? n : 1u, sizeof(uint16_t));
+    g_strokes = calloc(strokes ? strokes : 1u, sizeof(stroke_t));
+    if (!g_raw || !g_strokes) {
+        perror("calloc");
+        exit(2);
+    }
+    g_buf_n = n;
+    g_stroke_n = 0;
+    g_stride = 1;
+}
+
+// 정지 구간 (잡음만) + 스트로크 반복
+static void build(const bench_pattern_t *p) {
+    uint32_t gap = ms_to_index(BENCH_GAP_MS);
+    uint32_t run = ms_to_index(p->stall_ms ? p->stall_ms + BENCH_STALL_MS : p->run_ms);
+    alloc_buf(gap + cfg_strokes * (run + gap), cfg_strokes);
+    g_rng = cfg_seed;
+
+    const double alpha = 1000.0 / ((double)BENCH_SPEED_TAU_MS * cfg_rate_hz);
+    const double duty = p->duty_pct / 100.0;
+    uint32_t spike_every = ms_to_index(BENCH_SPIKE_MS);
+    uint32_t spike_n = cfg_confirm_n > 1 ? cfg_confirm_n - 1u : 0u;
+    uint32_t at = 0;
+
+    for (uint32_t s = 0; s < cfg_strokes; s++) {
+        for (uint32_t i = 0; i < gap; i++) g_buf[at++] = clamp_adc(noise());
+
+        stroke_t *st = &g_strokes[g_stroke_n++];
+        st->start = at;
+        st->end = at + run;
+        st->stall = p->stall_ms ? at + ms_to_index(p->stall_ms) : UINT32_MAX;
+        double speed = 0.0;
+        for (uint32_t i = 0; i < run; i++, at++) {
+            bool stalled = at >= st->stall;
+            speed = stalled ? 0.0 : speed + (duty - speed) * alpha;
+            double slip = duty - speed;
+            int32_t v = BENCH_I_LOAD + (int32_t)(BENCH_I_STALL * (slip > 0.0 ? slip : 0.0));
+            v += noise();
+            if (p->spikes && !stalled && i > 0 && spike_every && i % spike_every < spike_n) v = BENCH_SPIKE_LEVEL;
+            g_buf[at] = clamp_adc(v);
+        }
+    }
+    for (; at < g_buf_n; at++) g_buf[at] = clamp_adc(noise());
+}
+
+// ------------ 채점 ------------
+typedef struct {
+    uint32_t correct, wrong, missed, false_hits;
+    uint32_t lat_n;
+    double lat_sum, lat_min, lat_max;
+    double peak_sum, run_peak_sum;
+    uint32_t peak_max;
+} score_t;
+
+static void score(const bench_pattern_t *p, const stroke_out_t *o, score_t *sc) {
+    memset(sc, 0, sizeof(*sc));
+    for (uint32_t i = 0; i < g_stroke_n; i++) {
+        const stroke_t *st = &g_strokes[i];
+        sc->peak_sum += o[i].peak;
+        sc->run_peak_sum += o[i].run_peak;
+        if (o[i].peak > sc->peak_max) sc->peak_max = o[i].peak;
+
+        if (!o[i].hit) {
+            if (p->expect == CSENSE_NONE) sc->correct++;
+            else sc->missed++;
+            continue;
+        }
+        if (p->expect == CSENSE_NONE || o[i].ev.over_idx < st->stall) {
+            sc->false_hits++;
+            continue;
+        }
+        if (o[i].ev.kind != p->expect) {
+            sc->wrong++;
+            continue;
+        }
+        sc->correct++;
+        double lat = samples_to_us(o[i].ev.idx - st->stall);
+        if (sc->lat_n == 0 || lat < sc->lat_min) sc->lat_min = lat;
+        if (sc->lat_n == 0 || lat > sc->lat_max) sc->lat_max = lat;
+        sc->lat_sum += lat;
+        sc->lat_n++;
+    }
+}
+
+static const char *kind_name(csense_kind_t k) {
+    return k == CSENSE_STALL ? "stall" : (k == CSENSE_RISE ? "rise" : "none");
+}
+
+static void run_pattern(const bench_pattern_t *p, FILE *f) {
+    csense_cfg_t cfg = make_cfg();
+    build(p);
+    bool inv = check_invariant(&cfg);
+    score_t sc;
+    score(p, g_whole, &sc);
+    double ns = speed_ns_per_sample(&cfg);
+    double n = g_stroke_n ? (double)g_stroke_n : 1.0;
+
+    fprintf(f, "    {\"pattern\": \"%s\", \"desc\": \"%s\", \"expect\": \"%s\", \"samples\": %u, \"strokes\": %u,\n",
+            p->name, p->desc, kind_name(p->expect), g_buf_n, g_stroke_n);
+    fprintf(f, "     \"correct\": %u, \"wrong\": %u, \"missed\": %u, \"false\": %u, \"block_invariant\": %s, \"ns_per_sample\": %.2f,\n",
+            sc.correct, sc.wrong, sc.missed, sc.false_hits, inv ? "true" : "false", ns);
+    fprintf(f, "     \"peak\": {\"avg\": %.1f, \"max\": %u, \"run_avg\": %.1f},\n", sc.peak_sum / n, sc.peak_max, sc.run_peak_sum / n);
+    if (sc.lat_n == 0) {
+        fprintf(f, "     \"decide_us\": null}");
+    } else {
+        fprintf(f, "     \"decide_us\": {\"n\": %u, \"avg\": %.1f, \"min\": %.1f, \"max\": %.1f}}",
+                sc.lat_n, sc.lat_sum / sc.lat_n, sc.lat_min, sc.lat_max);
+    }
+}
+
+// ------------ 캡처 ------------
+static bool load_capture(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint32_t total = size > 0 ? (uint32_t)(size / 2) : 0;
+    g_raw = calloc(total ? total : 1u, sizeof(uint16_t));
+    for (uint32_t i = 0; g_raw && i < total; i++) {
+        uint8_t b[2];
+        if (fread(b, 1, 2, f) != 2) break;
+        g_raw[i] = (uint16_t)(b[0] | b[1] << 8);
+    }
+    fclose(f);
+    if (!g_raw) return false;
+
+    // round robin : 입력 cfg_channel만 (끝의 불완전한 한 바퀴는 버림)
+    g_stride = cfg_inputs;
+    g_buf = g_raw + cfg_channel;
+    g_buf_n = total / cfg_inputs;
+    return true;
+}
+
+static bool save_capture(const char *path) {
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    for (uint32_t i = 0; i < g_buf_n; i++) {
+        uint8_t b[2] = { (uint8_t)g_buf[i], (uint8_t)(g_buf[i] >> 8) };
+        fwrite(b, 1, 2, f);
+    }
+    return fclose(f) == 0;
+}
+
+// 스트로크 = idle 이상 첫 샘플부터, idle 미만이 gap ms 이어지면 그 첫 샘플에서 끝
+static void segment(void) {
+    uint32_t gap_n = ms_to_index(cfg_gap_ms);
+    uint32_t cap = 64;
+    g_strokes = calloc(cap, sizeof(stroke_t));
+    g_stroke_n = 0;
+    if (!g_strokes) {
+        perror("calloc");
+        exit(2);
+    }
+    bool in = false;
+    uint32_t low_from = 0, low_n = 0;
+    for (uint32_t i = 0; i < g_buf_n; i++) {
+        bool on = g_buf[(uint64_t)i * g_stride] >= cfg_idle;
+        if (!in) {
+            if (!on) continue;
+            if (g_stroke_n == cap) {
+                cap *= 2;
+                g_strokes = realloc(g_strokes, cap * sizeof(stroke_t));
+                if (!g_strokes) {
+                    perror("realloc");
+                    exit(2);
+                }
+            }
+            g_strokes[g_stroke_n] = (stroke_t){ .start = i, .end = g_buf_n, .stall = UINT32_MAX };
+            in = true;
+            low_n = 0;
+            continue;
+        }
+        if (on) {
+            low_n = 0;
+        } else if (low_n++ == 0) {
+            low_from = i;
+        }
+        if (low_n > gap_n) {
+            g_strokes[g_stroke_n++].end = low_from;
+            in = false;
+        }
+    }
+    if (in) g_stroke_n++;
+}
+
+static void run_capture(const char *path, FILE *f) {
+    csense_cfg_t cfg = make_cfg();
+    segment();
+    bool inv = check_invariant(&cfg);
+
+    fprintf(f, "{\"bench\": \"current\", \"capture\": \"%s\", \"rate_hz\": %u, \"inputs\": %u, \"channel\": %u, \"samples\": %u, \"strokes\": %u,\n",
+            path, cfg_rate_hz, cfg_inputs, cfg_channel, g_buf_n, g_stroke_n);
+    fprintf(f, " \"block_invariant\": %s, \"results\": [", inv ? "true" : "false");
+    for (uint32_t i = 0; i < g_stroke_n; i++) {
+        const stroke_t *st = &g_strokes[i];
+        const stroke_out_t *o = &g_whole[i];
+        fprintf(f, "%s\n    {\"start\": %u, \"t_us\": %.1f, \"len_us\": %.1f, \"peak\": %u, \"run_peak\": %u, ", i ? "," : "",
+                st->start, samples_to_us(st->start), samples_to_us(st->end - st->start), o->peak, o->run_peak);
+        if (!o->hit) {
+            fprintf(f, "\"event\": null}");
+        } else {
+            fprintf(f, "\"event\": {\"kind\": \"%s\", \"idx\": %llu, \"from_start_us\": %.1f, \"onset_us\": %.1f, \"level\": %u, \"base\": %u}}",
+                    kind_name(o->ev.kind), (unsigned long long)o->ev.idx, samples_to_us(o->ev.idx - st->start),
+                    samples_to_us(o->ev.over_idx - st->start), o->ev.level, o->ev.base);
+        }
+    }
+    fprintf(f, "\n]}\n");
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-z rate_hz] [-n strokes] [-e noise] [-s seed] [-p pattern] [-o out.json]\n", prog);
+    fprintf(stderr, "       %s -r capture.bin [-z rate_hz] [-i inputs] [-c channel] [-a idle] [-g gap_ms] [-o out.json]\n", prog);
+    fprintf(stderr, "       %s -p pattern -w capture.bin [-z rate_hz] [-n strokes] [-e noise]\n", prog);
+    fprintf(stderr, "  -z : per-input sample rate (capture: rate of the selected input)\n");
+    fprintf(stderr, "  -t blank_ms,stall_level,rise,confirm_n,avg_shift (default 20,3200,800,5,5)\n");
+    fprintf(stderr, "  patterns:");
+    for (int i = 0; i < PATTERN_COUNT; i++) fprintf(stderr, " %s", g_patterns[i].name);
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char **argv) {
+    const char *out_path = NULL;
+    const char *read_path = NULL;
+    const char *write_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-z") && i + 1 < argc) {
+            cfg_rate_hz = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            cfg_strokes = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-e") && i + 1 < argc) {
+            cfg_noise = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-s") && i + 1 < argc) {
+            cfg_seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
+            cfg_only = argv[++i];
+        } else if (!strcmp(argv[i], "-i") && i + 1 < argc) {
+            cfg_inputs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-c") && i + 1 < argc) {
+            cfg_channel = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-a") && i + 1 < argc) {
+            cfg_idle = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-g") && i + 1 < argc) {
+            cfg_gap_ms = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            if (sscanf(argv[++i], "%u,%u,%u,%u,%u", &cfg_blank_ms, &cfg_stall_level, &cfg_rise,
+                       &cfg_confirm_n, &cfg_avg_shift) != 5) {
+                usage(argv[0]);
+                return 2;
+            }
+        } else if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+            read_path = argv[++i];
+        } else if (!strcmp(argv[i], "-w") && i + 1 < argc) {
+            write_path = argv[++i];
+        } else if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+            out_path = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (cfg_rate_hz == 0 || cfg_confirm_n == 0 || cfg_avg_shift > 16 || cfg_inputs == 0 || cfg_channel >= cfg_inputs) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (write_path) {
+        for (int i = 0; i < PATTERN_COUNT; i++) {
+            if (cfg_only && !strcmp(cfg_only, g_patterns[i].name)) {
+                build(&g_patterns[i]);
+                return save_capture(write_path) ? 0 : 1;
+            }
+        }
+        usage(argv[0]);
+        return 2;
+    }
+
+    FILE *out = out_path ? fopen(out_path, "w") : stdout;
+    if (!out) {
+        perror(out_path);
+        return 2;
+    }
+
+    int fail = 0;
+    if (read_path) {
+        if (!load_capture(read_path)) return 2;
+        run_capture(read_path, out);
+        fail = !same_out(g_whole, g_rand) || !same_out(g_whole, g_single);
+    } else {
+        fprintf(out, "{\"bench\": \"current\", \"rate_hz\": %u, \"noise\": %u, \"results\": [\n", cfg_rate_hz, cfg_noise);
+        int emitted = 0;
+        for (int i = 0; i < PATTERN_COUNT; i++) {
+            if (cfg_only && strcmp(cfg_only, g_patterns[i].name)) continue;
+            if (emitted++) fprintf(out, ",\n");
+            run_pattern(&g_patterns[i], out);
+            if (!same_out(g_whole, g_rand) || !same_out(g_whole, g_single)) {
+                fprintf(stderr, "pattern %s: block split changed the result\n", g_patterns[i].name);
+                fail = 1;
+            }
+        }
+        fprintf(out, "\n]}\n");
+        if (emitted == 0) {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (out != stdout) fclose(out);
+    free(g_raw);
+    free(g_strokes);
+    free(g_whole);
+    free(g_rand);
+    free(g_single);
+    return fail;
+}
@@ -0,0 +1,300 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/*
+탄 감지 펌웨어 벤치마크 (host)
+- sub_pico_mnq_1.c / sub_pico_mnq_2.c 를 그대로 include (DETECT_FW_SRC, CMake에서 지정)
+- 패턴마다 P1(DETECT_1)/P2(DETECT_2) 파형을 일정 주기로 N회 넣고 HIT_1/HIT_2 출력을 판정
+- 측정: 정답/오분류/누락/오검출 수, P1 상승 → HIT 상승 지연, 결과는 JSON
+- 패턴마다 fork 해서 새로 부팅
+*/
+
+#ifndef DETECT_FW_SRC
+#define DETECT_FW_SRC           "../pico_mnq/sub_pico_mnq_2.c"
+#endif
+#ifndef DETECT_FW_NAME
+#define DETECT_FW_NAME          "sub_pico_mnq_2.c"
+#endif
+
+#define main detect_firmware_main
+#include DETECT_FW_SRC
+#undef main
+
+// 부팅(StartSignal 4s) 후 첫 샷 시각
+#define BENCH_START_US          5000000u
+
+// plant/측정 주기 (지연 측정 해상도)
+#define BENCH_STEP_US           50u
+
+// 이벤트 1개당 엣지 수 상한 (P1, P2, 두 번째 P1 펄스 × 상승/하강)
+#define BENCH_EDGES_PER_SHOT    6u
+
+// 기대 출력
+#define EXPECT_NONE             0
+#define EXPECT_HEAD             1       // HIT_1
+#define EXPECT_BODY             2       // HIT_2
+
+// ------------ 패턴 ------------
+// 한 이벤트 = period_ms 구간, 그 안에 P1/P2 펄스 (이벤트 시작 기준 ms)
+typedef struct {
+    const char *name;
+    const char *desc;
+    uint32_t period_ms;
+    int expect;
+    uint32_t p1_at_ms, p1_width_ms;     // P1 펄스
+    uint32_t p2_at_ms, p2_width_ms;     // P2 펄스 (폭 0이면 없음)
+    uint32_t p1b_at_ms, p1b_width_ms;   // 두 번째 P1 (폭 0이면 없음, 락아웃 확인용)
+} bench_pattern_t;
+
+// head_rapid 주기 : 락아웃은 첫 P2 샘플(P1 하강 뒤)부터 HIT_LOCKOUT_MS(50) → 다음 샷은 약 62 ms 뒤부터 인정
+//                  그보다 짧으면 한 발 건너 락아웃으로 누락 (double_tap이 락아웃 확인)
+static const bench_pattern_t g_patterns[] = {
+    { "head",       "P1 10 ms with P2 held high",           100, EXPECT_HEAD, 0, 10, 0, 16, 0, 0 },
+    { "body",       "P1 10 ms, P2 low",                     100, EXPECT_BODY, 0, 10, 0, 0,  0, 0 },
+    { "glitch",     "P1 2 ms noise (must be rejected)",     100, EXPECT_NONE, 0, 2,  0, 0,  0, 0 },
+    { "double_tap", "two body pulses 20 ms apart (lockout)", 150, EXPECT_BODY, 0, 10, 0, 0, 20, 10 },
+    { "head_rapid", "head shot every 80 ms",                 80, EXPECT_HEAD, 0, 10, 0, 16, 0, 0 },
+};
+
+#define PATTERN_COUNT   (int)(sizeof(g_patterns) / sizeof(g_patterns[0]))
+
+// ------------ 설정 ------------
+static uint32_t cfg_shots = 200;
+static const char *cfg_only = NULL;
+
+// ------------ 입력 스크립트 ------------
+typedef struct {
+    uint64_t t_us;
+    uint     pin;
+    bool     level;
+} bench_edge_t;
+
+static const bench_pattern_t *g_pat;
+static bench_edge_t *g_edges = NULL;   // cfg_shots * BENCH_EDGES_PER_SHOT (main에서 할당)
+static int g_edge_n = 0;
+static int g_edge_i = 0;
+
+// ------------ 판정 ------------
+typedef struct {
+    uint32_t n;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+} bench_acc_t;
+
+static bool     st_prev_hit1 = false;
+static bool     st_prev_hit2 = false;
+static int      st_event_out = -1;      // 현재 이벤트에서 처음 나온 출력 (-1 = 없음)
+static uint32_t st_event_extra = 0;     // 현재 이벤트에서 추가로 나온 출력 수
+static int      st_event = -1;          // 현재 이벤트 번호
+
+static uint32_t st_correct = 0;
+static uint32_t st_wrong = 0;
+static uint32_t st_missed = 0;
+static uint32_t st_false = 0;
+static bench_acc_t st_latency;
+
+static void acc_add(bench_acc_t *a, uint64_t v) {
+    if (a->n == 0 || v < a->min) a->min = v;
+    if (a->n == 0 || v > a->max) a->max = v;
+    a->n++;
+    a->sum += v;
+}
+
+static void add_pulse(uint pin, uint64_t t_us, uint32_t width_ms) {
+    if (width_ms == 0) return;
+    g_edges[g_edge_n++] = (bench_edge_t){ t_us, pin, true };
+    g_edges[g_edge_n++] = (bench_edge_t){ t_us + (uint64_t)width_ms * 1000u, pin, false };
+}
+
+static int edge_cmp(const void *a, const void *b) {
+    const bench_edge_t *x = a;
+    const bench_edge_t *y = b;
+    if (x->t_us != y->t_us) return x->t_us < y->t_us ? -1 : 1;
+    // 같은 시각이면 P2를 먼저 (P1보다 먼저 올라가 있도록)
+    return (int)y->pin - (int)x->pin;
+}
+
+static void script_build(const bench_pattern_t *p) {
+    g_edge_n = 0;
+    g_edge_i = 0;
+    for (uint32_t i = 0; i < cfg_shots; i++) {
+        uint64_t t0 = BENCH_START_US + (uint64_t)i * p->period_ms * 1000u;
+        add_pulse(DETECT_1, t0 + (uint64_t)p->p1_at_ms * 1000u, p->p1_width_ms);
+        add_pulse(DETECT_2, t0 + (uint64_t)p->p2_at_ms * 1000u, p->p2_width_ms);
+        add_pulse(DETECT_1, t0 + (uint64_t)p->p1b_at_ms * 1000u, p->p1b_width_ms);
+    }
+    qsort(g_edges, (size_t)g_edge_n, sizeof(g_edges[0]), edge_cmp);
+}
+
+// 끝난 이벤트 판정
+static void event_close(void) {
+    if (st_event < 0) return;
+
+    int expect = g_pat->expect;
+    if (st_event_out < 0) {
+        if (expect != EXPECT_NONE) st_missed++;
+        else                       st_correct++;
+    } else if (expect == EXPECT_NONE) {
+        st_false++;
+    } else if (st_event_out == expect) {
+        st_correct++;
+    } else {
+        st_wrong++;
+    }
+    st_false += st_event_extra;
+
+    st_event_out = -1;
+    st_event_extra = 0;
+}
+
+static void on_hit(int out, uint64_t now) {
+    if (st_event < 0) {
+        st_false++;
+        return;
+    }
+    if (st_event_out >= 0) {
+        st_event_extra++;
+        return;
+    }
+    st_event_out = out;
+
+    uint64_t t0 = BENCH_START_US + (uint64_t)st_event * g_pat->period_ms * 1000u;
+    acc_add(&st_latency, now - (t0 + (uint64_t)g_pat->p1_at_ms * 1000u));
+}
+
+static uint64_t bench_step(uint64_t now) {
+    // 이벤트 경계
+    if (now >= BENCH_START_US) {
+        int ev = (int)((now - BENCH_START_US) / ((uint64_t)g_pat->period_ms * 1000u));
+        if (ev != st_event) {
+            event_close();
+            st_event = ev;
+            if ((uint32_t)ev >= cfg_shots) {
+                st_event = -1;
+                sim_stop();
+            }
+        }
+    }
+
+    while (g_edge_i < g_edge_n && g_edges[g_edge_i].t_us <= now) {
+        sim_gpio_drive(g_edges[g_edge_i].pin, g_edges[g_edge_i].level);
+        g_edge_i++;
+    }
+
+    // HIT 상승엣지
+    bool hit1 = sim_gpio_out(HIT_1);
+    bool hit2 = sim_gpio_out(HIT_2);
+    if (hit1 && !st_prev_hit1) on_hit(EXPECT_HEAD, now);
+    if (hit2 && !st_prev_hit2) on_hit(EXPECT_BODY, now);
+    st_prev_hit1 = hit1;
+    st_prev_hit2 = hit2;
+
+    uint64_t next = now + BENCH_STEP_US;
+    if (g_edge_i < g_edge_n && g_edges[g_edge_i].t_us < next) next = g_edges[g_edge_i].t_us;
+    return next;
+}
+
+// ------------ JSON ------------
+static void json_result(FILE *f) {
+    uint32_t shots = st_correct + st_wrong + st_missed;
+    if (g_pat->expect == EXPECT_NONE) shots = cfg_shots;
+
+    fprintf(f, "    {\"pattern\": \"%s\", \"desc\": \"%s\", \"shots\": %u, \"correct\": %u, \"wrong\": %u, \"missed\": %u, \"false\": %u,\n",
+            g_pat->name, g_pat->desc, shots, st_correct, st_wrong, st_missed, st_false);
+    if (st_latency.n == 0) {
+        fprintf(f, "     \"latency_us\": null}");
+    } else {
+        fprintf(f, "     \"latency_us\": {\"n\": %u, \"avg\": %.3f, \"min\": %.3f, \"max\": %.3f}}",
+                st_latency.n, (double)st_latency.sum / st_latency.n,
+                (double)st_latency.min, (double)st_latency.max);
+    }
+}
+
+static int run_pattern(const bench_pattern_t *p, FILE *out) {
+    g_pat = p;
+    script_build(p);
+    sim_reset();
+    sim_set_plant(bench_step);
+    sim_run(detect_firmware_main);
+
+    json_result(out);
+    fflush(out);
+    return 0;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-n shots] [-p pattern] [-o out.json]\n", prog);
+    fprintf(stderr, "  patterns:");
+    for (int i = 0; i < PATTERN_COUNT; i++) fprintf(stderr, " %s", g_patterns[i].name);
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char **argv) {
+    const char *out_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            cfg_shots = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
+            cfg_only = argv[++i];
+        } else if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+            out_path = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (cfg_shots == 0 || cfg_shots > (uint32_t)(INT32_MAX / BENCH_EDGES_PER_SHOT)) {
+        usage(argv[0]);
+        return 2;
+    }
+    g_edges = calloc((size_t)cfg_shots * BENCH_EDGES_PER_SHOT, sizeof(bench_edge_t));
+    if (!g_edges) {
+        perror("calloc");
+        return 2;
+    }
+
+    FILE *out = out_path ? fopen(out_path, "w") : stdout;
+    if (!out) {
+        perror(out_path);
+        return 2;
+    }
+
+    fprintf(out, "{\"bench\": \"detect\", \"firmware\": \"%s\", \"results\": [\n", DETECT_FW_NAME);
+    fflush(out);
+
+    int fail = 0;
+    int emitted = 0;
+    for (int i = 0; i < PATTERN_COUNT; i++) {
+        if (cfg_only && strcmp(cfg_only, g_patterns[i].name)) continue;
+
+        if (emitted++) fprintf(out, ",\n");
+        fflush(out);
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            return 2;
+        }
+        if (pid == 0) _exit(run_pattern(&g_patterns[i], out));
+
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fprintf(stderr, "pattern %s failed\n", g_patterns[i].name);
+            fail = 1;
+        }
+    }
+    fprintf(out, "\n]}\n");
+    if (out != stdout) fclose(out);
+
+    if (emitted == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    return fail;
+}
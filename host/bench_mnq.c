@@ -0,0 +1,266 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/*
+sub_pcb_mnq.c 사이클 벤치마크 (host)
+- 탄 입력 패턴(READY_UP 진입 기준 스크립트)마다 N 사이클 실행, 결과를 JSON으로 출력
+- 측정: 탄(트리거 엣지) → 하강 시작(DIR=down) 지연, phase별 시간, 사이클 시간, 분당 교전 수
+- 펌웨어 static 상태가 패턴끼리 섞이지 않도록 패턴마다 fork 해서 새로 부팅
+- 학습(풀파워 자동 조정)이 수렴하도록 앞 warmup 사이클은 집계에서 제외
+*/
+
+#define main mnq_firmware_main
+#include "../pico_mnq/sub_pcb_mnq.c"
+#undef main
+
+#include "mnq_plant.h"
+
+// plant/측정 주기 (지연 측정 해상도)
+#define BENCH_STEP_US           100u
+
+// 스크립트가 끝난 뒤 이 시간 안에 하강이 없으면 miss로 보고 다시 쏨
+#define BENCH_MISS_TIMEOUT_US   2000000u
+
+#define BENCH_MAX_SHOTS         4
+
+// ------------ 패턴 ------------
+typedef struct {
+    uint32_t t_ms;          // READY_UP 진입 후
+    uint     pin;
+    uint32_t width_ms;
+} bench_shot_t;
+
+typedef struct {
+    const char *name;
+    const char *desc;
+    int n;
+    bench_shot_t shots[BENCH_MAX_SHOTS];
+} bench_pattern_t;
+
+static const bench_pattern_t g_patterns[] = {
+    { "head",        "head shot 100 ms after ready",            1, { { 100, DETECT_2, 10 } } },
+    { "body_double", "two body shots 40 ms apart",              2, { { 100, DETECT_1, 10 }, { 140, DETECT_1, 10 } } },
+    { "body_split",  "body shot on DETECT_1 then DETECT_3 0.5 s later", 2, { { 100, DETECT_1, 10 }, { 600, DETECT_3, 10 } } },
+    { "head_rapid",  "head shot 1 ms after ready (max engagement rate)", 1, { { 1, DETECT_2, 10 } } },
+};
+
+#define PATTERN_COUNT   (int)(sizeof(g_patterns) / sizeof(g_patterns[0]))
+
+// ------------ 설정 ------------
+static uint32_t cfg_cycles = 50;
+static uint32_t cfg_warmup = 30;
+static const char *cfg_only = NULL;
+
+// ------------ 실행 상태 ------------
+static const bench_pattern_t *g_pat;
+
+static uint64_t sc_ready_us = 0;        // 마지막 READY_UP 진입
+static bool     sc_ready_seen = false;
+static uint64_t sc_edge_us[BENCH_MAX_SHOTS * 2];
+static uint     sc_edge_pin[BENCH_MAX_SHOTS * 2];
+static bool     sc_edge_level[BENCH_MAX_SHOTS * 2];
+static int      sc_edge_n = 0;
+static int      sc_edge_i = 0;
+static uint64_t sc_last_rise_us = 0;    // 마지막으로 넣은 상승엣지
+static bool     sc_wait_descent = false;
+
+static mnq_phase_t sc_prev_phase = PHASE_READY_UP;
+static uint64_t sc_phase_start_us = 0;
+static bool     sc_descended = false;
+
+// ------------ 집계 ------------
+typedef struct {
+    uint32_t n;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+} bench_acc_t;
+
+#define PH_COUNT    5
+
+static const char *const g_phase_names[PH_COUNT] = { "ready", "down", "hold_down", "up", "hold_up" };
+
+static uint32_t    st_cycles = 0;       // warmup 포함 완료 사이클
+static uint32_t    st_missed = 0;
+static bench_acc_t st_latency;
+static bench_acc_t st_cycle;
+static bench_acc_t st_phase[PH_COUNT];
+
+static void acc_add(bench_acc_t *a, uint64_t v) {
+    if (a->n == 0 || v < a->min) a->min = v;
+    if (a->n == 0 || v > a->max) a->max = v;
+    a->n++;
+    a->sum += v;
+}
+
+static bool measuring(void) {
+    return st_cycles >= cfg_warmup;
+}
+
+static void script_schedule(uint64_t ready_us) {
+    sc_edge_n = 0;
+    sc_edge_i = 0;
+    for (int i = 0; i < g_pat->n; i++) {
+        const bench_shot_t *s = &g_pat->shots[i];
+        uint64_t t = ready_us + (uint64_t)s->t_ms * 1000u;
+        sc_edge_pin[sc_edge_n] = s->pin; sc_edge_level[sc_edge_n] = 1; sc_edge_us[sc_edge_n++] = t;
+        sc_edge_pin[sc_edge_n] = s->pin; sc_edge_level[sc_edge_n] = 0; sc_edge_us[sc_edge_n++] = t + (uint64_t)s->width_ms * 1000u;
+    }
+    sc_wait_descent = true;
+    sc_descended = false;
+}
+
+static uint64_t bench_step(uint64_t now) {
+    plant_motion(now);
+
+    // phase 전환 시간
+    if (g_mnq[0].phase != sc_prev_phase) {
+        if (measuring() && sc_ready_seen) acc_add(&st_phase[sc_prev_phase], now - sc_phase_start_us);
+        sc_phase_start_us = now;
+
+        if (g_mnq[0].phase == PHASE_READY_UP) {
+            // READY_UP 진입 = 사이클 1회 완료
+            if (sc_ready_seen) {
+                if (measuring()) acc_add(&st_cycle, now - sc_ready_us);
+                st_cycles++;
+                if (st_cycles >= cfg_warmup + cfg_cycles) sim_stop();
+            }
+            sc_ready_seen = true;
+            sc_ready_us = now;
+            script_schedule(now);
+        }
+        sc_prev_phase = g_mnq[0].phase;
+    }
+
+    // 하강 시작 = 모터가 내려가기 명령을 받은 시점 (DIR=down, READY_UP 동안은 up)
+    if (sc_wait_descent && !sc_descended && sim_gpio_out(g_mnq_pins[0].dir)) {
+        sc_descended = true;
+        sc_wait_descent = false;
+        if (measuring() && sc_ready_seen) acc_add(&st_latency, now - sc_last_rise_us);
+    }
+
+    // 스크립트 다 넣었는데 하강 없음 → miss, 다시 쏨 (부팅 직후 IRQ 설정 전 포함)
+    if (g_mnq[0].phase == PHASE_READY_UP && sc_edge_i >= sc_edge_n &&
+        (sc_edge_n == 0 || now - sc_edge_us[sc_edge_n - 1] >= BENCH_MISS_TIMEOUT_US)) {
+        if (sc_ready_seen && st_cycles > 0) st_missed++;
+        script_schedule(now);
+    }
+
+    while (sc_edge_i < sc_edge_n && sc_edge_us[sc_edge_i] <= now) {
+        sim_gpio_drive(sc_edge_pin[sc_edge_i], sc_edge_level[sc_edge_i]);
+        if (sc_edge_level[sc_edge_i]) sc_last_rise_us = sc_edge_us[sc_edge_i];
+        sc_edge_i++;
+    }
+
+    uint64_t next = now + BENCH_STEP_US;
+    if (sc_edge_i < sc_edge_n && sc_edge_us[sc_edge_i] < next) next = sc_edge_us[sc_edge_i];
+    return next;
+}
+
+// ------------ JSON ------------
+static void json_acc(FILE *f, const char *key, const bench_acc_t *a, double scale) {
+    if (a->n == 0) {
+        fprintf(f, "\"%s\": null", key);
+        return;
+    }
+    fprintf(f, "\"%s\": {\"n\": %u, \"avg\": %.3f, \"min\": %.3f, \"max\": %.3f}",
+            key, a->n, (double)a->sum / a->n * scale, (double)a->min * scale, (double)a->max * scale);
+}
+
+static void json_result(FILE *f) {
+    fprintf(f, "    {\"pattern\": \"%s\", \"desc\": \"%s\", \"cycles\": %u, \"missed\": %u,\n",
+            g_pat->name, g_pat->desc, st_cycle.n, st_missed);
+    fprintf(f, "     ");
+    json_acc(f, "shot_to_descent_us", &st_latency, 1.0);
+    fprintf(f, ",\n     ");
+    json_acc(f, "cycle_ms", &st_cycle, 1e-3);
+    fprintf(f, ",\n     \"phase_ms\": {");
+    for (int i = 0; i < PH_COUNT; i++) {
+        fprintf(f, "%s\"%s\": %.3f", i ? ", " : "", g_phase_names[i],
+                st_phase[i].n ? (double)st_phase[i].sum / st_phase[i].n / 1000.0 : 0.0);
+    }
+    fprintf(f, "},\n     \"engagements_per_min\": %.3f}",
+            st_cycle.n ? 60000.0 / ((double)st_cycle.sum / st_cycle.n / 1000.0) : 0.0);
+}
+
+// 패턴 1개 실행 (fork된 자식에서)
+static int run_pattern(const bench_pattern_t *p, FILE *out) {
+    g_pat = p;
+    sim_reset();
+    plant_init();
+    sim_set_plant(bench_step);
+    sim_run(mnq_firmware_main);
+
+    json_result(out);
+    fflush(out);
+    return st_cycles >= cfg_warmup + cfg_cycles ? 0 : 1;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-n cycles] [-w warmup] [-p pattern] [-o out.json]\n", prog);
+    fprintf(stderr, "  patterns:");
+    for (int i = 0; i < PATTERN_COUNT; i++) fprintf(stderr, " %s", g_patterns[i].name);
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char **argv) {
+    const char *out_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            cfg_cycles = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-w") && i + 1 < argc) {
+            cfg_warmup = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
+            cfg_only = argv[++i];
+        } else if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+            out_path = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    FILE *out = out_path ? fopen(out_path, "w") : stdout;
+    if (!out) {
+        perror(out_path);
+        return 2;
+    }
+
+    fprintf(out, "{\"bench\": \"mnq_cycle\", \"firmware\": \"sub_pcb_mnq.c\", \"warmup\": %u, \"results\": [\n", cfg_warmup);
+    fflush(out);
+
+    int fail = 0;
+    int emitted = 0;
+    for (int i = 0; i < PATTERN_COUNT; i++) {
+        if (cfg_only && strcmp(cfg_only, g_patterns[i].name)) continue;
+
+        if (emitted++) fprintf(out, ",\n");
+        fflush(out);
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            return 2;
+        }
+        if (pid == 0) _exit(run_pattern(&g_patterns[i], out));
+
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fprintf(stderr, "pattern %s failed\n", g_patterns[i].name);
+            fail = 1;
+        }
+    }
+    fprintf(out, "\n]}\n");
+    if (out != stdout) fclose(out);
+
+    if (emitted == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    return fail;
+}
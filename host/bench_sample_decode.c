@@ -0,0 +1,421 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sample_decode.h"
+
+/*
+P1/P2 block decoder 벤치마크 (host, pico_mnq/sample_decode.h만 사용 : 펌웨어/shim 없음)
+- 합성 : bench_detect.c와 같은 패턴을 샘플 rate의 GPIO word 배열로 만들어 판정 (-c : 엣지마다 chatter 샘플)
+         정답/오분류/누락/오검출, 판정 시각(P1 상승 → 판정 샘플), 락아웃으로 버린 P1 상승 수
+- 캡처 : -r 파일 = little-endian uint32 gpio_in 샘플 연속 (DMA ring을 순서대로 덤프한 것 등), 판정 결과 목록
+         -w 파일 : 합성 버퍼를 같은 형식으로 저장 (-p 패턴 1개)
+- 같은 버퍼를 통째로 / 무작위 길이 block / 1 샘플씩 넣어 결과가 같은지 확인 (block_invariant)
+- 디코더 처리 속도 (host ns/sample, 참고용)
+- 결과는 JSON
+*/
+
+// detect_engine.h 보드 핀 (DETECT_1 = P1, DETECT_2 = P2)
+#define P1_PIN                  3
+#define P2_PIN                  4
+
+// 첫 샷 전 빈 구간
+#define BENCH_LEAD_MS           5u
+
+#define BENCH_MAX_HITS          8192u
+
+// 속도 측정 반복 (통째로 판정)
+#define BENCH_SPEED_RUNS        20
+
+// ------------ 패턴 (bench_detect.c와 같음) ------------
+#define EXPECT_NONE             0
+#define EXPECT_HEAD             1
+#define EXPECT_BODY             2
+
+typedef struct {
+    const char *name;
+    const char *desc;
+    uint32_t period_ms;
+    int expect;
+    uint32_t p1_at_ms, p1_width_ms;
+    uint32_t p2_at_ms, p2_width_ms;
+    uint32_t p1b_at_ms, p1b_width_ms;
+} bench_pattern_t;
+
+// head_rapid 주기 : 락아웃은 첫 P2 샘플(P1 하강 뒤)부터 HIT_LOCKOUT_MS(50) → 다음 샷은 약 62 ms 뒤부터 인정
+//                  그보다 짧으면 한 발 건너 락아웃으로 누락 (double_tap이 락아웃 확인)
+static const bench_pattern_t g_patterns[] = {
+    { "head",       "P1 10 ms with P2 held high",           100, EXPECT_HEAD, 0, 10, 0, 16, 0, 0 },
+    { "body",       "P1 10 ms, P2 low",                     100, EXPECT_BODY, 0, 10, 0, 0,  0, 0 },
+    { "glitch",     "P1 2 ms noise (must be rejected)",     100, EXPECT_NONE, 0, 2,  0, 0,  0, 0 },
+    { "double_tap", "two body pulses 20 ms apart (lockout)", 150, EXPECT_BODY, 0, 10, 0, 0, 20, 10 },
+    { "head_rapid", "head shot every 80 ms",                 80, EXPECT_HEAD, 0, 10, 0, 16, 0, 0 },
+};
+
+#define PATTERN_COUNT   (int)(sizeof(g_patterns) / sizeof(g_patterns[0]))
+
+// ------------ 설정 ------------
+static uint32_t cfg_rate_hz = 20000;
+static uint32_t cfg_shots = 200;
+static uint32_t cfg_chatter = 0;        // 엣지마다 무작위 샘플 수
+static uint32_t cfg_seed = 1;
+static const char *cfg_only = NULL;
+
+// 판정 파라미터 (detect_engine.h 기본값, us)
+static uint32_t cfg_confirm_n = 5;
+static uint32_t cfg_confirm_us = 1000;
+static uint32_t cfg_p2_n = 2;
+static uint32_t cfg_p2_us = 1000;
+static uint32_t cfg_delay_us = 1000;
+static uint32_t cfg_lockout_ms = 50;
+
+static uint32_t us_to_samples(uint32_t us) {
+    return (uint32_t)(((uint64_t)us * cfg_rate_hz + 500000u) / 1000000u);
+}
+
+static uint32_t us_to_step(uint32_t us) {
+    uint32_t n = us_to_samples(us);
+    return n ? n : 1u;
+}
+
+static double samples_to_us(uint64_t n) {
+    return (double)n * 1e6 / cfg_rate_hz;
+}
+
+static sdec_cfg_t make_cfg(bool edge) {
+    return (sdec_cfg_t){
+        .p1_mask = 1u << P1_PIN,
+        .p2_mask = 1u << P2_PIN,
+        .edge = edge,
+        .confirm_n = cfg_confirm_n,
+        .confirm_step = us_to_step(cfg_confirm_us),
+        .p2_n = cfg_p2_n,
+        .p2_step = us_to_step(cfg_p2_us),
+        .delay = us_to_samples(cfg_delay_us),
+        .lockout = us_to_samples(cfg_lockout_ms * 1000u),
+    };
+}
+
+// ------------ 판정 실행 ------------
+typedef struct {
+    sdec_hit_t hit[BENCH_MAX_HITS];
+    uint32_t n;
+    uint32_t lockout_rises;
+} decode_out_t;
+
+// block : 0 = 통째로, 1 = 1 샘플씩, 그 외 = 무작위 길이 (1 ~ block), batch = sdec_feed 결과 버퍼 크기
+static void decode(const sdec_cfg_t *cfg, const uint32_t *s, uint32_t n, uint32_t block, uint32_t batch, decode_out_t *o) {
+    sdec_t d;
+    sdec_hit_t tmp[BENCH_MAX_HITS];
+    uint32_t rng = 12345u;
+
+    sdec_init(&d, cfg, 0);
+    o->n = 0;
+    uint32_t at = 0;
+    while (at < n) {
+        uint32_t len = n - at;
+        if (block == 1) {
+            len = 1;
+        } else if (block > 1) {
+            rng = rng * 1103515245u + 12345u;
+            uint32_t r = 1u + (rng >> 8) % block;
+            if (r < len) len = r;
+        }
+        // 결과 버퍼가 차면 나머지를 다시 넣음
+        while (len > 0) {
+            uint64_t from = d.pos;
+            uint32_t k = sdec_feed(&d, &s[at], len, tmp, batch);
+            uint32_t used = (uint32_t)(d.pos - from);
+            for (uint32_t i = 0; i < k && o->n < BENCH_MAX_HITS; i++) o->hit[o->n++] = tmp[i];
+            at += used;
+            len -= used;
+        }
+    }
+    o->lockout_rises = d.lockout_rises;
+}
+
+static bool same_hits(const decode_out_t *a, const decode_out_t *b) {
+    if (a->n != b->n || a->lockout_rises != b->lockout_rises) return false;
+    for (uint32_t i = 0; i < a->n; i++) {
+        if (a->hit[i].edge_idx != b->hit[i].edge_idx || a->hit[i].idx != b->hit[i].idx || a->hit[i].head != b->hit[i].head) return false;
+    }
+    return true;
+}
+
+static decode_out_t g_whole, g_rand, g_single;
+
+// 통째 / 무작위 block (결과 버퍼 1개) / 1 샘플씩 비교
+static bool check_invariant(const sdec_cfg_t *cfg, const uint32_t *s, uint32_t n) {
+    decode(cfg, s, n, 0, BENCH_MAX_HITS, &g_whole);
+    decode(cfg, s, n, 257, 1, &g_rand);
+    decode(cfg, s, n, 1, 4, &g_single);
+    return same_hits(&g_whole, &g_rand) && same_hits(&g_whole, &g_single);
+}
+
+static double speed_ns_per_sample(const sdec_cfg_t *cfg, const uint32_t *s, uint32_t n) {
+    static decode_out_t o;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int r = 0; r < BENCH_SPEED_RUNS; r++) decode(cfg, s, n, 0, BENCH_MAX_HITS, &o);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double ns = (double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec);
+    return n ? ns / ((double)n * BENCH_SPEED_RUNS) : 0.0;
+}
+
+// ------------ 합성 버퍼 ------------
+static uint32_t *g_buf = NULL;
+static uint32_t g_buf_n = 0;
+static uint32_t g_rng = 1;
+
+static uint32_t rnd(void) {
+    g_rng = g_rng * 1103515245u + 12345u;
+    return g_rng >> 16;
+}
+
+static uint32_t ms_to_index(uint64_t ms) {
+    return (uint32_t)(ms * cfg_rate_hz / 1000u);
+}
+
+// [a, b) ms 동안 pin HIGH, 엣지 뒤 cfg_chatter 샘플은 무작위
+static void add_pulse(uint32_t pin, uint64_t at_ms, uint32_t width_ms) {
+    if (width_ms == 0) return;
+    uint32_t a = ms_to_index(at_ms);
+    uint32_t b = ms_to_index(at_ms + width_ms);
+    uint32_t bit = 1u << pin;
+    for (uint32_t i = a; i < b && i < g_buf_n; i++) g_buf[i] |= bit;
+    for (uint32_t k = 0; k < cfg_chatter; k++) {
+        if (a + k < g_buf_n) g_buf[a + k] = (g_buf[a + k] & ~bit) | ((rnd() & 1u) ? bit : 0u);
+        if (b + k < g_buf_n) g_buf[b + k] = (g_buf[b + k] & ~bit) | ((rnd() & 1u) ? bit : 0u);
+    }
+}
+
+static void build(const bench_pattern_t *p) {
+    g_buf_n = ms_to_index(BENCH_LEAD_MS + (uint64_t)cfg_shots * p->period_ms);
+    free(g_buf);
+    g_buf = calloc(g_buf_n ? g_buf_n : 1u, sizeof(uint32_t));
+    if (!g_buf) {
+        perror("calloc");
+        exit(2);
+    }
+    g_rng = cfg_seed;
+    for (uint32_t i = 0; i < cfg_shots; i++) {
+        uint64_t t0 = BENCH_LEAD_MS + (uint64_t)i * p->period_ms;
+        // P2를 먼저 (같은 시각이면 P1보다 먼저 올라가 있도록, bench_detect.c와 같음)
+        add_pulse(P2_PIN, t0 + p->p2_at_ms, p->p2_width_ms);
+        add_pulse(P1_PIN, t0 + p->p1_at_ms, p->p1_width_ms);
+        add_pulse(P1_PIN, t0 + p->p1b_at_ms, p->p1b_width_ms);
+    }
+}
+
+// ------------ 채점 ------------
+typedef struct {
+    uint32_t correct, wrong, missed, false_hits;
+    uint32_t lat_n;
+    double lat_sum, lat_min, lat_max;
+} score_t;
+
+static void score(const bench_pattern_t *p, const decode_out_t *o, score_t *sc) {
+    memset(sc, 0, sizeof(*sc));
+    uint32_t period = ms_to_index(p->period_ms);
+    uint32_t lead = ms_to_index(BENCH_LEAD_MS);
+    uint32_t h = 0;
+
+    for (uint32_t ev = 0; ev < cfg_shots; ev++) {
+        uint64_t from = lead + (uint64_t)ev * period;
+        uint64_t to = from + period;
+        int out = -1;
+        while (h < o->n && o->hit[h].edge_idx < to) {
+            const sdec_hit_t *x = &o->hit[h++];
+            if (x->edge_idx < from) {
+                sc->false_hits++;
+            } else if (out >= 0) {
+                sc->false_hits++;
+            } else {
+                out = x->head ? EXPECT_HEAD : EXPECT_BODY;
+                double lat = samples_to_us(x->idx - (from + ms_to_index(p->p1_at_ms)));
+                if (sc->lat_n == 0 || lat < sc->lat_min) sc->lat_min = lat;
+                if (sc->lat_n == 0 || lat > sc->lat_max) sc->lat_max = lat;
+                sc->lat_sum += lat;
+                sc->lat_n++;
+            }
+        }
+        if (out < 0)                    { if (p->expect != EXPECT_NONE) sc->missed++; else sc->correct++; }
+        else if (p->expect == EXPECT_NONE) sc->false_hits++;
+        else if (out == p->expect)      sc->correct++;
+        else                            sc->wrong++;
+    }
+    sc->false_hits += o->n - h;
+}
+
+static void run_pattern(const bench_pattern_t *p, bool edge, FILE *f) {
+    sdec_cfg_t cfg = make_cfg(edge);
+    build(p);
+    bool inv = check_invariant(&cfg, g_buf, g_buf_n);
+    score_t sc;
+    score(p, &g_whole, &sc);
+    double ns = speed_ns_per_sample(&cfg, g_buf, g_buf_n);
+
+    fprintf(f, "    {\"pattern\": \"%s\", \"strategy\": \"%s\", \"desc\": \"%s\", \"samples\": %u, \"correct\": %u, \"wrong\": %u, \"missed\": %u, \"false\": %u,\n",
+            p->name, edge ? "edge" : "level", p->desc, g_buf_n, sc.correct, sc.wrong, sc.missed, sc.false_hits);
+    fprintf(f, "     \"lockout_rises\": %u, \"block_invariant\": %s, \"ns_per_sample\": %.2f,\n",
+            g_whole.lockout_rises, inv ? "true" : "false", ns);
+    if (sc.lat_n == 0) {
+        fprintf(f, "     \"decide_us\": null}");
+    } else {
+        fprintf(f, "     \"decide_us\": {\"n\": %u, \"avg\": %.3f, \"min\": %.3f, \"max\": %.3f}}",
+                sc.lat_n, sc.lat_sum / sc.lat_n, sc.lat_min, sc.lat_max);
+    }
+}
+
+// ------------ 캡처 ------------
+static bool load_capture(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    g_buf_n = size > 0 ? (uint32_t)(size / 4) : 0;
+    g_buf = calloc(g_buf_n ? g_buf_n : 1u, sizeof(uint32_t));
+    for (uint32_t i = 0; g_buf && i < g_buf_n; i++) {
+        uint8_t b[4];
+        if (fread(b, 1, 4, f) != 4) break;
+        g_buf[i] = (uint32_t)b[0] | (uint32_t)b[1] << 8 | (uint32_t)b[2] << 16 | (uint32_t)b[3] << 24;
+    }
+    fclose(f);
+    return g_buf != NULL;
+}
+
+static bool save_capture(const char *path) {
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    for (uint32_t i = 0; i < g_buf_n; i++) {
+        uint8_t b[4] = { (uint8_t)g_buf[i], (uint8_t)(g_buf[i] >> 8), (uint8_t)(g_buf[i] >> 16), (uint8_t)(g_buf[i] >> 24) };
+        fwrite(b, 1, 4, f);
+    }
+    return fclose(f) == 0;
+}
+
+static void run_capture(const char *path, bool edge, FILE *f) {
+    sdec_cfg_t cfg = make_cfg(edge);
+    bool inv = check_invariant(&cfg, g_buf, g_buf_n);
+
+    fprintf(f, "{\"bench\": \"sample_decode\", \"capture\": \"%s\", \"rate_hz\": %u, \"strategy\": \"%s\", \"samples\": %u,\n",
+            path, cfg_rate_hz, edge ? "edge" : "level", g_buf_n);
+    fprintf(f, " \"lockout_rises\": %u, \"block_invariant\": %s, \"hits\": [",
+            g_whole.lockout_rises, inv ? "true" : "false");
+    for (uint32_t i = 0; i < g_whole.n; i++) {
+        const sdec_hit_t *h = &g_whole.hit[i];
+        fprintf(f, "%s\n    {\"edge\": %llu, \"idx\": %llu, \"t_us\": %.1f, \"decide_us\": %.1f, \"shot\": \"%s\"}", i ? "," : "",
+                (unsigned long long)h->edge_idx, (unsigned long long)h->idx,
+                samples_to_us(h->edge_idx), samples_to_us(h->idx - h->edge_idx), h->head ? "head" : "body");
+    }
+    fprintf(f, "\n]}\n");
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-z rate_hz] [-n shots] [-c chatter] [-s seed] [-p pattern] [-l] [-o out.json]\n", prog);
+    fprintf(stderr, "       %s -r capture.bin [-z rate_hz] [-l] [-o out.json]\n", prog);
+    fprintf(stderr, "       %s -p pattern -w capture.bin [-z rate_hz] [-n shots] [-c chatter]\n", prog);
+    fprintf(stderr, "  -l : LEVEL strategy only (sub_pico_mnq_1), default both in synthetic mode / EDGE for captures\n");
+    fprintf(stderr, "  -t confirm_n,confirm_us,p2_n,p2_us,delay_us,lockout_ms (default 5,1000,2,1000,1000,50)\n");
+    fprintf(stderr, "  patterns:");
+    for (int i = 0; i < PATTERN_COUNT; i++) fprintf(stderr, " %s", g_patterns[i].name);
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char **argv) {
+    const char *out_path = NULL;
+    const char *read_path = NULL;
+    const char *write_path = NULL;
+    bool level_only = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-z") && i + 1 < argc) {
+            cfg_rate_hz = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            cfg_shots = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-c") && i + 1 < argc) {
+            cfg_chatter = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-s") && i + 1 < argc) {
+            cfg_seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
+            cfg_only = argv[++i];
+        } else if (!strcmp(argv[i], "-l")) {
+            level_only = true;
+        } else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            if (sscanf(argv[++i], "%u,%u,%u,%u,%u,%u", &cfg_confirm_n, &cfg_confirm_us, &cfg_p2_n,
+                       &cfg_p2_us, &cfg_delay_us, &cfg_lockout_ms) != 6) {
+                usage(argv[0]);
+                return 2;
+            }
+        } else if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+            read_path = argv[++i];
+        } else if (!strcmp(argv[i], "-w") && i + 1 < argc) {
+            write_path = argv[++i];
+        } else if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+            out_path = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (cfg_rate_hz == 0 || cfg_confirm_n == 0 || cfg_p2_n == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (write_path) {
+        for (int i = 0; i < PATTERN_COUNT; i++) {
+            if (cfg_only && !strcmp(cfg_only, g_patterns[i].name)) {
+                build(&g_patterns[i]);
+                return save_capture(write_path) ? 0 : 1;
+            }
+        }
+        usage(argv[0]);
+        return 2;
+    }
+
+    FILE *out = out_path ? fopen(out_path, "w") : stdout;
+    if (!out) {
+        perror(out_path);
+        return 2;
+    }
+
+    int fail = 0;
+    if (read_path) {
+        if (!load_capture(read_path)) return 2;
+        run_capture(read_path, !level_only, out);
+        fail = !same_hits(&g_whole, &g_rand) || !same_hits(&g_whole, &g_single);
+    } else {
+        fprintf(out, "{\"bench\": \"sample_decode\", \"rate_hz\": %u, \"chatter\": %u, \"results\": [\n", cfg_rate_hz, cfg_chatter);
+        int emitted = 0;
+        for (int i = 0; i < PATTERN_COUNT; i++) {
+            if (cfg_only && strcmp(cfg_only, g_patterns[i].name)) continue;
+            for (int e = level_only ? 0 : 1; e >= 0; e--) {
+                if (emitted++) fprintf(out, ",\n");
+                run_pattern(&g_patterns[i], e != 0, out);
+                if (!same_hits(&g_whole, &g_rand) || !same_hits(&g_whole, &g_single)) {
+                    fprintf(stderr, "pattern %s: block split changed the result\n", g_patterns[i].name);
+                    fail = 1;
+                }
+            }
+        }
+        fprintf(out, "\n]}\n");
+        if (emitted == 0) {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (out != stdout) fclose(out);
+    free(g_buf);
+    return fail;
+}
@@ -0,0 +1,7 @@
+#ifndef SIM_HARDWARE_CLOCKS_H
+#define SIM_HARDWARE_CLOCKS_H
+
+// host shim: sim_hal.h 참고
+#include "sim_hal.h"
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef SIM_HARDWARE_IRQ_H
+#define SIM_HARDWARE_IRQ_H
+
+// host shim: sim_hal.h 참고 (DMA_IRQ_0/1만)
+#include "sim_hal.h"
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef SIM_HARDWARE_STRUCTS_IOBANK0_H
+#define SIM_HARDWARE_STRUCTS_IOBANK0_H
+
+// host shim: sim_hal.h 참고 (io_bank0_hw->intr, procN_irq_ctrl.inte 만 제공)
+#include "sim_hal.h"
+
+#endif
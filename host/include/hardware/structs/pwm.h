@@ -0,0 +1,7 @@
+#ifndef SIM_HARDWARE_STRUCTS_PWM_H
+#define SIM_HARDWARE_STRUCTS_PWM_H
+
+// host shim: sim_hal.h 참고 (pwm_hw->slice[n].cc 만 제공)
+#include "sim_hal.h"
+
+#endif
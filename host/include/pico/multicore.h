@@ -0,0 +1,7 @@
+#ifndef SIM_PICO_MULTICORE_H
+#define SIM_PICO_MULTICORE_H
+
+// host shim: sim_hal.h 참고
+#include "sim_hal.h"
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef SIM_PICO_STDLIB_H
+#define SIM_PICO_STDLIB_H
+
+// host shim: sim_hal.h 참고
+#include "sim_hal.h"
+
+#endif
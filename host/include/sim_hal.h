@@ -0,0 +1,506 @@
+#ifndef SIM_HAL_H
+#define SIM_HAL_H
+
+/*
+host(Linux) 빌드용 pico-sdk shim
+- 펌웨어가 쓰는 SDK 함수만 같은 이름으로 제공 (펌웨어 코드는 수정 없이 그대로 빌드)
+- 시간은 가상 시계(us). sleep/busy_wait/tight_loop에서만 시간이 흐름
+- 입력 핀은 sim_gpio_drive()로 바깥(plant/시나리오)에서 구동, 엣지 발생 시 IRQ 콜백 호출
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+// ------------ board ------------
+#ifndef PICO_DEFAULT_LED_PIN
+#define PICO_DEFAULT_LED_PIN    25
+#endif
+
+#define NUM_BANK0_GPIOS         30
+
+// ------------ gpio ------------
+#define GPIO_IN                 false
+#define GPIO_OUT                true
+
+enum gpio_function {
+    GPIO_FUNC_SPI  = 1,
+    GPIO_FUNC_UART = 2,
+    GPIO_FUNC_I2C  = 3,
+    GPIO_FUNC_PWM  = 4,
+    GPIO_FUNC_SIO  = 5,
+    GPIO_FUNC_NULL = 0x1f,
+};
+
+enum gpio_irq_level {
+    GPIO_IRQ_LEVEL_LOW  = 0x1u,
+    GPIO_IRQ_LEVEL_HIGH = 0x2u,
+    GPIO_IRQ_EDGE_FALL  = 0x4u,
+    GPIO_IRQ_EDGE_RISE  = 0x8u,
+};
+
+typedef void (*gpio_irq_callback_t)(uint gpio, uint32_t event_mask);
+
+void gpio_init(uint gpio);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_set_function(uint gpio, enum gpio_function fn);
+void gpio_pull_up(uint gpio);
+void gpio_pull_down(uint gpio);
+void gpio_put(uint gpio, bool value);
+bool gpio_get(uint gpio);
+uint32_t gpio_get_all(void);
+void gpio_set_irq_enabled(uint gpio, uint32_t events, bool enabled);
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events, bool enabled, gpio_irq_callback_t callback);
+void gpio_acknowledge_irq(uint gpio, uint32_t events);
+
+// IO_BANK0 raw interrupt 레지스터 (INTR0~3, GPIO 1개당 4bit : LEVEL_LOW/HIGH, EDGE_LOW/HIGH)
+// - 엣지 bit는 IRQ 활성 여부와 상관없이 latch, gpio_acknowledge_irq로 지움 (gpio_set_irq_enabled도 먼저 지움)
+// - procN_irq_ctrl.inte : core별 활성화된 IRQ 이벤트 (gpio_set_irq_enabled가 갱신)
+// - shim은 intr/inte만 제공 (읽기 전용으로 사용할 것)
+typedef struct {
+    volatile uint32_t inte[4];
+} io_irq_ctrl_hw_t;
+
+typedef struct {
+    volatile uint32_t intr[4];
+    io_irq_ctrl_hw_t proc0_irq_ctrl;
+    io_irq_ctrl_hw_t proc1_irq_ctrl;
+} iobank0_hw_t;
+
+extern iobank0_hw_t *const io_bank0_hw;
+
+// ------------ pwm ------------
+// slice 레지스터는 cc만 사용 (A = 하위 16 bit, B = 상위 16 bit), 펌웨어 DMA 쓰기 대상으로도 씀
+// - 핀 출력 레벨(sim_pwm_level)은 그 핀 slice/채널의 cc 값 (GPIO n과 n+16은 같은 채널)
+#define NUM_PWM_SLICES          8u
+#define PWM_CH0_CC_B_LSB        16u
+
+enum pwm_chan {
+    PWM_CHAN_A = 0,
+    PWM_CHAN_B = 1,
+};
+
+typedef struct {
+    volatile uint32_t csr;
+    volatile uint32_t div;
+    volatile uint32_t ctr;
+    volatile uint32_t cc;
+    volatile uint32_t top;
+} pwm_slice_hw_t;
+
+typedef struct {
+    pwm_slice_hw_t slice[NUM_PWM_SLICES];
+} pwm_hw_t;
+
+extern pwm_hw_t *const pwm_hw;
+
+uint pwm_gpio_to_slice_num(uint gpio);
+uint pwm_gpio_to_channel(uint gpio);
+void pwm_set_wrap(uint slice_num, uint16_t wrap);
+void pwm_set_clkdiv(uint slice_num, float divider);
+void pwm_set_gpio_level(uint gpio, uint16_t level);
+void pwm_set_enabled(uint slice_num, bool enabled);
+
+// ------------ adc ------------
+// 입력 0~3 = GPIO 26~29, 4 = 온도 센서, 변환 값은 sim_adc_drive()로 바깥(plant)에서 (12 bit)
+// - adc_run(true)부터 clk_adc(48 MHz) / max(96, 1 + div) 주기로 연속 변환, round robin이면 변환마다 다음 입력
+// - 변환마다 결과를 fifo에 쓰고 DREQ_ADC인 busy DMA 채널이 1회 전송 (FIFO 깊이/오버플로, one-shot adc_read는 없음)
+#define NUM_ADC_CHANNELS        5u
+#define ADC_BASE_PIN            26u
+#define DREQ_ADC                36u
+
+typedef struct {
+    volatile uint32_t cs;
+    volatile uint32_t result;
+    volatile uint32_t fcs;
+    volatile uint32_t fifo;
+    volatile uint32_t div;
+} adc_hw_t;
+
+extern adc_hw_t *const adc_hw;
+
+void adc_init(void);
+void adc_gpio_init(uint gpio);
+void adc_select_input(uint input);
+void adc_set_round_robin(uint input_mask);
+void adc_fifo_setup(bool en, bool dreq_en, uint16_t dreq_thresh, bool err_in_fifo, bool byte_shift);
+void adc_set_clkdiv(float clkdiv);
+void adc_run(bool run);
+void adc_fifo_drain(void);
+
+// ------------ pio ------------
+// 입력 샘플링만 : SM은 wrap 구간의 "in pins, N" 명령만 실행 (다른 명령이 있으면 enable 때 경고하고 멈춰 있음)
+// - pio_sm_set_enabled(true)부터 SM 클럭(clk_sys / clkdiv)마다 명령 1개 (+ delay), in_base부터 N핀을 ISR로
+// - autopush : threshold가 차면 RX FIFO(4, RX join이면 8)로, 차 있으면 그 word는 버림 (실제로는 SM이 멈춤, DMA가 따라가면 없음)
+// - RX FIFO DREQ(pio_get_dreq)인 busy DMA 채널이 word마다 1회 전송 (read 주소 = &pio->rxf[sm])
+#define NUM_PIOS                2u
+#define NUM_PIO_STATE_MACHINES  4u
+#define PIO_INSTRUCTION_COUNT   32u
+
+#define DREQ_PIO0_TX0           0u
+#define DREQ_PIO0_RX0           4u
+#define DREQ_PIO1_TX0           8u
+#define DREQ_PIO1_RX0           12u
+
+typedef struct {
+    volatile uint32_t txf[NUM_PIO_STATE_MACHINES];
+    volatile uint32_t rxf[NUM_PIO_STATE_MACHINES];
+} pio_hw_t;
+
+typedef pio_hw_t *PIO;
+
+extern pio_hw_t sim_pio_hw[NUM_PIOS];
+#define pio0                    (&sim_pio_hw[0])
+#define pio1                    (&sim_pio_hw[1])
+
+typedef struct pio_program {
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin;              // -1 = 아무 데나
+} pio_program_t;
+
+enum pio_fifo_join {
+    PIO_FIFO_JOIN_NONE = 0,
+    PIO_FIFO_JOIN_TX = 1,
+    PIO_FIFO_JOIN_RX = 2,
+};
+
+typedef struct {
+    uint32_t clkdiv_q8;         // 분주 (8bit 소수)
+    uint8_t wrap_target;
+    uint8_t wrap;
+    uint8_t in_base;
+    bool in_shift_right;
+    bool autopush;
+    uint8_t push_threshold;     // 1~32
+    uint8_t fifo_join;          // enum pio_fifo_join
+} pio_sm_config;
+
+bool pio_can_add_program(PIO pio, const pio_program_t *program);
+uint pio_add_program(PIO pio, const pio_program_t *program);
+int pio_claim_unused_sm(PIO pio, bool required);
+void pio_sm_unclaim(PIO pio, uint sm);
+uint pio_get_index(PIO pio);
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx);
+pio_sm_config pio_get_default_sm_config(void);
+void sm_config_set_wrap(pio_sm_config *c, uint wrap_target, uint wrap);
+void sm_config_set_in_pins(pio_sm_config *c, uint in_base);
+void sm_config_set_in_shift(pio_sm_config *c, bool shift_right, bool autopush, uint push_threshold);
+void sm_config_set_fifo_join(pio_sm_config *c, enum pio_fifo_join join);
+void sm_config_set_clkdiv_int_frac(pio_sm_config *c, uint16_t div_int, uint8_t div_frac);
+void pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config);
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled);
+
+// ------------ dma ------------
+// timer 페이싱 / DREQ_FORCE / DREQ_ADC / PIO RX FIFO DREQ 전송 (다른 DREQ는 시작만 하고 전송 없음)
+// - timer tick은 dma_timer_set_fraction 시각부터 clk_sys × X / Y 주기, tick마다 그 timer DREQ인 busy 채널이 1회 전송
+// - write ring, chain_to 지원 (채널이 끝나면 chain 채널을 같은 시각에 시작, 첫 전송은 다음 tick)
+// - 주소 레지스터는 host 포인터 크기 (uintptr_t)
+#define NUM_DMA_CHANNELS        12u
+#define NUM_DMA_TIMERS          4u
+
+#define DREQ_DMA_TIMER0         0x3bu
+#define DREQ_FORCE              0x3fu
+
+enum dma_channel_transfer_size {
+    DMA_SIZE_8  = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2,
+};
+
+typedef struct {
+    uint8_t size;               // enum dma_channel_transfer_size
+    bool read_incr;
+    bool write_incr;
+    bool ring_write;
+    uint8_t ring_bits;          // 0 = ring 없음
+    uint8_t dreq;
+    uint8_t chain_to;           // 자기 자신 = chain 없음
+    bool enable;
+} dma_channel_config;
+
+typedef struct {
+    volatile uintptr_t read_addr;
+    volatile uintptr_t write_addr;
+    volatile uint32_t transfer_count;   // 남은 전송 수
+} dma_channel_hw_t;
+
+int dma_claim_unused_channel(bool required);
+void dma_channel_unclaim(uint channel);
+dma_channel_config dma_channel_get_default_config(uint channel);
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size);
+void channel_config_set_read_increment(dma_channel_config *c, bool incr);
+void channel_config_set_write_increment(dma_channel_config *c, bool incr);
+void channel_config_set_ring(dma_channel_config *c, bool write, uint size_bits);
+void channel_config_set_dreq(dma_channel_config *c, uint dreq);
+void channel_config_set_chain_to(dma_channel_config *c, uint chain_to);
+void channel_config_set_enable(dma_channel_config *c, bool enable);
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger);
+void dma_channel_start(uint channel);
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count);
+void dma_channel_abort(uint channel);
+bool dma_channel_is_busy(uint channel);
+dma_channel_hw_t *dma_channel_hw_addr(uint channel);
+
+int dma_claim_unused_timer(bool required);
+void dma_timer_unclaim(uint timer);
+void dma_timer_set_fraction(uint timer, uint16_t numerator, uint16_t denominator);
+uint dma_get_timer_dreq(uint timer_num);
+
+// 채널 완료 IRQ : 전송 수가 0이 되면 raw bit가 서고, DMA_IRQ_n에 활성된 채널이면 그 IRQ를 켠 core에서 handler 실행
+// - handler는 acknowledge로 bit를 지워야 함 (level IRQ, 지울 때까지 다시 실행), abort는 bit를 세우지 않음
+// - 완료 시각은 timer tick 시각 (µs 올림)에 처리
+void dma_channel_set_irq0_enabled(uint channel, bool enabled);
+void dma_channel_set_irq1_enabled(uint channel, bool enabled);
+bool dma_channel_get_irq0_status(uint channel);
+bool dma_channel_get_irq1_status(uint channel);
+void dma_channel_acknowledge_irq0(uint channel);
+void dma_channel_acknowledge_irq1(uint channel);
+
+// ------------ irq ------------
+// NVIC는 DMA_IRQ_0/1만 (GPIO는 gpio_set_irq_enabled_with_callback, alarm은 alarm pool)
+// - handler 표는 두 core 공용, 활성화는 irq_set_enabled를 부른 core에만
+#define DMA_IRQ_0               11u
+#define DMA_IRQ_1               12u
+
+typedef void (*irq_handler_t)(void);
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler);
+void irq_set_enabled(uint num, bool enabled);
+
+// ------------ clocks / time ------------
+enum clock_index {
+    clk_ref = 4,
+    clk_sys = 5,
+    clk_peri = 6,
+    clk_adc = 8,
+};
+
+bool set_sys_clock_khz(uint32_t freq_khz, bool required);
+uint32_t clock_get_hz(enum clock_index clk_index);
+
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+absolute_time_t get_absolute_time(void);
+
+static inline uint32_t to_ms_since_boot(absolute_time_t t) {
+    return (uint32_t)(t / 1000u);
+}
+
+static inline uint64_t to_us_since_boot(absolute_time_t t) {
+    return t;
+}
+
+static inline absolute_time_t from_us_since_boot(uint64_t us) {
+    return us;
+}
+
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+void busy_wait_us(uint64_t us);
+void busy_wait_ms(uint32_t ms);
+void tight_loop_contents(void);
+
+// ------------ alarm ------------
+// 콜백 반환값: 0 = 종료, >0 = 지금부터 그 us 뒤 재호출, <0 = 직전 예정 시각부터 -값 us 뒤 재호출
+typedef int32_t alarm_id_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void *user_data);
+
+alarm_id_t add_alarm_at(absolute_time_t time, alarm_callback_t callback, void *user_data, bool fire_if_past);
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past);
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past);
+bool cancel_alarm(alarm_id_t alarm_id);
+
+// alarm pool: 콜백(IRQ)이 실행되는 core를 정함. 기본 pool은 core0
+typedef struct alarm_pool alarm_pool_t;
+
+alarm_pool_t *alarm_pool_get_default(void);
+alarm_pool_t *alarm_pool_create_with_unused_hardware_alarm(uint max_timers);   // 호출한 core의 IRQ로 실행
+alarm_id_t alarm_pool_add_alarm_at(alarm_pool_t *pool, absolute_time_t time, alarm_callback_t callback, void *user_data, bool fire_if_past);
+alarm_id_t alarm_pool_add_alarm_in_us(alarm_pool_t *pool, uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past);
+
+// ------------ repeating timer ------------
+// delay_us > 0 : 콜백 끝 → 다음 시작 간격, delay_us < 0 : 콜백 시작 간격 (고정 주기)
+typedef struct repeating_timer repeating_timer_t;
+typedef bool (*repeating_timer_callback_t)(repeating_timer_t *rt);
+
+struct repeating_timer {
+    int64_t delay_us;
+    alarm_pool_t *pool;
+    alarm_id_t alarm_id;
+    repeating_timer_callback_t callback;
+    void *user_data;
+};
+
+bool alarm_pool_add_repeating_timer_us(alarm_pool_t *pool, int64_t delay_us, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out);
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out);
+bool add_repeating_timer_ms(int32_t delay_ms, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out);
+bool cancel_repeating_timer(repeating_timer_t *timer);
+
+// ------------ sync ------------
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t status);
+
+// spin lock : core 사이 짧은 배타 구간 (lock 동안 이 core 인터럽트 비활성)
+// host에서는 한 번에 한 core만 돌고 lock 안에서 core가 바뀌지 않으므로 인터럽트 비활성 + 중첩 확인만
+typedef volatile uint32_t spin_lock_t;
+int spin_lock_claim_unused(bool required);
+spin_lock_t *spin_lock_init(uint lock_num);
+uint32_t spin_lock_blocking(spin_lock_t *lock);
+void spin_unlock(spin_lock_t *lock, uint32_t saved_irq);
+
+// 이 core에 IRQ가 들어올 때까지 대기 (인터럽트 비활성 중이어도 pending이면 깨어남, ISR은 restore_interrupts 때)
+void __wfi(void);
+
+#define __compiler_memory_barrier()     __asm__ volatile ("" ::: "memory")
+#define __mem_fence_acquire()           __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define __mem_fence_release()           __atomic_thread_fence(__ATOMIC_RELEASE)
+
+// ------------ multicore ------------
+// core0/core1은 pthread로 모델링 (한 번에 한 core만 실행, 가상 시간 순서)
+uint get_core_num(void);
+void multicore_launch_core1(void (*entry)(void));
+bool multicore_fifo_rvalid(void);
+bool multicore_fifo_wready(void);
+void multicore_fifo_push_blocking(uint32_t data);
+uint32_t multicore_fifo_pop_blocking(void);
+void multicore_fifo_drain(void);
+
+// ------------ queue (pico/util/queue) ------------
+// 고정 크기 원소 ring (core 사이 / IRQ ↔ main), blocking 함수는 빌/찰 동안 WFE로 잠듦
+typedef struct {
+    uint8_t *data;
+    uint16_t wptr;
+    uint16_t rptr;
+    uint16_t element_size;
+    uint16_t element_count;
+} queue_t;
+
+void queue_init(queue_t *q, uint element_size, uint element_count);
+void queue_free(queue_t *q);
+uint queue_get_level(queue_t *q);
+bool queue_try_add(queue_t *q, const void *data);
+bool queue_try_remove(queue_t *q, void *data);
+void queue_add_blocking(queue_t *q, const void *data);
+void queue_remove_blocking(queue_t *q, void *data);
+
+static inline bool queue_is_empty(queue_t *q) {
+    return queue_get_level(q) == 0;
+}
+
+static inline bool queue_is_full(queue_t *q) {
+    return queue_get_level(q) == q->element_count;
+}
+
+// ------------ flash ------------
+// XIP 읽기는 host 메모리 배열로 (펌웨어는 XIP_BASE + offset 포인터로 그대로 읽음)
+// 전원을 꺼도 유지되는 것처럼 sim_reset()에서 초기화하지 않음
+#define FLASH_PAGE_SIZE         256u
+#define FLASH_SECTOR_SIZE       4096u
+
+#ifndef PICO_FLASH_SIZE_BYTES
+#define PICO_FLASH_SIZE_BYTES   (2u * 1024u * 1024u)
+#endif
+
+extern uint8_t sim_flash_mem[PICO_FLASH_SIZE_BYTES];
+#define XIP_BASE                ((uintptr_t)sim_flash_mem)
+
+#define PICO_OK                 0
+#define PICO_ERROR_NOT_PERMITTED    (-4)
+
+// SDK와 같음 : 1이면 core1이 lockout victim이 아니어도 flash_safe_execute 허용 (core1이 flash를 안 읽는다고 가정)
+#ifndef PICO_FLASH_ASSUME_CORE1_SAFE
+#define PICO_FLASH_ASSUME_CORE1_SAFE    0
+#endif
+
+void flash_range_erase(uint32_t flash_offs, size_t count);
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count);
+
+// 다른 core 정지 + 인터럽트 비활성 후 func 실행 (host에서는 한 번에 한 core만 돌아서 바로 실행)
+// 다른 core가 multicore_lockout_victim_init 안 했으면 (core1을 안 띄운 펌웨어 포함) PICO_ERROR_NOT_PERMITTED
+// (core0에서 부를 때 PICO_FLASH_ASSUME_CORE1_SAFE면 허용)
+// lockout은 SIO FIFO를 씀 : victim core로 push한 word는 그 core의 lockout handler가 버리고,
+// flash_safe_execute의 handshake는 부른 core의 FIFO를 비움 → lockout을 쓰면 FIFO로 다른 메시지를 주고받지 말 것
+int flash_safe_execute(void (*func)(void *), void *param, uint32_t enter_exit_timeout_ms);
+void multicore_lockout_victim_init(void);
+
+// ------------ uart ------------
+// TX만 : FIFO(32 byte)가 baud 속도로 비워지는 것을 가상 시간으로 계산, 보낸 byte는 sim_uart_attach()한 fd로 (pty 등)
+#define UART_FIFO_DEPTH         32u
+
+typedef enum {
+    UART_PARITY_NONE,
+    UART_PARITY_EVEN,
+    UART_PARITY_ODD
+} uart_parity_t;
+
+typedef struct uart_inst {
+    uint index;
+} uart_inst_t;
+
+extern uart_inst_t sim_uart_inst[2];
+#define uart0                   (&sim_uart_inst[0])
+#define uart1                   (&sim_uart_inst[1])
+
+uint uart_init(uart_inst_t *uart, uint baudrate);
+void uart_set_format(uart_inst_t *uart, uint data_bits, uint stop_bits, uart_parity_t parity);
+void uart_set_fifo_enabled(uart_inst_t *uart, bool enabled);
+bool uart_is_writable(uart_inst_t *uart);
+void uart_putc_raw(uart_inst_t *uart, char c);
+void uart_write_blocking(uart_inst_t *uart, const uint8_t *src, size_t len);
+void uart_tx_wait_blocking(uart_inst_t *uart);
+
+// ------------ stdio ------------
+#define PICO_ERROR_TIMEOUT      (-1)
+
+bool stdio_init_all(void);
+
+// 입력은 sim_stdin_feed()로 넣은 문자열, 없으면 timeout_us 만큼 시간이 흐른 뒤 PICO_ERROR_TIMEOUT
+int getchar_timeout_us(uint32_t timeout_us);
+
+// =====================================================================
+// sim API (host 전용)
+// =====================================================================
+
+// busy-poll 루프 1회에 걸리는 가상 시간 (tight_loop_contents 1회)
+#define SIM_LOOP_COST_US        1u
+
+// plant 콜백: now 시점의 입력 변화를 반영하고, 다음에 다시 불려야 할 시각(us)을 반환
+typedef uint64_t (*sim_plant_fn)(uint64_t now_us);
+
+#define SIM_NEVER               UINT64_MAX
+
+void sim_reset(void);
+void sim_set_plant(sim_plant_fn plant);
+uint64_t sim_now_us(void);
+
+// 입력 핀을 바깥에서 구동 (엣지 발생 시 IRQ 콜백 호출)
+void sim_gpio_drive(uint gpio, bool level);
+bool sim_gpio_out(uint gpio);
+uint16_t sim_pwm_level(uint gpio);
+
+// ADC 입력 값 (12 bit로 자름), 다음 변환부터 반영
+void sim_adc_drive(uint input, uint16_t value);
+
+// flash 내용을 파일로 저장/복원 (전원 재투입 시뮬레이션), erase 횟수 (마모 확인용)
+bool sim_flash_load(const char *path);
+bool sim_flash_save(const char *path);
+uint32_t sim_flash_erase_count(void);
+
+// UART TX byte를 fd에 씀 (-1이면 버림), noise_every > 0이면 그 간격의 byte마다 bit 0 반전 (CRC 확인용)
+void sim_uart_attach(uint index, int fd);
+void sim_uart_set_noise(uint index, uint32_t noise_every);
+uint32_t sim_uart_tx_count(uint index);
+
+// 펌웨어 stdio 입력 (getchar_timeout_us로 읽힘)
+void sim_stdin_feed(const char *s);
+
+// 펌웨어 entry를 core0 스레드에서 실행, sim_stop() 호출 시 반환
+void sim_run(int (*entry)(void));
+void sim_stop(void);
+
+#endif
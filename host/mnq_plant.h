@@ -0,0 +1,161 @@
+#ifndef MNQ_PLANT_H
+#define MNQ_PLANT_H
+
+/*
+sub_pcb_mnq.c 모터/엔드스탑 plant 모델 (sim_mnq, bench_mnq 공용)
+- 펌웨어 소스를 include 한 뒤에 include (g_mnq_pins 핀 표, PWM_MAX_LEVEL 사용)
+- target(MNQ_TARGET_COUNT)마다 위치(0=위, 1=아래)를 PWM duty로 적분, 양 끝에서 엔드스탑 눌림
+- 이동 시간(PWM 0 → >0 → 0)을 방향별로 누적 (전 target 합산)
+- 엔드스탑 고장 : plant_stuck_every[e] = N 이면 그 끝의 스위치가 N번째 도착마다 안 눌림 (1이면 항상, 0이면 정상)
+  안 눌린 도착은 캐리지가 그 끝에서 떨어질 때까지 유지 (전 target)
+- 모터 전류 → ADC 입력 target (sim_adc_drive, 12 bit count) : 부하 + stall × (duty - 속도)
+  속도는 duty를 PLANT_SPEED_TAU_MS로 따라감 (전류 모양만, 위치는 위처럼 duty로 적분), 끝에 닿거나 걸리면 속도 0
+- 걸림 : plant_jam_every = N 이면 N번째 스트로크(끝에서 출발)마다 PLANT_JAM_POS 지점에서 PLANT_JAM_MS 동안
+  그 방향으로 안 움직임 (반대 방향은 풀림, 스트로크 순서는 전 target 합산)
+*/
+
+// ------------ plant 파라미터 ------------
+// 255/255 기준 전체 스트로크 이동 시간 (README 2-2 실측치 기준)
+#define PLANT_FULL_SPEED_MS_DOWN    1200.0
+#define PLANT_FULL_SPEED_MS_UP      1700.0
+
+// 엔드스탑 해제 히스테리시스 (스트로크 비율)
+#define PLANT_SW_HYST               0.002
+
+// 모터 전류 (ADC count) : 돌 때 부하, 멈춘 채 duty 1이면 + STALL
+#define PLANT_I_LOAD                400.0
+#define PLANT_I_STALL               3000.0
+#define PLANT_I_NOISE               30u     // ± count
+#define PLANT_SPEED_TAU_MS          15.0
+
+// 걸림 위치 (스트로크 비율, 가는 방향 기준) / 시간
+#define PLANT_JAM_POS               0.5
+#define PLANT_JAM_MS                200u
+
+// ------------ plant 상태 ------------
+typedef struct {
+    double   pos;                   // 0 = 위(올라간 상태), 1 = 아래
+    bool     moving;
+    bool     move_down;
+    uint64_t move_start_us;
+    bool     at_end[2];             // [0] = 위 끝(LIMIT_SW_UNDER), [1] = 아래 끝(LIMIT_SW_TOP)
+    bool     stuck[2];              // 이번 도착은 스위치 안 눌림
+    uint32_t arrivals[2];
+    double   speed;                 // duty 기준 (전류 모델)
+    bool     jam_stroke;            // 이번 스트로크는 걸림
+    bool     jam_down;              // 걸리는 방향
+    uint64_t jam_until_us;          // 0 = 걸리기 전
+} plant_target_t;
+
+static plant_target_t plant_t[MNQ_TARGET_COUNT];
+static uint64_t plant_last_us = 0;
+static uint32_t plant_stuck_every[2];   // [0] = LIMIT_SW_UNDER, [1] = LIMIT_SW_TOP
+static uint32_t st_stuck_n[2];          // 안 눌린 도착 수 (전 target 합)
+static uint32_t plant_jam_every;
+static uint32_t plant_strokes;
+static uint32_t plant_noise_seed = 1;
+static uint32_t st_jam_n;               // 걸린 스트로크 수 (전 target 합)
+
+static uint64_t st_travel_sum_us[2];   // [0]=up, [1]=down
+static uint32_t st_travel_n[2];
+
+// 초기 상태: 위에 있음 (UNDER 눌림, TOP 해제)
+static void plant_init(void) {
+    plant_last_us = sim_now_us();
+    for (uint t = 0; t < MNQ_TARGET_COUNT; t++) {
+        plant_t[t] = (plant_target_t){ .pos = 0.0, .at_end = { true, false } };
+        sim_gpio_drive(g_mnq_pins[t].limit_under, 0);
+        sim_gpio_drive(g_mnq_pins[t].limit_top, 1);
+    }
+}
+
+static void plant_target_motion(uint t, uint64_t now, double dt_ms) {
+    const mnq_pins_t *pins = &g_mnq_pins[t];
+    plant_target_t *pl = &plant_t[t];
+
+    uint16_t level = sim_pwm_level(pins->pwm);
+    bool down = sim_gpio_out(pins->dir);
+    double duty = (double)level / (double)PWM_MAX_LEVEL;
+
+    // 걸림 : 가는 방향으로 PLANT_JAM_POS를 지나는 순간부터 PLANT_JAM_MS 동안 제자리
+    bool jammed = false;
+    if (pl->jam_stroke && level > 0 && down == pl->jam_down) {
+        bool past = down ? pl->pos >= PLANT_JAM_POS : pl->pos <= 1.0 - PLANT_JAM_POS;
+        if (pl->jam_until_us == 0 && past) {
+            pl->jam_until_us = now + (uint64_t)PLANT_JAM_MS * 1000u;
+            st_jam_n++;
+        }
+        jammed = pl->jam_until_us != 0 && now < pl->jam_until_us;
+    }
+
+    if (level > 0 && !jammed) {
+        if (down) pl->pos += dt_ms * duty / PLANT_FULL_SPEED_MS_DOWN;
+        else      pl->pos -= dt_ms * duty / PLANT_FULL_SPEED_MS_UP;
+    }
+    if (pl->pos > 1.0) pl->pos = 1.0;
+    if (pl->pos < 0.0) pl->pos = 0.0;
+
+    // 끝 도착 (끝에서 HYST 이상 떨어져야 떠난 것으로), 도착마다 스위치 고장 여부 결정
+    bool at[2] = {
+        pl->pos <= 0.0 || (pl->at_end[0] && pl->pos <= PLANT_SW_HYST),
+        pl->pos >= 1.0 || (pl->at_end[1] && pl->pos >= 1.0 - PLANT_SW_HYST),
+    };
+    for (int e = 0; e < 2; e++) {
+        if (at[e] && !pl->at_end[e]) {
+            pl->arrivals[e]++;
+            pl->stuck[e] = plant_stuck_every[e] && pl->arrivals[e] % plant_stuck_every[e] == 0;
+            if (pl->stuck[e]) st_stuck_n[e]++;
+        }
+        pl->at_end[e] = at[e];
+    }
+
+    // 눌리면 LOW
+    sim_gpio_drive(pins->limit_under, !(at[0] && !pl->stuck[0]));
+    sim_gpio_drive(pins->limit_top, !(at[1] && !pl->stuck[1]));
+
+    // 모터 전류 : 가는 방향 끝에 닿았거나 걸렸으면 속도 0
+    bool blocked = jammed || (level > 0 && (down ? pl->pos >= 1.0 : pl->pos <= 0.0));
+    if (blocked) {
+        pl->speed = 0.0;
+    } else {
+        pl->speed += (duty - pl->speed) * (dt_ms < PLANT_SPEED_TAU_MS ? dt_ms / PLANT_SPEED_TAU_MS : 1.0);
+    }
+    double amps = 0.0;
+    if (level > 0) {
+        double slip = duty - pl->speed;
+        amps = PLANT_I_LOAD + PLANT_I_STALL * (slip > 0.0 ? slip : 0.0);
+        plant_noise_seed = plant_noise_seed * 1103515245u + 12345u;
+        amps += (double)((plant_noise_seed >> 16) % (2u * PLANT_I_NOISE + 1u)) - (double)PLANT_I_NOISE;
+    }
+    if (amps < 0.0) amps = 0.0;
+    if (amps > 4095.0) amps = 4095.0;
+    sim_adc_drive(t, (uint16_t)amps);
+
+    // 이동 시간 측정 (PWM 0 → >0 → 0), 끝에서 출발하면 새 스트로크 (중간에서 다시 출발은 같은 스트로크)
+    if (!pl->moving && level > 0 && (pl->at_end[0] || pl->at_end[1])) {
+        plant_strokes++;
+        pl->jam_stroke = plant_jam_every && plant_strokes % plant_jam_every == 0;
+        pl->jam_down = down;
+        pl->jam_until_us = 0;
+    }
+    if (!pl->moving && level > 0) {
+        pl->moving = true;
+        pl->move_down = down;
+        pl->move_start_us = now;
+    } else if (pl->moving && level == 0) {
+        pl->moving = false;
+        st_travel_sum_us[pl->move_down] += now - pl->move_start_us;
+        st_travel_n[pl->move_down]++;
+    }
+}
+
+static void plant_motion(uint64_t now) {
+    double dt_ms = (double)(now - plant_last_us) / 1000.0;
+    plant_last_us = now;
+
+    for (uint t = 0; t < MNQ_TARGET_COUNT; t++) {
+        plant_target_motion(t, now, dt_ms);
+    }
+}
+
+#endif
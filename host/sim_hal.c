@@ -0,0 +1,1678 @@
+#include "sim_hal.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*
+가상 시계 기반 pico-sdk shim
+- 시간은 펌웨어가 sleep/busy_wait/tight_loop를 호출할 때만 흐름
+- 시간이 흐르는 동안 plant 콜백을 요청 시각마다 호출 → plant가 입력 핀을 구동
+- 입력 엣지는 즉시 IRQ 콜백으로 전달 (인터럽트 비활성 중이면 restore 시 전달)
+- core0/core1은 각각 pthread, 한 번에 한 core만 실행 (baton)
+  core가 sleep하면 가장 먼저 깨어날 core로 baton을 넘김 → 가상 시간 기준으로 결정적 실행
+- advance_to는 가상 1 ms마다 여러 번 돌므로 상태 확인은 bit mask로 (빈 alarm 슬롯, 쉬는 DMA/PIO는 훑지 않음)
+*/
+
+#define SIM_NUM_CORES           2
+#define SIM_FIFO_DEPTH          8
+
+// ------------ gpio state ------------
+typedef struct {
+    bool out;                           // 방향 (true = output)
+    bool level;                         // 현재 레벨
+    bool driven;                        // sim_gpio_drive()로 바깥에서 구동 중인지
+    uint32_t irq_mask[SIM_NUM_CORES];   // core별 활성화된 IRQ 이벤트
+    uint32_t pending[SIM_NUM_CORES];    // 인터럽트 비활성 중 쌓인 이벤트
+} sim_pin_t;
+
+static sim_pin_t g_pins[NUM_BANK0_GPIOS];
+static uint32_t g_levels = 0;           // 핀 레벨 bit (gpio_get_all, PIO in pins : 매 샘플 핀 30개를 훑지 않게)
+static iobank0_hw_t g_io_bank0;
+iobank0_hw_t *const io_bank0_hw = &g_io_bank0;
+static gpio_irq_callback_t g_irq_callback[SIM_NUM_CORES];
+static bool g_irq_disabled[SIM_NUM_CORES];
+static uint32_t g_irq_seq[SIM_NUM_CORES];  // core별 실행된 IRQ 수 (__wfi 깨우기 판단)
+static bool g_in_irq[SIM_NUM_CORES];        // IRQ 콜백 실행 중 (같은 우선순위 IRQ는 중첩되지 않음)
+
+// ------------ pwm / nvic state ------------
+static pwm_hw_t g_pwm;
+pwm_hw_t *const pwm_hw = &g_pwm;
+
+#define SIM_NUM_IRQS            32u
+#define SIM_IRQ_ACK_MAX         16u     // handler가 bit를 안 지우고 이만큼 연속 실행되면 중단
+
+static irq_handler_t g_irq_handler[SIM_NUM_IRQS];
+static uint32_t g_irq_enabled[SIM_NUM_CORES];  // core별 NVIC 활성 bit (DMA_IRQ_0/1만 사용)
+
+// ------------ time state ------------
+static uint64_t g_now_us = 0;
+static sim_plant_fn g_plant = NULL;
+static uint64_t g_plant_next_us = SIM_NEVER;
+static uint32_t g_sys_hz = 125000000u;
+
+// ------------ alarm state ------------
+#define SIM_MAX_ALARMS          32
+
+#define SIM_MAX_POOLS           4
+
+struct alarm_pool {
+    uint core;                  // 콜백을 실행할 core
+};
+
+typedef struct {
+    alarm_id_t id;              // 0 = 빈 슬롯
+    uint64_t at_us;
+    alarm_callback_t callback;
+    void *user_data;
+    uint core;
+} sim_alarm_t;
+
+static sim_alarm_t g_alarms[SIM_MAX_ALARMS];
+static uint32_t g_alarm_used = 0;               // id != 0 인 슬롯 bit (SIM_MAX_ALARMS <= 32)
+static alarm_id_t g_next_alarm_id = 1;
+static uint64_t g_alarm_next_us = SIM_NEVER;    // 가장 빠른 alarm 시각 (캐시)
+
+static alarm_pool_t g_pools[SIM_MAX_POOLS];     // [0] = 기본 pool (core0)
+static uint g_pool_count = 1;
+
+// ------------ core state ------------
+typedef struct {
+    bool active;
+    bool wfe_wait;              // FIFO pop / queue remove 대기 중 (상대 core의 push / add가 __sev로 깨움)
+    uint64_t wake_us;           // 이 시각까지 sleep 중
+    pthread_t thread;
+    void (*entry)(void);
+} sim_core_t;
+
+static sim_core_t g_cores[SIM_NUM_CORES];
+static __thread uint t_core = 0;
+
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_cond[SIM_NUM_CORES] = { PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER };
+static int g_baton = 0;         // 실행 중인 core, -1이면 종료 중
+
+// ------------ fifo state ------------
+// g_fifo[n] = core n 이 읽는 FIFO
+typedef struct {
+    uint32_t buf[SIM_FIFO_DEPTH];
+    uint32_t head;
+    uint32_t tail;
+} sim_fifo_t;
+
+static sim_fifo_t g_fifo[SIM_NUM_CORES];
+
+// multicore_lockout_victim_init 한 core : SIO FIFO IRQ handler가 FIFO를 비우며 lockout magic이 아닌 word는 버림
+static bool g_lockout_victim[SIM_NUM_CORES];
+
+// SIO spin lock (claim 여부 bit)
+#define SIM_NUM_SPIN_LOCKS      32u
+static spin_lock_t g_spin_locks[SIM_NUM_SPIN_LOCKS];
+static uint32_t g_spin_claimed = 0;
+
+// ------------ flash state ------------
+uint8_t sim_flash_mem[PICO_FLASH_SIZE_BYTES];
+static bool g_flash_init = false;
+static uint32_t g_flash_erase_count = 0;
+
+// ------------ uart state ------------
+typedef struct {
+    uint32_t baud;
+    uint64_t byte_ns;                   // 8N1 byte 1개 송출 시간
+    uint64_t tx_free_ns;                // TX FIFO + shift register가 다 비는 시각
+    int fd;                             // 보낸 byte를 쓸 곳, -1이면 버림
+    uint32_t noise_every;
+    uint32_t tx_count;
+} sim_uart_t;
+
+uart_inst_t sim_uart_inst[2] = { { 0 }, { 1 } };
+static sim_uart_t g_uart[2] = { { .fd = -1 }, { .fd = -1 } };
+
+// ------------ dma state ------------
+typedef struct {
+    bool claimed;
+    dma_channel_config cfg;
+    uint32_t reload;                    // trigger 때 transfer_count로 다시 쓰는 값
+} sim_dma_ch_t;
+
+typedef struct {
+    bool claimed;
+    bool running;                       // dma_timer_set_fraction 뒤
+    uint16_t num;
+    uint16_t den;
+    uint64_t t0_ns;                     // tick 0 시각
+    uint64_t ticks;                     // 지난 tick 수 (t0 + ticks × 주기 까지 처리함)
+} sim_dma_timer_t;
+
+static sim_dma_ch_t g_dma[NUM_DMA_CHANNELS];
+static dma_channel_hw_t g_dma_hw[NUM_DMA_CHANNELS];
+static sim_dma_timer_t g_dma_timer[NUM_DMA_TIMERS];
+static uint32_t g_dma_busy;                 // 전송 중인 채널 bit
+static uint32_t g_dma_intr;                 // 채널 완료 raw bit
+static uint32_t g_dma_inte[2];              // DMA_IRQ_0/1 활성 채널
+
+// ------------ adc state ------------
+#define SIM_ADC_HZ              48000000u
+#define SIM_ADC_MIN_CYCLES      96u
+
+typedef struct {
+    uint16_t value[NUM_ADC_CHANNELS];   // sim_adc_drive
+    uint input;                         // 다음 변환 입력
+    uint rr_mask;
+    bool running;
+    uint32_t div_q8;                    // adc_set_clkdiv (8bit 소수)
+    uint64_t t0_ns;                     // adc_run(true) 시각
+    uint64_t conv;                      // 지난 변환 수 (t0 + conv × 주기 까지 처리함)
+} sim_adc_t;
+
+static sim_adc_t g_adc;
+static adc_hw_t g_adc_hw;
+adc_hw_t *const adc_hw = &g_adc_hw;
+
+// ------------ pio state ------------
+#define SIM_PIO_RX_DEPTH        4u
+
+typedef struct {
+    bool claimed;
+    bool running;
+    pio_sm_config cfg;
+    uint pc;
+    uint64_t t0_ns;                     // pio_sm_set_enabled(true) 시각
+    uint64_t clk;                       // 다음 명령이 시작하는 SM 클럭 (t0부터, 실행은 그 다음 클럭)
+    uint32_t isr;
+    uint32_t isr_count;                 // ISR에 들어간 bit 수
+    uint32_t rx[2u * SIM_PIO_RX_DEPTH];
+    uint32_t rx_rd;
+    uint32_t rx_wr;
+} sim_pio_sm_t;
+
+typedef struct {
+    uint16_t instr[PIO_INSTRUCTION_COUNT];
+    uint32_t used;                      // 명령 메모리 사용 bit
+    sim_pio_sm_t sm[NUM_PIO_STATE_MACHINES];
+} sim_pio_t;
+
+pio_hw_t sim_pio_hw[NUM_PIOS];
+static sim_pio_t g_pio[NUM_PIOS];
+static uint g_pio_running = 0;          // 실행 중인 SM 수 (0이면 pio_run_until 건너뜀)
+
+// ------------ stdio state ------------
+#define SIM_STDIN_SIZE          256
+
+static char g_stdin[SIM_STDIN_SIZE];
+static uint32_t g_stdin_head = 0;
+static uint32_t g_stdin_tail = 0;
+
+// ------------ run state ------------
+static volatile bool g_stop = false;
+
+// ------------ util ------------
+static void deliver_irq(uint gpio, uint32_t events) {
+    for (uint c = 0; c < SIM_NUM_CORES; c++) {
+        uint32_t ev = events & g_pins[gpio].irq_mask[c];
+        if (!g_irq_callback[c] || ev == 0) continue;
+        if (g_irq_disabled[c]) {
+            g_pins[gpio].pending[c] |= ev;
+            continue;
+        }
+        // IRQ는 해당 core 위에서 실행된 것으로 취급 (get_core_num, FIFO 방향)
+        uint saved = t_core;
+        bool saved_in_irq = g_in_irq[c];
+        t_core = c;
+        g_in_irq[c] = true;
+        g_irq_seq[c]++;
+        g_irq_callback[c](gpio, ev);
+        g_in_irq[c] = saved_in_irq;
+        t_core = saved;
+    }
+}
+
+// 핀 레벨은 모두 여기서 바꿈 (g_levels와 같이)
+static inline void pin_set_level(uint gpio, bool level) {
+    g_pins[gpio].level = level;
+    if (level) g_levels |= 1u << gpio;
+    else       g_levels &= ~(1u << gpio);
+}
+
+static void set_input_level(uint gpio, bool level) {
+    sim_pin_t *p = &g_pins[gpio];
+    if (p->level == level) return;
+    pin_set_level(gpio, level);
+
+    uint32_t ev = level ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+    g_io_bank0.intr[gpio >> 3] |= ev << (4u * (gpio & 7u));     // raw latch (IRQ 활성 여부 무관)
+    deliver_irq(gpio, ev);
+}
+
+// 인터럽트 비활성 중인 core의 alarm은 restore_interrupts 때까지 보류
+static bool alarm_ready(const sim_alarm_t *a) {
+    return a->id != 0 && !g_irq_disabled[a->core];
+}
+
+static void update_next_alarm(void) {
+    uint64_t t = SIM_NEVER;
+    for (uint32_t m = g_alarm_used; m; m &= m - 1u) {
+        const sim_alarm_t *a = &g_alarms[__builtin_ctz(m)];
+        if (alarm_ready(a) && a->at_us < t) t = a->at_us;
+    }
+    g_alarm_next_us = t;
+}
+
+// 슬롯 하나 실행 (콜백 반환값에 따라 재예약/해제)
+static void fire_alarm(sim_alarm_t *a) {
+    alarm_id_t id = a->id;
+    uint64_t at = a->at_us;
+
+    uint saved = t_core;
+    bool saved_in_irq = g_in_irq[a->core];
+    t_core = a->core;
+    g_in_irq[a->core] = true;
+    g_irq_seq[a->core]++;
+    int64_t ret = a->callback(id, a->user_data);
+    g_in_irq[a->core] = saved_in_irq;
+    t_core = saved;
+
+    // 콜백 안에서 cancel 되었으면 그대로 둠
+    if (a->id != id) return;
+    if (ret > 0)      a->at_us = g_now_us + (uint64_t)ret;
+    else if (ret < 0) a->at_us = at + (uint64_t)(-ret);
+    else {
+        a->id = 0;
+        g_alarm_used &= ~(1u << (a - g_alarms));
+    }
+}
+
+static void fire_due_alarms(void) {
+    if (g_now_us < g_alarm_next_us) return;
+
+    // 슬롯 순서대로, 콜백이 추가/취소한 슬롯도 반영 (다음 slot은 지금의 g_alarm_used에서)
+    bool fired = true;
+    while (fired) {
+        fired = false;
+        for (uint32_t m = g_alarm_used; m; ) {
+            uint i = (uint)__builtin_ctz(m);
+            if (alarm_ready(&g_alarms[i]) && g_alarms[i].at_us <= g_now_us) {
+                fire_alarm(&g_alarms[i]);
+                fired = true;
+            }
+            m = g_alarm_used & ~((2u << i) - 1u);
+        }
+    }
+    update_next_alarm();
+}
+
+// ------------ dma ------------
+// tick k 시각 (ns) : t0 + k × den / num 클럭
+static uint64_t dma_tick_ns(const sim_dma_timer_t *t, uint64_t k) {
+    return t->t0_ns + (uint64_t)((unsigned __int128)k * t->den * 1000000000u / ((uint64_t)t->num * g_sys_hz));
+}
+
+static void dma_transfer(uint ch) {
+    sim_dma_ch_t *c = &g_dma[ch];
+    dma_channel_hw_t *hw = &g_dma_hw[ch];
+    uint32_t size = 1u << c->cfg.size;
+
+    memcpy((void *)hw->write_addr, (const void *)hw->read_addr, size);
+
+    if (c->cfg.read_incr) {
+        uintptr_t mask = (c->cfg.ring_bits && !c->cfg.ring_write) ? ((uintptr_t)1 << c->cfg.ring_bits) - 1u : ~(uintptr_t)0;
+        hw->read_addr = (hw->read_addr & ~mask) | ((hw->read_addr + size) & mask);
+    }
+    if (c->cfg.write_incr) {
+        uintptr_t mask = (c->cfg.ring_bits && c->cfg.ring_write) ? ((uintptr_t)1 << c->cfg.ring_bits) - 1u : ~(uintptr_t)0;
+        hw->write_addr = (hw->write_addr & ~mask) | ((hw->write_addr + size) & mask);
+    }
+
+    if (--hw->transfer_count == 0) {
+        g_dma_busy &= ~(1u << ch);
+        g_dma_intr |= 1u << ch;
+        if (c->cfg.chain_to != ch) dma_channel_start(c->cfg.chain_to);
+    }
+}
+
+// 이 DREQ로 전송 중인 채널 bit
+static uint32_t dma_paced(uint dreq) {
+    uint32_t paced = 0;
+    for (uint32_t m = g_dma_busy; m; m &= m - 1u) {
+        uint ch = (uint)__builtin_ctz(m);
+        if (g_dma[ch].cfg.dreq == dreq) paced |= 1u << ch;
+    }
+    return paced;
+}
+
+// 이미 지난 tick은 건너뜀 (busy 채널이 없던 동안)
+static void dma_timer_sync(sim_dma_timer_t *t, uint64_t now_ns) {
+    if (now_ns < t->t0_ns) return;
+    uint64_t k = (uint64_t)((unsigned __int128)(now_ns - t->t0_ns) * t->num * g_sys_hz / ((uint64_t)t->den * 1000000000u));
+    if (k > t->ticks) t->ticks = k;
+}
+
+// ------------ adc ------------
+// 변환 k (1부터) 시각 : t0 + k × max(96, 1 + div) 클럭
+static uint64_t adc_conv_ns(uint64_t k) {
+    uint64_t q8 = 256u + g_adc.div_q8;
+    if (q8 < SIM_ADC_MIN_CYCLES * 256u) q8 = SIM_ADC_MIN_CYCLES * 256u;
+    return g_adc.t0_ns + (uint64_t)((unsigned __int128)k * q8 * 1000000000u / ((uint64_t)SIM_ADC_HZ * 256u));
+}
+
+static void adc_next_input(void) {
+    if (!g_adc.rr_mask) return;
+    do {
+        g_adc.input = (g_adc.input + 1u) % NUM_ADC_CHANNELS;
+    } while (!((g_adc.rr_mask >> g_adc.input) & 1u));
+}
+
+// target_ns까지(포함)의 변환 : 결과를 fifo에 쓰고 DREQ_ADC 채널 전송 (채널이 없어도 변환/입력 순서는 진행)
+static void adc_run_until(uint64_t target_ns) {
+    if (!g_adc.running) return;
+    for (;;) {
+        uint32_t paced = dma_paced(DREQ_ADC);
+        if (adc_conv_ns(g_adc.conv + 1u) > target_ns) break;
+        g_adc.conv++;
+        g_adc_hw.result = g_adc.value[g_adc.input];
+        g_adc_hw.fifo = g_adc_hw.result;
+        adc_next_input();
+        while (paced) {
+            uint ch = (uint)__builtin_ctz(paced);
+            paced &= paced - 1u;
+            dma_transfer(ch);
+        }
+    }
+}
+
+// ------------ pio ------------
+#define PIO_INSTR_IN_PINS       0x4000u     // IN, source = PINS
+#define PIO_INSTR_IN_MASK       0xe0e0u     // opcode + source
+
+static uint pio_index(PIO pio) {
+    return (uint)(pio - sim_pio_hw);
+}
+
+static uint pio_rx_depth(const sim_pio_sm_t *m) {
+    return m->cfg.fifo_join == PIO_FIFO_JOIN_RX ? 2u * SIM_PIO_RX_DEPTH : SIM_PIO_RX_DEPTH;
+}
+
+// SM 클럭 k 시각 : t0 + k × clkdiv 클럭
+static uint64_t pio_clk_ns(const sim_pio_sm_t *m, uint64_t k) {
+    return m->t0_ns + (uint64_t)((unsigned __int128)k * m->cfg.clkdiv_q8 * 1000000000u / ((uint64_t)g_sys_hz * 256u));
+}
+
+// in pins, n : in_base부터 n핀 (32핀 회전)
+static void pio_in_pins(sim_pio_sm_t *m, uint n) {
+    uint32_t all = gpio_get_all();
+    uint b = m->cfg.in_base;
+    uint32_t pins = b ? (all >> b) | (all << (32u - b)) : all;
+    uint32_t v = n < 32u ? pins & ((1u << n) - 1u) : pins;
+    if (n >= 32u)                  m->isr = v;
+    else if (m->cfg.in_shift_right) m->isr = (m->isr >> n) | (v << (32u - n));
+    else                           m->isr = (m->isr << n) | v;
+    m->isr_count += n;
+    if (m->isr_count > 32u) m->isr_count = 32u;
+
+    if (m->cfg.autopush && m->isr_count >= m->cfg.push_threshold) {
+        if (m->rx_wr - m->rx_rd < pio_rx_depth(m)) {
+            m->rx[m->rx_wr % (2u * SIM_PIO_RX_DEPTH)] = m->isr;
+            m->rx_wr++;
+        }
+        m->isr = 0;
+        m->isr_count = 0;
+    }
+}
+
+// RX FIFO → 그 DREQ인 busy DMA 채널 (word마다 1회)
+static void pio_rx_dma(uint p, uint sm) {
+    sim_pio_sm_t *m = &g_pio[p].sm[sm];
+    uint dreq = pio_get_dreq(&sim_pio_hw[p], sm, false);
+    while (m->rx_rd != m->rx_wr) {
+        uint32_t paced = dma_paced(dreq);
+        if (!paced) return;
+        sim_pio_hw[p].rxf[sm] = m->rx[m->rx_rd % (2u * SIM_PIO_RX_DEPTH)];
+        m->rx_rd++;
+        dma_transfer((uint)__builtin_ctz(paced));
+    }
+}
+
+// target_ns까지(포함)의 SM 명령 실행
+static void pio_run_until(uint64_t target_ns) {
+    if (!g_pio_running) return;
+    for (uint p = 0; p < NUM_PIOS; p++) {
+        for (uint sm = 0; sm < NUM_PIO_STATE_MACHINES; sm++) {
+            sim_pio_sm_t *m = &g_pio[p].sm[sm];
+            if (!m->running) continue;
+            for (;;) {
+                if (pio_clk_ns(m, m->clk + 1u) > target_ns) break;
+                uint16_t instr = g_pio[p].instr[m->pc];
+                uint n = instr & 0x1fu;
+                pio_in_pins(m, n ? n : 32u);
+                pio_rx_dma(p, sm);
+                m->clk += 1u + ((instr >> 8) & 0x1fu);
+                m->pc = m->pc == m->cfg.wrap ? m->cfg.wrap_target : (m->pc + 1u) % PIO_INSTRUCTION_COUNT;
+            }
+        }
+    }
+}
+
+// target_us까지(포함)의 timer tick / ADC 변환 / PIO 샘플 전송 (핀 레벨은 그 사이 바뀌지 않음 : plant/core는 target 시각에 실행)
+static void dma_run_until(uint64_t target_us) {
+    uint64_t target_ns = target_us * 1000u;
+    adc_run_until(target_ns);
+    pio_run_until(target_ns);
+    if (!g_dma_busy) return;
+    for (uint i = 0; i < NUM_DMA_TIMERS; i++) {
+        sim_dma_timer_t *t = &g_dma_timer[i];
+        if (!t->running) continue;
+        uint dreq = dma_get_timer_dreq(i);
+
+        for (;;) {
+            // 전송할 채널이 없으면 tick을 세지 않음 (채널 시작 때 dma_channel_start가 그 시각으로 맞춤)
+            uint32_t paced = dma_paced(dreq);
+            if (!paced) break;
+            if (dma_tick_ns(t, t->ticks + 1u) > target_ns) break;
+            t->ticks++;
+            while (paced) {
+                uint ch = (uint)__builtin_ctz(paced);
+                paced &= paced - 1u;
+                dma_transfer(ch);
+            }
+        }
+    }
+}
+
+// IRQ가 켜진 채널이 다음에 끝나는 시각 (µs 올림, 완료 IRQ를 제 시각에 실행하도록 advance_to가 거기서 멈춤)
+static uint64_t dma_next_irq_us(void) {
+    uint64_t next = SIM_NEVER;
+    for (uint32_t m = g_dma_busy & (g_dma_inte[0] | g_dma_inte[1]); m; m &= m - 1u) {
+        uint ch = (uint)__builtin_ctz(m);
+        const sim_dma_ch_t *c = &g_dma[ch];
+        if (c->cfg.dreq < DREQ_DMA_TIMER0 || c->cfg.dreq >= DREQ_DMA_TIMER0 + NUM_DMA_TIMERS) continue;
+        const sim_dma_timer_t *t = &g_dma_timer[c->cfg.dreq - DREQ_DMA_TIMER0];
+        if (!t->running) continue;
+        uint64_t us = (dma_tick_ns(t, t->ticks + g_dma_hw[ch].transfer_count) + 999u) / 1000u;
+        if (us < next) next = us;
+    }
+    return next;
+}
+
+// 이 core에서 지금 실행할 DMA IRQ 번호, 없으면 -1
+static int dma_irq_ready(uint core) {
+    for (uint n = 0; n < 2u; n++) {
+        uint num = DMA_IRQ_0 + n;
+        if (((g_irq_enabled[core] >> num) & 1u) && g_irq_handler[num] && (g_dma_intr & g_dma_inte[n])) return (int)num;
+    }
+    return -1;
+}
+
+// level IRQ : handler가 bit를 지울 때까지 (인터럽트 비활성 core는 restore_interrupts 때)
+static void fire_dma_irqs_on(uint core) {
+    uint32_t runs = 0;
+    int num;
+    while (!g_irq_disabled[core] && (num = dma_irq_ready(core)) >= 0) {
+        if (++runs > SIM_IRQ_ACK_MAX) {
+            fprintf(stderr, "sim: irq %d not acknowledged on core %u\n", num, core);
+            g_stop = true;
+            return;
+        }
+        uint saved = t_core;
+        bool saved_in_irq = g_in_irq[core];
+        t_core = core;
+        g_in_irq[core] = true;
+        g_irq_seq[core]++;
+        g_irq_handler[num]();
+        g_in_irq[core] = saved_in_irq;
+        t_core = saved;
+    }
+}
+
+static void fire_dma_irqs(void) {
+    if (!(g_dma_intr & (g_dma_inte[0] | g_dma_inte[1]))) return;
+    for (uint c = 0; c < SIM_NUM_CORES; c++) fire_dma_irqs_on(c);
+}
+
+// ------------ core scheduling ------------
+static void core_exit(void) {
+    g_cores[t_core].active = false;
+    g_baton = -1;
+    for (uint c = 0; c < SIM_NUM_CORES; c++) pthread_cond_signal(&g_cond[c]);
+    pthread_mutex_unlock(&g_lock);
+    pthread_exit(NULL);
+}
+
+// 가장 먼저 깨어날 core (동률이면 현재 core 우선)
+static uint pick_core(void) {
+    uint best = t_core;
+    for (uint c = 0; c < SIM_NUM_CORES; c++) {
+        if (!g_cores[c].active) continue;
+        if (g_cores[c].wake_us < g_cores[best].wake_us) best = c;
+    }
+    return best;
+}
+
+static void handoff(uint core) {
+    g_baton = (int)core;
+    pthread_cond_signal(&g_cond[core]);
+    while (g_baton != (int)t_core && !g_stop) {
+        pthread_cond_wait(&g_cond[t_core], &g_lock);
+    }
+    if (g_stop) core_exit();
+}
+
+// 현재 core를 target까지 재움. 그 사이 plant/alarm/다른 core를 시간 순서대로 실행
+static void advance_to(uint64_t target_us) {
+    g_cores[t_core].wake_us = target_us;
+
+    for (;;) {
+        if (g_stop) core_exit();
+
+        uint core = pick_core();
+        uint64_t next = g_cores[core].wake_us;
+        if (g_plant && g_plant_next_us < next) next = g_plant_next_us;
+        if (g_alarm_next_us < next) next = g_alarm_next_us;
+        uint64_t dma_next = dma_next_irq_us();
+        if (dma_next < next) next = dma_next;
+        if (next == SIM_NEVER) {
+            // 모든 core가 FIFO 대기 + 예정된 이벤트 없음
+            fprintf(stderr, "sim: deadlock at %llu us\n", (unsigned long long)g_now_us);
+            g_stop = true;
+            core_exit();
+        }
+        if (next > g_now_us) {
+            dma_run_until(next);
+            g_now_us = next;
+        }
+
+        if (g_plant && g_now_us >= g_plant_next_us) {
+            g_plant_next_us = g_plant(g_now_us);
+        }
+        fire_due_alarms();
+        fire_dma_irqs();
+        if (g_stop) core_exit();
+
+        if (g_cores[core].wake_us <= g_now_us) {
+            if (core == t_core) return;
+            handoff(core);
+        }
+    }
+}
+
+// ------------ gpio ------------
+void gpio_init(uint gpio) {
+    sim_pin_t *p = &g_pins[gpio];
+    p->out = false;
+    if (!p->driven) pin_set_level(gpio, false);
+    memset(p->irq_mask, 0, sizeof(p->irq_mask));
+    memset(p->pending, 0, sizeof(p->pending));
+    g_io_bank0.proc0_irq_ctrl.inte[gpio >> 3] &= ~(0xfu << (4u * (gpio & 7u)));
+    g_io_bank0.proc1_irq_ctrl.inte[gpio >> 3] &= ~(0xfu << (4u * (gpio & 7u)));
+}
+
+void gpio_set_dir(uint gpio, bool out) {
+    g_pins[gpio].out = out;
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn) {
+    (void)gpio;
+    (void)fn;
+}
+
+void gpio_pull_up(uint gpio) {
+    if (!g_pins[gpio].driven) pin_set_level(gpio, true);
+}
+
+void gpio_pull_down(uint gpio) {
+    if (!g_pins[gpio].driven) pin_set_level(gpio, false);
+}
+
+void gpio_put(uint gpio, bool value) {
+    if (g_pins[gpio].out) pin_set_level(gpio, value);
+}
+
+bool gpio_get(uint gpio) {
+    return g_pins[gpio].level;
+}
+
+uint32_t gpio_get_all(void) {
+    return g_levels;
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t events, bool enabled) {
+    // SDK와 같이 예전 latch를 먼저 지움 (켜자마자 지난 엣지로 IRQ가 들어오지 않게)
+    gpio_acknowledge_irq(gpio, events);
+    if (enabled) g_pins[gpio].irq_mask[t_core] |= events;
+    else         g_pins[gpio].irq_mask[t_core] &= ~events;
+
+    io_irq_ctrl_hw_t *ctrl = t_core ? &g_io_bank0.proc1_irq_ctrl : &g_io_bank0.proc0_irq_ctrl;
+    uint shift = 4u * (gpio & 7u);
+    ctrl->inte[gpio >> 3] = (ctrl->inte[gpio >> 3] & ~(0xfu << shift)) | ((g_pins[gpio].irq_mask[t_core] & 0xfu) << shift);
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events, bool enabled, gpio_irq_callback_t callback) {
+    gpio_set_irq_enabled(gpio, events, enabled);
+    if (enabled) g_irq_callback[t_core] = callback;
+}
+
+void gpio_acknowledge_irq(uint gpio, uint32_t events) {
+    g_io_bank0.intr[gpio >> 3] &= ~((events & (GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL)) << (4u * (gpio & 7u)));
+}
+
+// ------------ pwm ------------
+uint pwm_gpio_to_slice_num(uint gpio) {
+    return (gpio >> 1u) & 7u;
+}
+
+uint pwm_gpio_to_channel(uint gpio) {
+    return gpio & 1u;
+}
+
+void pwm_set_wrap(uint slice_num, uint16_t wrap) {
+    (void)slice_num;
+    (void)wrap;
+}
+
+void pwm_set_clkdiv(uint slice_num, float divider) {
+    (void)slice_num;
+    (void)divider;
+}
+
+void pwm_set_gpio_level(uint gpio, uint16_t level) {
+    volatile uint32_t *cc = &g_pwm.slice[pwm_gpio_to_slice_num(gpio)].cc;
+    uint shift = pwm_gpio_to_channel(gpio) ? PWM_CH0_CC_B_LSB : 0u;
+    *cc = (*cc & ~(0xffffu << shift)) | ((uint32_t)level << shift);
+}
+
+void pwm_set_enabled(uint slice_num, bool enabled) {
+    (void)slice_num;
+    (void)enabled;
+}
+
+// ------------ adc ------------
+void adc_init(void) {
+    uint16_t value[NUM_ADC_CHANNELS];
+    memcpy(value, g_adc.value, sizeof(value));
+    g_adc = (sim_adc_t){ 0 };
+    memcpy(g_adc.value, value, sizeof(value));
+    g_adc_hw = (adc_hw_t){ 0 };
+}
+
+void adc_gpio_init(uint gpio) {
+    (void)gpio;
+}
+
+void adc_select_input(uint input) {
+    if (input < NUM_ADC_CHANNELS) g_adc.input = input;
+}
+
+void adc_set_round_robin(uint input_mask) {
+    g_adc.rr_mask = input_mask & ((1u << NUM_ADC_CHANNELS) - 1u);
+}
+
+void adc_fifo_setup(bool en, bool dreq_en, uint16_t dreq_thresh, bool err_in_fifo, bool byte_shift) {
+    (void)en;
+    (void)dreq_en;
+    (void)dreq_thresh;
+    (void)err_in_fifo;
+    (void)byte_shift;
+}
+
+void adc_set_clkdiv(float clkdiv) {
+    g_adc.div_q8 = (uint32_t)(clkdiv * 256.0f);
+    g_adc_hw.div = g_adc.div_q8;
+}
+
+void adc_run(bool run) {
+    if (run && !g_adc.running) {
+        g_adc.t0_ns = g_now_us * 1000u;
+        g_adc.conv = 0;
+    }
+    g_adc.running = run;
+}
+
+void adc_fifo_drain(void) {
+}
+
+// ------------ pio ------------
+bool pio_can_add_program(PIO pio, const pio_program_t *program) {
+    const sim_pio_t *p = &g_pio[pio_index(pio)];
+    uint32_t mask = (1u << program->length) - 1u;
+    if (program->origin >= 0) return !(p->used & (mask << program->origin));
+    for (int at = (int)(PIO_INSTRUCTION_COUNT - program->length); at >= 0; at--) {
+        if (!(p->used & (mask << at))) return true;
+    }
+    return false;
+}
+
+// SDK처럼 위쪽부터 빈 자리 (origin이 있으면 거기), 자리가 없으면 중지
+uint pio_add_program(PIO pio, const pio_program_t *program) {
+    sim_pio_t *p = &g_pio[pio_index(pio)];
+    uint32_t mask = (1u << program->length) - 1u;
+    int at = program->origin;
+    if (at < 0) {
+        for (at = (int)(PIO_INSTRUCTION_COUNT - program->length); at >= 0; at--) {
+            if (!(p->used & (mask << at))) break;
+        }
+    }
+    if (at < 0 || (p->used & (mask << at))) {
+        fprintf(stderr, "sim: no room for pio program\n");
+        sim_stop();
+        return 0;
+    }
+    for (uint i = 0; i < program->length; i++) p->instr[(uint)at + i] = program->instructions[i];
+    p->used |= mask << at;
+    return (uint)at;
+}
+
+int pio_claim_unused_sm(PIO pio, bool required) {
+    sim_pio_t *p = &g_pio[pio_index(pio)];
+    for (uint sm = 0; sm < NUM_PIO_STATE_MACHINES; sm++) {
+        if (!p->sm[sm].claimed) {
+            p->sm[sm].claimed = true;
+            return (int)sm;
+        }
+    }
+    if (required) {
+        fprintf(stderr, "sim: no free pio sm\n");
+        sim_stop();
+    }
+    return -1;
+}
+
+void pio_sm_unclaim(PIO pio, uint sm) {
+    g_pio[pio_index(pio)].sm[sm] = (sim_pio_sm_t){ 0 };
+}
+
+uint pio_get_index(PIO pio) {
+    return pio_index(pio);
+}
+
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx) {
+    uint base = pio_index(pio) ? DREQ_PIO1_TX0 : DREQ_PIO0_TX0;
+    return base + (is_tx ? 0u : DREQ_PIO0_RX0 - DREQ_PIO0_TX0) + sm;
+}
+
+pio_sm_config pio_get_default_sm_config(void) {
+    return (pio_sm_config){
+        .clkdiv_q8 = 256u,
+        .wrap_target = 0,
+        .wrap = PIO_INSTRUCTION_COUNT - 1u,
+        .in_shift_right = true,
+        .push_threshold = 32,
+    };
+}
+
+void sm_config_set_wrap(pio_sm_config *c, uint wrap_target, uint wrap) {
+    c->wrap_target = (uint8_t)wrap_target;
+    c->wrap = (uint8_t)wrap;
+}
+
+void sm_config_set_in_pins(pio_sm_config *c, uint in_base) {
+    c->in_base = (uint8_t)(in_base & 31u);
+}
+
+void sm_config_set_in_shift(pio_sm_config *c, bool shift_right, bool autopush, uint push_threshold) {
+    c->in_shift_right = shift_right;
+    c->autopush = autopush;
+    c->push_threshold = (uint8_t)(push_threshold ? push_threshold : 32u);
+}
+
+void sm_config_set_fifo_join(pio_sm_config *c, enum pio_fifo_join join) {
+    c->fifo_join = (uint8_t)join;
+}
+
+void sm_config_set_clkdiv_int_frac(pio_sm_config *c, uint16_t div_int, uint8_t div_frac) {
+    // div_int 0 = 65536
+    c->clkdiv_q8 = ((div_int ? (uint32_t)div_int : 65536u) << 8) | div_frac;
+}
+
+void pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config) {
+    sim_pio_sm_t *m = &g_pio[pio_index(pio)].sm[sm];
+    if (m->running) g_pio_running--;
+    m->running = false;
+    m->cfg = *config;
+    m->pc = initial_pc;
+    m->isr = 0;
+    m->isr_count = 0;
+    m->rx_rd = m->rx_wr = 0;
+}
+
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled) {
+    sim_pio_t *p = &g_pio[pio_index(pio)];
+    sim_pio_sm_t *m = &p->sm[sm];
+    if (enabled && !m->running) {
+        // wrap 구간이 모두 "in pins"인지
+        for (uint pc = m->cfg.wrap_target;; pc = (pc + 1u) % PIO_INSTRUCTION_COUNT) {
+            if ((p->instr[pc] & PIO_INSTR_IN_MASK) != PIO_INSTR_IN_PINS) {
+                fprintf(stderr, "sim: pio%u sm%u: only 'in pins' is modeled (0x%04x at %u)\n",
+                        pio_index(pio), sm, p->instr[pc], pc);
+                return;
+            }
+            if (pc == m->cfg.wrap) break;
+        }
+        m->t0_ns = g_now_us * 1000u;
+        m->clk = 0;
+    }
+    if (enabled != m->running) {
+        if (enabled) g_pio_running++;
+        else         g_pio_running--;
+    }
+    m->running = enabled;
+}
+
+// ------------ dma ------------
+int dma_claim_unused_channel(bool required) {
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ch++) {
+        if (!g_dma[ch].claimed) {
+            g_dma[ch].claimed = true;
+            return (int)ch;
+        }
+    }
+    if (required) {
+        fprintf(stderr, "sim: no free dma channel\n");
+        sim_stop();
+    }
+    return -1;
+}
+
+void dma_channel_unclaim(uint channel) {
+    g_dma[channel].claimed = false;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    return (dma_channel_config){
+        .size = DMA_SIZE_32,
+        .read_incr = true,
+        .write_incr = false,
+        .dreq = DREQ_FORCE,
+        .chain_to = (uint8_t)channel,
+        .enable = true,
+    };
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) {
+    c->size = (uint8_t)size;
+}
+
+void channel_config_set_read_increment(dma_channel_config *c, bool incr) {
+    c->read_incr = incr;
+}
+
+void channel_config_set_write_increment(dma_channel_config *c, bool incr) {
+    c->write_incr = incr;
+}
+
+void channel_config_set_ring(dma_channel_config *c, bool write, uint size_bits) {
+    c->ring_write = write;
+    c->ring_bits = (uint8_t)size_bits;
+}
+
+void channel_config_set_dreq(dma_channel_config *c, uint dreq) {
+    c->dreq = (uint8_t)dreq;
+}
+
+void channel_config_set_chain_to(dma_channel_config *c, uint chain_to) {
+    c->chain_to = (uint8_t)chain_to;
+}
+
+void channel_config_set_enable(dma_channel_config *c, bool enable) {
+    c->enable = enable;
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger) {
+    g_dma[channel].cfg = *config;
+    g_dma[channel].reload = transfer_count;
+    g_dma_hw[channel].write_addr = (uintptr_t)write_addr;
+    g_dma_hw[channel].read_addr = (uintptr_t)read_addr;
+    g_dma_hw[channel].transfer_count = transfer_count;
+    if (trigger) dma_channel_start(channel);
+}
+
+void dma_channel_start(uint channel) {
+    sim_dma_ch_t *c = &g_dma[channel];
+    if (!c->cfg.enable || c->reload == 0) return;
+    g_dma_hw[channel].transfer_count = c->reload;
+    g_dma_busy |= 1u << channel;
+
+    if (c->cfg.dreq == DREQ_FORCE) {
+        while ((g_dma_busy >> channel) & 1u) dma_transfer(channel);
+    } else if (c->cfg.dreq >= DREQ_DMA_TIMER0 && c->cfg.dreq < DREQ_DMA_TIMER0 + NUM_DMA_TIMERS) {
+        // 지난 tick에 전송하지 않게 (첫 전송은 다음 tick)
+        sim_dma_timer_t *t = &g_dma_timer[c->cfg.dreq - DREQ_DMA_TIMER0];
+        if (t->running) dma_timer_sync(t, g_now_us * 1000u);
+    }
+}
+
+void dma_channel_abort(uint channel) {
+    g_dma_busy &= ~(1u << channel);
+    g_dma_hw[channel].transfer_count = 0;
+}
+
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count) {
+    g_dma[channel].reload = transfer_count;
+    g_dma_hw[channel].read_addr = (uintptr_t)read_addr;
+    dma_channel_start(channel);
+}
+
+bool dma_channel_is_busy(uint channel) {
+    return (g_dma_busy >> channel) & 1u;
+}
+
+dma_channel_hw_t *dma_channel_hw_addr(uint channel) {
+    return &g_dma_hw[channel];
+}
+
+int dma_claim_unused_timer(bool required) {
+    for (uint i = 0; i < NUM_DMA_TIMERS; i++) {
+        if (!g_dma_timer[i].claimed) {
+            g_dma_timer[i].claimed = true;
+            return (int)i;
+        }
+    }
+    if (required) {
+        fprintf(stderr, "sim: no free dma timer\n");
+        sim_stop();
+    }
+    return -1;
+}
+
+void dma_timer_unclaim(uint timer) {
+    g_dma_timer[timer] = (sim_dma_timer_t){ 0 };
+}
+
+void dma_timer_set_fraction(uint timer, uint16_t numerator, uint16_t denominator) {
+    sim_dma_timer_t *t = &g_dma_timer[timer];
+    t->num = numerator;
+    t->den = denominator;
+    t->running = numerator != 0 && denominator != 0;
+    t->t0_ns = g_now_us * 1000u;
+    t->ticks = 0;
+}
+
+uint dma_get_timer_dreq(uint timer_num) {
+    return DREQ_DMA_TIMER0 + timer_num;
+}
+
+static void dma_set_irq_enabled(uint n, uint channel, bool enabled) {
+    if (enabled) g_dma_inte[n] |= 1u << channel;
+    else         g_dma_inte[n] &= ~(1u << channel);
+}
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled) {
+    dma_set_irq_enabled(0, channel, enabled);
+}
+
+void dma_channel_set_irq1_enabled(uint channel, bool enabled) {
+    dma_set_irq_enabled(1, channel, enabled);
+}
+
+bool dma_channel_get_irq0_status(uint channel) {
+    return ((g_dma_intr & g_dma_inte[0]) >> channel) & 1u;
+}
+
+bool dma_channel_get_irq1_status(uint channel) {
+    return ((g_dma_intr & g_dma_inte[1]) >> channel) & 1u;
+}
+
+// raw bit는 하나 (INTS0/INTS1 어느 쪽에 써도 같이 지워짐)
+void dma_channel_acknowledge_irq0(uint channel) {
+    g_dma_intr &= ~(1u << channel);
+}
+
+void dma_channel_acknowledge_irq1(uint channel) {
+    g_dma_intr &= ~(1u << channel);
+}
+
+// ------------ irq ------------
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) {
+    if (num < SIM_NUM_IRQS) g_irq_handler[num] = handler;
+}
+
+void irq_set_enabled(uint num, bool enabled) {
+    if (num >= SIM_NUM_IRQS) return;
+    if (enabled) g_irq_enabled[t_core] |= 1u << num;
+    else         g_irq_enabled[t_core] &= ~(1u << num);
+}
+
+// ------------ clocks / time ------------
+bool set_sys_clock_khz(uint32_t freq_khz, bool required) {
+    (void)required;
+    g_sys_hz = freq_khz * 1000u;
+    return true;
+}
+
+uint32_t clock_get_hz(enum clock_index clk_index) {
+    if (clk_index == clk_sys) return g_sys_hz;
+    return clk_index == clk_adc ? SIM_ADC_HZ : 12000000u;
+}
+
+uint64_t time_us_64(void) {
+    return g_now_us;
+}
+
+uint32_t time_us_32(void) {
+    return (uint32_t)g_now_us;
+}
+
+absolute_time_t get_absolute_time(void) {
+    return g_now_us;
+}
+
+void sleep_us(uint64_t us) {
+    advance_to(g_now_us + us);
+}
+
+void sleep_ms(uint32_t ms) {
+    advance_to(g_now_us + (uint64_t)ms * 1000u);
+}
+
+void busy_wait_us(uint64_t us) {
+    advance_to(g_now_us + us);
+}
+
+void busy_wait_ms(uint32_t ms) {
+    advance_to(g_now_us + (uint64_t)ms * 1000u);
+}
+
+void tight_loop_contents(void) {
+    advance_to(g_now_us + SIM_LOOP_COST_US);
+}
+
+// ------------ alarm ------------
+alarm_pool_t *alarm_pool_get_default(void) {
+    return &g_pools[0];
+}
+
+alarm_pool_t *alarm_pool_create_with_unused_hardware_alarm(uint max_timers) {
+    (void)max_timers;
+    if (g_pool_count >= SIM_MAX_POOLS) return NULL;
+    alarm_pool_t *pool = &g_pools[g_pool_count++];
+    pool->core = t_core;
+    return pool;
+}
+
+alarm_id_t alarm_pool_add_alarm_at(alarm_pool_t *pool, absolute_time_t time, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    uint64_t at = to_us_since_boot(time);
+
+    if (at <= g_now_us) {
+        if (!fire_if_past) return 0;
+        // SDK와 같이 add 호출 안에서 바로 실행, 재예약 요청 시에만 슬롯 사용
+        uint saved = t_core;
+        t_core = pool->core;
+        int64_t ret = callback(0, user_data);
+        t_core = saved;
+        if (ret == 0) return 0;
+        at = ret > 0 ? g_now_us + (uint64_t)ret : at + (uint64_t)(-ret);
+    }
+
+    for (int i = 0; i < SIM_MAX_ALARMS; i++) {
+        sim_alarm_t *a = &g_alarms[i];
+        if (a->id != 0) continue;
+        g_alarm_used |= 1u << i;
+        a->id = g_next_alarm_id++;
+        if (g_next_alarm_id <= 0) g_next_alarm_id = 1;
+        a->at_us = at;
+        a->callback = callback;
+        a->user_data = user_data;
+        a->core = pool->core;
+        if (alarm_ready(a) && at < g_alarm_next_us) g_alarm_next_us = at;
+        return a->id;
+    }
+    return -1;
+}
+
+alarm_id_t alarm_pool_add_alarm_in_us(alarm_pool_t *pool, uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    return alarm_pool_add_alarm_at(pool, g_now_us + us, callback, user_data, fire_if_past);
+}
+
+alarm_id_t add_alarm_at(absolute_time_t time, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    return alarm_pool_add_alarm_at(&g_pools[0], time, callback, user_data, fire_if_past);
+}
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    return add_alarm_at(g_now_us + us, callback, user_data, fire_if_past);
+}
+
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    return add_alarm_at(g_now_us + (uint64_t)ms * 1000u, callback, user_data, fire_if_past);
+}
+
+bool cancel_alarm(alarm_id_t alarm_id) {
+    if (alarm_id <= 0) return false;
+    for (int i = 0; i < SIM_MAX_ALARMS; i++) {
+        if (g_alarms[i].id == alarm_id) {
+            g_alarms[i].id = 0;
+            g_alarm_used &= ~(1u << i);
+            update_next_alarm();
+            return true;
+        }
+    }
+    return false;
+}
+
+// ------------ repeating timer ------------
+// SDK와 같이 콜백 반환값을 alarm 재예약 값으로 그대로 사용 (delay_us 부호 = 기준 시점)
+static int64_t repeating_timer_alarm_cb(alarm_id_t id, void *user_data) {
+    repeating_timer_t *rt = (repeating_timer_t *)user_data;
+    rt->alarm_id = id;
+    if (!rt->callback(rt)) {
+        rt->alarm_id = 0;
+        return 0;
+    }
+    return rt->delay_us;
+}
+
+bool alarm_pool_add_repeating_timer_us(alarm_pool_t *pool, int64_t delay_us, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out) {
+    if (delay_us == 0) delay_us = 1;
+    out->delay_us = delay_us;
+    out->pool = pool;
+    out->callback = callback;
+    out->user_data = user_data;
+    out->alarm_id = alarm_pool_add_alarm_in_us(pool, (uint64_t)(delay_us < 0 ? -delay_us : delay_us),
+                                               repeating_timer_alarm_cb, out, true);
+    return out->alarm_id > 0;
+}
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out) {
+    return alarm_pool_add_repeating_timer_us(&g_pools[0], delay_us, callback, user_data, out);
+}
+
+bool add_repeating_timer_ms(int32_t delay_ms, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out) {
+    return add_repeating_timer_us((int64_t)delay_ms * 1000, callback, user_data, out);
+}
+
+bool cancel_repeating_timer(repeating_timer_t *timer) {
+    bool ok = cancel_alarm(timer->alarm_id);
+    timer->alarm_id = 0;
+    return ok;
+}
+
+// ------------ sync ------------
+uint32_t save_and_disable_interrupts(void) {
+    uint32_t prev = g_irq_disabled[t_core] ? 1u : 0u;
+    g_irq_disabled[t_core] = true;
+    return prev;
+}
+
+int spin_lock_claim_unused(bool required) {
+    for (uint i = 0; i < SIM_NUM_SPIN_LOCKS; i++) {
+        if (!(g_spin_claimed & (1u << i))) {
+            g_spin_claimed |= 1u << i;
+            return (int)i;
+        }
+    }
+    if (required) {
+        fprintf(stderr, "sim: no spin lock\n");
+        exit(2);
+    }
+    return -1;
+}
+
+spin_lock_t *spin_lock_init(uint lock_num) {
+    g_spin_locks[lock_num] = 0;
+    return &g_spin_locks[lock_num];
+}
+
+uint32_t spin_lock_blocking(spin_lock_t *lock) {
+    uint32_t irq_state = save_and_disable_interrupts();
+    if (*lock) fprintf(stderr, "sim: spin lock %u already held\n", (unsigned)(lock - g_spin_locks));
+    *lock = 1u;
+    return irq_state;
+}
+
+void spin_unlock(spin_lock_t *lock, uint32_t saved_irq) {
+    *lock = 0;
+    restore_interrupts(saved_irq);
+}
+
+void restore_interrupts(uint32_t status) {
+    g_irq_disabled[t_core] = (status != 0);
+    if (g_irq_disabled[t_core]) return;
+    // IRQ 콜백 안이면 보류된 IRQ는 콜백이 끝난 뒤에 (restore_interrupts로 자기 자신이 다시 불리지 않게)
+    // 인터럽트 비활성 중 추가된 alarm은 다음 시각 계산에만 넣음
+    if (g_in_irq[t_core]) {
+        update_next_alarm();
+        return;
+    }
+
+    for (uint i = 0; i < NUM_BANK0_GPIOS; i++) {
+        uint32_t ev = g_pins[i].pending[t_core];
+        if (ev == 0) continue;
+        g_pins[i].pending[t_core] = 0;
+        g_irq_seq[t_core]++;
+        if (g_irq_callback[t_core]) g_irq_callback[t_core](i, ev);
+    }
+    fire_dma_irqs_on(t_core);
+
+    // 보류된 alarm 다시 계산, 이미 지난 것은 바로 실행
+    update_next_alarm();
+    fire_due_alarms();
+}
+
+// 인터럽트 비활성 중 보류된 IRQ (GPIO pending, DMA 완료, 시각이 지난 alarm)
+static bool core_irq_pending(uint core) {
+    for (uint i = 0; i < NUM_BANK0_GPIOS; i++) {
+        if (g_pins[i].pending[core]) return true;
+    }
+    if (dma_irq_ready(core) >= 0) return true;
+    for (int i = 0; i < SIM_MAX_ALARMS; i++) {
+        if (g_alarms[i].id != 0 && g_alarms[i].core == core && g_alarms[i].at_us <= g_now_us) return true;
+    }
+    return false;
+}
+
+// 이 core의 다음 alarm 시각 (인터럽트 비활성이어도 포함)
+static uint64_t core_next_alarm(uint core) {
+    uint64_t t = SIM_NEVER;
+    for (int i = 0; i < SIM_MAX_ALARMS; i++) {
+        if (g_alarms[i].id != 0 && g_alarms[i].core == core && g_alarms[i].at_us < t) t = g_alarms[i].at_us;
+    }
+    return t;
+}
+
+// IRQ가 실행되었거나(인터럽트 활성) 보류 중(비활성)일 때까지 시간을 다음 이벤트 단위로 진행
+#define SIM_WFI_MAX_STEP_US     1000u
+
+void __wfi(void) {
+    uint core = t_core;
+    uint32_t seq = g_irq_seq[core];
+
+    while (g_irq_seq[core] == seq && !core_irq_pending(core)) {
+        uint64_t next = core_next_alarm(core);
+        if (g_plant && g_plant_next_us < next) next = g_plant_next_us;
+        if (next > g_now_us + SIM_WFI_MAX_STEP_US) next = g_now_us + SIM_WFI_MAX_STEP_US;
+        if (next <= g_now_us) next = g_now_us + 1u;
+        advance_to(next);
+    }
+}
+
+// ------------ multicore ------------
+uint get_core_num(void) {
+    return t_core;
+}
+
+static void *core1_thread(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&g_lock);
+    t_core = 1;
+    while (g_baton != 1 && !g_stop) {
+        pthread_cond_wait(&g_cond[1], &g_lock);
+    }
+    if (!g_stop) g_cores[1].entry();
+    core_exit();
+    return NULL;
+}
+
+void multicore_launch_core1(void (*entry)(void)) {
+    sim_core_t *c = &g_cores[1];
+    c->entry = entry;
+    c->wake_us = g_now_us;
+    c->active = true;
+    if (pthread_create(&c->thread, NULL, core1_thread, NULL) != 0) {
+        fprintf(stderr, "sim: core1 thread create failed\n");
+        c->active = false;
+        c->entry = NULL;
+    }
+}
+
+bool multicore_fifo_rvalid(void) {
+    sim_fifo_t *f = &g_fifo[t_core];
+    return f->head != f->tail;
+}
+
+bool multicore_fifo_wready(void) {
+    sim_fifo_t *f = &g_fifo[t_core ^ 1u];
+    return f->head - f->tail < SIM_FIFO_DEPTH;
+}
+
+// 상대 core가 WFE 대기 중이면 지금 시각에 깨움 (SDK: FIFO push / queue 갱신 후 __sev)
+static void sim_sev(void) {
+    sim_core_t *other = &g_cores[t_core ^ 1u];
+    if (other->wfe_wait) other->wake_us = g_now_us;
+}
+
+// __wfe : 상대 core의 __sev까지 재움
+static void sim_wfe(void) {
+    g_cores[t_core].wfe_wait = true;
+    advance_to(SIM_NEVER);
+    g_cores[t_core].wfe_wait = false;
+}
+
+void multicore_fifo_push_blocking(uint32_t data) {
+    while (!multicore_fifo_wready()) tight_loop_contents();
+    // lockout victim은 FIFO IRQ handler가 바로 꺼내서 버림 (SDK multicore_lockout_handler)
+    if (!g_lockout_victim[t_core ^ 1u]) {
+        sim_fifo_t *f = &g_fifo[t_core ^ 1u];
+        f->buf[f->head++ % SIM_FIFO_DEPTH] = data;
+    }
+    sim_sev();
+}
+
+// SDK는 __wfe로 대기 → 여기서는 push가 올 때까지 core를 재움
+uint32_t multicore_fifo_pop_blocking(void) {
+    while (!multicore_fifo_rvalid()) sim_wfe();
+    sim_fifo_t *f = &g_fifo[t_core];
+    return f->buf[f->tail++ % SIM_FIFO_DEPTH];
+}
+
+void multicore_fifo_drain(void) {
+    sim_fifo_t *f = &g_fifo[t_core];
+    f->tail = f->head;
+}
+
+// SDK : 이 core의 FIFO IRQ를 lockout handler가 가져감 (이미 들어와 있던 word도 그 handler가 비움)
+void multicore_lockout_victim_init(void) {
+    g_lockout_victim[t_core] = true;
+    multicore_fifo_drain();
+}
+
+// ------------ queue (pico/util/queue) ------------
+// SDK와 같이 element_count + 1칸 ring, spin lock 대신 baton (한 번에 한 core만 실행)
+void queue_init(queue_t *q, uint element_size, uint element_count) {
+    q->data = calloc(element_count + 1u, element_size);
+    if (!q->data) {
+        fprintf(stderr, "sim: queue alloc failed\n");
+        element_count = 0;
+    }
+    q->element_size = (uint16_t)element_size;
+    q->element_count = (uint16_t)element_count;
+    q->wptr = 0;
+    q->rptr = 0;
+}
+
+void queue_free(queue_t *q) {
+    free(q->data);
+    q->data = NULL;
+}
+
+uint queue_get_level(queue_t *q) {
+    int32_t level = (int32_t)q->wptr - (int32_t)q->rptr;
+    if (level < 0) level += q->element_count + 1;
+    return (uint)level;
+}
+
+static uint queue_next(const queue_t *q, uint16_t ptr) {
+    return ptr + 1u > q->element_count ? 0u : ptr + 1u;
+}
+
+bool queue_try_add(queue_t *q, const void *data) {
+    if (queue_get_level(q) == q->element_count) return false;
+    memcpy(q->data + (size_t)q->wptr * q->element_size, data, q->element_size);
+    q->wptr = (uint16_t)queue_next(q, q->wptr);
+    sim_sev();
+    return true;
+}
+
+bool queue_try_remove(queue_t *q, void *data) {
+    if (q->rptr == q->wptr) return false;
+    memcpy(data, q->data + (size_t)q->rptr * q->element_size, q->element_size);
+    q->rptr = (uint16_t)queue_next(q, q->rptr);
+    sim_sev();
+    return true;
+}
+
+void queue_add_blocking(queue_t *q, const void *data) {
+    while (!queue_try_add(q, data)) sim_wfe();
+}
+
+void queue_remove_blocking(queue_t *q, void *data) {
+    while (!queue_try_remove(q, data)) sim_wfe();
+}
+
+// ------------ flash ------------
+static void flash_init_once(void) {
+    if (g_flash_init) return;
+    g_flash_init = true;
+    memset(sim_flash_mem, 0xff, sizeof(sim_flash_mem));
+}
+
+// NOR flash: erase = 0xFF, program은 1 → 0 만 가능
+void flash_range_erase(uint32_t flash_offs, size_t count) {
+    flash_init_once();
+    if (flash_offs % FLASH_SECTOR_SIZE || count % FLASH_SECTOR_SIZE ||
+        flash_offs + count > PICO_FLASH_SIZE_BYTES) {
+        fprintf(stderr, "sim: bad flash erase 0x%x +%zu\n", flash_offs, count);
+        return;
+    }
+    memset(&sim_flash_mem[flash_offs], 0xff, count);
+    g_flash_erase_count++;
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count) {
+    flash_init_once();
+    if (flash_offs % FLASH_PAGE_SIZE || count % FLASH_PAGE_SIZE ||
+        flash_offs + count > PICO_FLASH_SIZE_BYTES) {
+        fprintf(stderr, "sim: bad flash program 0x%x +%zu\n", flash_offs, count);
+        return;
+    }
+    for (size_t i = 0; i < count; i++) sim_flash_mem[flash_offs + i] &= data[i];
+}
+
+int flash_safe_execute(void (*func)(void *), void *param, uint32_t enter_exit_timeout_ms) {
+    (void)enter_exit_timeout_ms;
+    uint other = t_core ^ 1u;
+    if (g_lockout_victim[other]) {
+        // lockout handshake (multicore_lockout_start_blocking)가 이 core FIFO를 비움 → 그 사이 들어와 있던 word는 사라짐
+        multicore_fifo_drain();
+    } else if (!(PICO_FLASH_ASSUME_CORE1_SAFE && other == 1u)) {
+        return PICO_ERROR_NOT_PERMITTED;
+    }
+    uint32_t irq_state = save_and_disable_interrupts();
+    func(param);
+    restore_interrupts(irq_state);
+    return PICO_OK;
+}
+
+// ------------ uart ------------
+uint uart_init(uart_inst_t *uart, uint baudrate) {
+    sim_uart_t *u = &g_uart[uart->index];
+    u->baud = baudrate;
+    u->byte_ns = baudrate ? (10ull * 1000000000ull + baudrate - 1u) / baudrate : 0;
+    u->tx_free_ns = 0;
+    return baudrate;
+}
+
+void uart_set_format(uart_inst_t *uart, uint data_bits, uint stop_bits, uart_parity_t parity) {
+    (void)uart;
+    (void)data_bits;
+    (void)stop_bits;
+    (void)parity;
+}
+
+void uart_set_fifo_enabled(uart_inst_t *uart, bool enabled) {
+    (void)uart;
+    (void)enabled;
+}
+
+// 아직 선로로 나가지 않은 byte 수 (shift register 포함)
+static uint32_t uart_tx_level(const sim_uart_t *u) {
+    uint64_t now_ns = g_now_us * 1000u;
+    if (u->byte_ns == 0 || u->tx_free_ns <= now_ns) return 0;
+    return (uint32_t)((u->tx_free_ns - now_ns + u->byte_ns - 1u) / u->byte_ns);
+}
+
+bool uart_is_writable(uart_inst_t *uart) {
+    return uart_tx_level(&g_uart[uart->index]) < UART_FIFO_DEPTH;
+}
+
+void uart_putc_raw(uart_inst_t *uart, char c) {
+    sim_uart_t *u = &g_uart[uart->index];
+    while (!uart_is_writable(uart)) advance_to(g_now_us + 1u);
+
+    uint64_t now_ns = g_now_us * 1000u;
+    if (u->tx_free_ns < now_ns) u->tx_free_ns = now_ns;
+    u->tx_free_ns += u->byte_ns;
+    u->tx_count++;
+
+    uint8_t b = (uint8_t)c;
+    if (u->noise_every && u->tx_count % u->noise_every == 0) b ^= 1u;
+    if (u->fd >= 0 && write(u->fd, &b, 1) != 1) {
+        fprintf(stderr, "sim: uart%u write failed\n", uart->index);
+        u->fd = -1;
+    }
+}
+
+void uart_write_blocking(uart_inst_t *uart, const uint8_t *src, size_t len) {
+    for (size_t i = 0; i < len; i++) uart_putc_raw(uart, (char)src[i]);
+}
+
+void uart_tx_wait_blocking(uart_inst_t *uart) {
+    sim_uart_t *u = &g_uart[uart->index];
+    if (u->tx_free_ns > g_now_us * 1000u) advance_to((u->tx_free_ns + 999u) / 1000u);
+}
+
+// ------------ stdio ------------
+bool stdio_init_all(void) {
+    return true;
+}
+
+int getchar_timeout_us(uint32_t timeout_us) {
+    if (g_stdin_head == g_stdin_tail && timeout_us > 0) advance_to(g_now_us + timeout_us);
+    if (g_stdin_head == g_stdin_tail) return PICO_ERROR_TIMEOUT;
+    return (unsigned char)g_stdin[g_stdin_tail++ % SIM_STDIN_SIZE];
+}
+
+// =====================================================================
+// sim API
+// =====================================================================
+
+void sim_reset(void) {
+    flash_init_once();      // flash 내용은 유지 (첫 호출 때만 0xFF로)
+    memset(g_pins, 0, sizeof(g_pins));
+    g_levels = 0;
+    memset(&g_io_bank0, 0, sizeof(g_io_bank0));
+    memset(g_irq_callback, 0, sizeof(g_irq_callback));
+    memset(g_irq_disabled, 0, sizeof(g_irq_disabled));
+    memset(g_irq_seq, 0, sizeof(g_irq_seq));
+    memset(g_in_irq, 0, sizeof(g_in_irq));
+    g_now_us = 0;
+    g_plant = NULL;
+    g_plant_next_us = SIM_NEVER;
+    g_sys_hz = 125000000u;
+    memset(sim_pio_hw, 0, sizeof(sim_pio_hw));
+    memset(g_pio, 0, sizeof(g_pio));
+    g_pio_running = 0;
+    memset(g_dma, 0, sizeof(g_dma));
+    memset(g_dma_hw, 0, sizeof(g_dma_hw));
+    memset(g_dma_timer, 0, sizeof(g_dma_timer));
+    g_dma_busy = 0;
+    g_dma_intr = 0;
+    memset(g_dma_inte, 0, sizeof(g_dma_inte));
+    memset(&g_pwm, 0, sizeof(g_pwm));
+    memset(&g_adc, 0, sizeof(g_adc));
+    memset(&g_adc_hw, 0, sizeof(g_adc_hw));
+    memset(g_irq_handler, 0, sizeof(g_irq_handler));
+    memset(g_irq_enabled, 0, sizeof(g_irq_enabled));
+    memset(g_alarms, 0, sizeof(g_alarms));
+    g_alarm_used = 0;
+    g_next_alarm_id = 1;
+    g_alarm_next_us = SIM_NEVER;
+    memset(g_pools, 0, sizeof(g_pools));
+    g_pool_count = 1;
+    memset(g_cores, 0, sizeof(g_cores));
+    memset(g_fifo, 0, sizeof(g_fifo));
+    memset(g_lockout_victim, 0, sizeof(g_lockout_victim));
+    memset((void *)g_spin_locks, 0, sizeof(g_spin_locks));
+    g_spin_claimed = 0;
+    g_baton = 0;
+    g_stdin_head = g_stdin_tail = 0;
+    for (uint i = 0; i < 2; i++) g_uart[i] = (sim_uart_t){ .fd = -1 };
+    g_stop = false;
+}
+
+void sim_set_plant(sim_plant_fn plant) {
+    g_plant = plant;
+    g_plant_next_us = plant ? g_now_us : SIM_NEVER;
+}
+
+uint64_t sim_now_us(void) {
+    return g_now_us;
+}
+
+void sim_gpio_drive(uint gpio, bool level) {
+    g_pins[gpio].driven = true;
+    set_input_level(gpio, level);
+}
+
+bool sim_gpio_out(uint gpio) {
+    return g_pins[gpio].level;
+}
+
+uint16_t sim_pwm_level(uint gpio) {
+    uint shift = pwm_gpio_to_channel(gpio) ? PWM_CH0_CC_B_LSB : 0u;
+    return (uint16_t)(g_pwm.slice[pwm_gpio_to_slice_num(gpio)].cc >> shift);
+}
+
+void sim_adc_drive(uint input, uint16_t value) {
+    if (input < NUM_ADC_CHANNELS) g_adc.value[input] = value & 0xfffu;
+}
+
+bool sim_flash_load(const char *path) {
+    flash_init_once();
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+    size_t n = fread(sim_flash_mem, 1, sizeof(sim_flash_mem), f);
+    fclose(f);
+    return n == sizeof(sim_flash_mem);
+}
+
+bool sim_flash_save(const char *path) {
+    flash_init_once();
+    FILE *f = fopen(path, "wb");
+    if (!f) return false;
+    size_t n = fwrite(sim_flash_mem, 1, sizeof(sim_flash_mem), f);
+    fclose(f);
+    return n == sizeof(sim_flash_mem);
+}
+
+uint32_t sim_flash_erase_count(void) {
+    return g_flash_erase_count;
+}
+
+void sim_uart_attach(uint index, int fd) {
+    g_uart[index].fd = fd;
+}
+
+void sim_uart_set_noise(uint index, uint32_t noise_every) {
+    g_uart[index].noise_every = noise_every;
+}
+
+uint32_t sim_uart_tx_count(uint index) {
+    return g_uart[index].tx_count;
+}
+
+void sim_stdin_feed(const char *s) {
+    while (*s && g_stdin_head - g_stdin_tail < SIM_STDIN_SIZE) {
+        g_stdin[g_stdin_head++ % SIM_STDIN_SIZE] = *s++;
+    }
+}
+
+static void *core0_thread(void *arg) {
+    int (*entry)(void) = (int (*)(void))arg;
+    pthread_mutex_lock(&g_lock);
+    t_core = 0;
+    entry();
+    // 펌웨어 main이 반환하면 시뮬레이션 종료
+    g_stop = true;
+    core_exit();
+    return NULL;
+}
+
+void sim_run(int (*entry)(void)) {
+    sim_core_t *c0 = &g_cores[0];
+    g_stop = false;
+    g_baton = 0;
+    c0->active = true;
+    c0->wake_us = g_now_us;
+    if (pthread_create(&c0->thread, NULL, core0_thread, (void *)entry) != 0) {
+        fprintf(stderr, "sim: core0 thread create failed\n");
+        return;
+    }
+    pthread_join(c0->thread, NULL);
+
+    // core1은 launch 됐을 때만 join
+    if (g_cores[1].entry) pthread_join(g_cores[1].thread, NULL);
+}
+
+void sim_stop(void) {
+    g_stop = true;
+}
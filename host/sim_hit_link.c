@@ -0,0 +1,324 @@
+#define _XOPEN_SOURCE 600
+#define _DEFAULT_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/*
+HIT UART link 시뮬레이터 (host)
+- 채널 디바운스 펌웨어(DETECT_FW_SRC, 기본 ../1ms_x_5times.c)를 DETECT_HIT_LINK로 빌드해서 include
+- 펌웨어 UART TX(HIT_LINK_UART)를 pty master에 연결, fork한 자식이 pty slave에서 메인 PCB처럼 frame을 받아 검사
+- 입력: 일정 주기(volley)마다 임의 채널 조합에 상승 시각을 조금씩 어긋나게 펄스 → 같은 tick에 확정된 HIT는 frame으로 묶임
+- 검사: CRC, seq 연속, record마다 채널/type/샷 시각(t_us = 입력 상승 시각)이 넣은 펄스와 일치하는지, 누락/오검출
+- 끝나면 펌웨어 통계('s')로 선로 사용률/묶음 크기/대기 시간 출력
+- -c N : N byte마다 bit 1개 반전 → CRC로 걸러지는지 확인 (그 frame의 record는 seq 끊김으로 보임)
+- -p "cmd;..." : 시작 때 stdio로 넣을 파라미터 명령 ("p sample_us 800;p save")
+  p save 기록은 마지막 volley 뒤 조용한 동안 (DETECT_SAVE_QUIET_MS) → 그만큼 더 돌림
+*/
+
+#ifndef DETECT_FW_SRC
+#define DETECT_FW_SRC           "../1ms_x_5times.c"
+#endif
+
+#define main detect_firmware_main
+#include DETECT_FW_SRC
+#undef main
+
+#if !DETECT_HIT_LINK || DETECT_IS_P1P2
+#error "sim_hit_link needs a DETECT_STRATEGY_CHANNEL firmware built with DETECT_HIT_LINK"
+#endif
+
+// 부팅(StartSignal 4s) 후 첫 volley 시각
+#define LINK_START_US           5000000u
+
+// 입력 펄스 폭 (확인 5 tick보다 길게) / volley 안에서 채널 상승 시각 흩어짐 최대
+#define LINK_PULSE_US           7000u
+#define LINK_JITTER_US          1500u
+
+// volley 주기 하한 (같은 채널 펄스가 겹치지 않게)
+#define LINK_MIN_PERIOD_MS      ((LINK_PULSE_US + LINK_JITTER_US) / 1000u + 2u)
+
+// 마지막 volley 뒤 통계 출력 / 정지까지
+#define LINK_TAIL_US            50000u
+
+#define LINK_MAX_SHOTS          (3u * 4096u)
+
+// ------------ 설정 ------------
+static uint32_t cfg_volleys = 1000;
+static uint32_t cfg_period_ms = 20;
+static uint32_t cfg_noise = 0;
+static uint32_t cfg_seed = 1;
+static bool     cfg_verbose = false;
+static const char *cfg_params = NULL;
+
+// ------------ 입력 스크립트 ------------
+typedef struct {
+    uint64_t t_us;          // 상승 시각 (= 기대 t_us)
+    uint8_t  ch;
+    uint8_t  type;
+    bool     matched;
+} link_shot_t;
+
+typedef struct {
+    uint64_t t_us;
+    uint     pin;
+    bool     level;
+} link_edge_t;
+
+static link_shot_t g_shots[LINK_MAX_SHOTS];
+static uint32_t g_shot_n = 0;
+static link_edge_t g_edges[2u * LINK_MAX_SHOTS];
+static uint32_t g_edge_n = 0;
+static uint32_t g_edge_i = 0;
+static uint64_t g_end_us = 0;
+static bool g_stats_fed = false;
+static bool g_params_fed = false;
+
+static int shot_cmp(const void *a, const void *b) {
+    const link_shot_t *x = a;
+    const link_shot_t *y = b;
+    if (x->t_us != y->t_us) return x->t_us < y->t_us ? -1 : 1;
+    return (int)x->ch - (int)y->ch;
+}
+
+static int edge_cmp(const void *a, const void *b) {
+    const link_edge_t *x = a;
+    const link_edge_t *y = b;
+    if (x->t_us != y->t_us) return x->t_us < y->t_us ? -1 : 1;
+    return (int)x->level - (int)y->level;
+}
+
+static void script_build(void) {
+    srand(cfg_seed);
+    g_shot_n = 0;
+    g_edge_n = 0;
+    for (uint32_t v = 0; v < cfg_volleys; v++) {
+        uint64_t t0 = LINK_START_US + (uint64_t)v * cfg_period_ms * 1000u;
+        uint32_t mask = 1u + (uint32_t)rand() % ((1u << CH_COUNT) - 1u);
+        for (uint ch = 0; ch < CH_COUNT; ch++) {
+            if (!(mask & (1u << ch)) || g_shot_n >= LINK_MAX_SHOTS) continue;
+            uint64_t rise = t0 + (uint64_t)(rand() % (LINK_JITTER_US + 1u));
+            g_shots[g_shot_n++] = (link_shot_t){ rise, (uint8_t)ch, (uint8_t)HIT_LINE_NO(g_ch[ch].hit_pin), false };
+            g_edges[g_edge_n++] = (link_edge_t){ rise, g_ch[ch].detect_pin, true };
+            g_edges[g_edge_n++] = (link_edge_t){ rise + LINK_PULSE_US, g_ch[ch].detect_pin, false };
+        }
+    }
+    qsort(g_shots, g_shot_n, sizeof(g_shots[0]), shot_cmp);
+    qsort(g_edges, g_edge_n, sizeof(g_edges[0]), edge_cmp);
+    g_end_us = LINK_START_US + (uint64_t)cfg_volleys * cfg_period_ms * 1000u + LINK_TAIL_US;
+    if (cfg_params) g_end_us += ((uint64_t)DETECT_SAVE_QUIET_MS + 100u) * 1000u;
+}
+
+static uint64_t link_step(uint64_t now) {
+    if (cfg_params && !g_params_fed) {
+        sim_stdin_feed(cfg_params);
+        sim_stdin_feed(";");
+        g_params_fed = true;
+    }
+    while (g_edge_i < g_edge_n && g_edges[g_edge_i].t_us <= now) {
+        sim_gpio_drive(g_edges[g_edge_i].pin, g_edges[g_edge_i].level);
+        g_edge_i++;
+    }
+    if (!g_stats_fed && now + LINK_TAIL_US / 2u >= g_end_us) {
+        sim_stdin_feed("s");
+        g_stats_fed = true;
+    }
+    if (now >= g_end_us) {
+        sim_stop();
+        return SIM_NEVER;
+    }
+    uint64_t next = g_stats_fed ? g_end_us : g_end_us - LINK_TAIL_US / 2u;
+    if (g_edge_i < g_edge_n && g_edges[g_edge_i].t_us < next) next = g_edges[g_edge_i].t_us;
+    return next;
+}
+
+// ------------ 수신 (자식 프로세스 = 메인 PCB 대역) ------------
+// 시각으로 이분 탐색 (g_shots는 시각 순, 시뮬레이션은 time_us_32가 넘어가기 전에 끝남)
+static link_shot_t *shot_find(const hit_link_rec_t *r) {
+    uint32_t lo = 0, hi = g_shot_n;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2u;
+        if (g_shots[mid].t_us < r->t_us) lo = mid + 1u;
+        else                             hi = mid;
+    }
+    for (uint32_t i = lo; i < g_shot_n && g_shots[i].t_us == r->t_us; i++) {
+        if (!g_shots[i].matched && g_shots[i].ch == r->ch) return &g_shots[i];
+    }
+    return NULL;
+}
+
+// 송신이 끝나면 부모가 보낸 총 byte 수가 ctl pipe로 옴 → 그만큼 다 읽은 뒤 끝 (부모는 그 다음에 master를 닫음)
+static int rx_main(int fd, int ctl) {
+    hit_link_rx_t rx;
+    hit_link_rx_init(&rx);
+
+    uint32_t recs = 0, unexpected = 0, type_err = 0, seq_lost = 0;
+    bool have_seq = false;
+    uint16_t last_seq = 0;
+    uint8_t buf[256];
+    uint32_t rx_bytes = 0, tx_bytes = 0;
+    bool tx_done = false;
+
+    while (!tx_done || rx_bytes < tx_bytes) {
+        struct pollfd pfd[2] = { { fd, POLLIN, 0 }, { ctl, POLLIN, 0 } };
+        if (poll(pfd, tx_done ? 1 : 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (!tx_done && (pfd[1].revents & (POLLIN | POLLHUP))) {
+            if (read(ctl, &tx_bytes, sizeof(tx_bytes)) != (ssize_t)sizeof(tx_bytes)) break;
+            tx_done = true;
+        }
+        if (!(pfd[0].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;      // master가 닫히면 EIO
+        rx_bytes += (uint32_t)n;
+
+        for (ssize_t i = 0; i < n; i++) {
+            uint32_t count = hit_link_rx_byte(&rx, buf[i]);
+            for (uint32_t k = 0; k < count; k++) {
+                hit_link_rec_t r;
+                hit_link_rx_rec(&rx, k, &r);
+                recs++;
+                if (have_seq) seq_lost += (uint16_t)(r.seq - last_seq - 1u);
+                have_seq = true;
+                last_seq = r.seq;
+
+                link_shot_t *s = shot_find(&r);
+                if (!s) {
+                    unexpected++;
+                } else {
+                    s->matched = true;
+                    if (s->type != r.type) type_err++;
+                }
+                if (cfg_verbose) {
+                    printf("rx seq=%u ch=%u type=%u t=%lu%s\n", r.seq, r.ch, r.type, (unsigned long)r.t_us,
+                           k == 0 && count > 1 ? " (batch)" : "");
+                }
+            }
+        }
+    }
+
+    uint32_t missing = 0;
+    for (uint32_t i = 0; i < g_shot_n; i++) {
+        if (!g_shots[i].matched) missing++;
+    }
+
+    printf("rx frames       : %u (crc err %u, skipped %u byte)\n", rx.frames, rx.crc_err, rx.skipped);
+    printf("rx records      : %u / %u shots, missing %u, unexpected %u, type err %u, seq lost %u\n",
+           recs, g_shot_n, missing, unexpected, type_err, seq_lost);
+
+    // 잡음이 없으면 전부 일치, 잡음이 있으면 CRC를 통과한 record는 모두 맞고 누락은 seq로 드러나야 함
+    bool ok = unexpected == 0 && type_err == 0;
+    if (cfg_noise == 0) ok = ok && missing == 0 && rx.crc_err == 0 && seq_lost == 0;
+    else                ok = ok && missing >= seq_lost;
+    printf("result          : %s\n", ok ? "OK" : "FAIL");
+    return ok ? 0 : 1;
+}
+
+static int pty_open(int *slave_out) {
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        perror("posix_openpt");
+        return -1;
+    }
+    const char *name = ptsname(master);
+    int slave = name ? open(name, O_RDWR | O_NOCTTY) : -1;
+    if (slave < 0) {
+        perror("pty slave");
+        close(master);
+        return -1;
+    }
+    // 줄 단위 처리/echo 없이 byte 그대로
+    struct termios tio;
+    tcgetattr(slave, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(slave, TCSANOW, &tio);
+    *slave_out = slave;
+    return master;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-n volleys] [-g period_ms] [-c noise_every] [-s seed] [-p cmds] [-v]\n", prog);
+    fprintf(stderr, "  -c : N byte마다 bit 반전 (CRC 확인)\n");
+    fprintf(stderr, "  -p : 시작 때 넣을 파라미터 명령 (';'로 구분, 예: \"p sample_us 800;p save\")\n");
+    fprintf(stderr, "  -v : 받은 record 출력\n");
+}
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            cfg_volleys = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-g") && i + 1 < argc) {
+            cfg_period_ms = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-c") && i + 1 < argc) {
+            cfg_noise = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-s") && i + 1 < argc) {
+            cfg_seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
+            cfg_params = argv[++i];
+        } else if (!strcmp(argv[i], "-v")) {
+            cfg_verbose = true;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (cfg_volleys * CH_COUNT > LINK_MAX_SHOTS) cfg_volleys = LINK_MAX_SHOTS / CH_COUNT;
+    if (cfg_period_ms < LINK_MIN_PERIOD_MS) cfg_period_ms = LINK_MIN_PERIOD_MS;
+    script_build();
+
+    int slave = -1;
+    int master = pty_open(&slave);
+    if (master < 0) return 2;
+    int ctl[2];
+    if (pipe(ctl) != 0) {
+        perror("pipe");
+        return 2;
+    }
+
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return 2;
+    }
+    if (pid == 0) {
+        close(master);
+        close(ctl[1]);
+        int rc = rx_main(slave, ctl[0]);
+        fflush(stdout);
+        _exit(rc);
+    }
+    close(slave);
+    close(ctl[0]);
+
+    printf("firmware        : %s (DETECT_HIT_LINK=%d, %u baud)\n", DETECT_FW_SRC, DETECT_HIT_LINK, (unsigned)HIT_LINK_BAUD);
+    printf("volleys         : %u every %u ms, %u shots\n", cfg_volleys, cfg_period_ms, g_shot_n);
+
+    sim_reset();
+    sim_uart_attach((HIT_LINK_UART)->index, master);
+    sim_uart_set_noise((HIT_LINK_UART)->index, cfg_noise);
+    sim_set_plant(link_step);
+    sim_run(detect_firmware_main);
+
+    uint32_t tx_bytes = sim_uart_tx_count((HIT_LINK_UART)->index);
+    printf("tx bytes        : %u\n", tx_bytes);
+    fflush(stdout);
+    if (write(ctl[1], &tx_bytes, sizeof(tx_bytes)) != (ssize_t)sizeof(tx_bytes)) perror("ctl");
+    close(ctl[1]);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    close(master);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 2;
+}
@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+sub_pcb_mnq.c host 시뮬레이터
+- 펌웨어 소스를 그대로 include 해서 가상 시계 위에서 실행
+- plant: 모터 위치(0=위, 1=아래)를 PWM duty로 적분, 양 끝에서 엔드스탑 눌림
+- 시나리오: READY_UP 진입 후 일정 시간 뒤 헤드샷(또는 몸통샷 2회) 입력, target(MNQ_TARGET_COUNT)마다 따로
+- 모든 target이 N 사이클을 채우면 정지, 사이클 시간/이동 시간 출력 (전 target 합산)
+- -k : 엔드스탑 고장 (도착해도 안 눌림) → travel watchdog 복구 확인
+- -j : 스트로크 중간 걸림 → MOTOR_CURRENT_SENSE 빌드(sim_mnq_cs)는 전류 stall로 바로 브레이크/다시 시작, 아니면 그냥 밀고 감
+- -p : 첫 READY_UP에서 stdio로 파라미터 명령 입력 (줄 구분 ;), -f와 같이 쓰면 저장값이 다음 실행으로 이어짐
+*/
+
+#define main mnq_firmware_main
+#include "../pico_mnq/sub_pcb_mnq.c"
+#undef main
+
+#include "mnq_plant.h"
+
+// 탄 입력 펄스 폭 / 몸통샷 2회 간격
+#define SHOT_PULSE_US               10000u
+#define SHOT_GAP_US                 30000u
+
+// ------------ 시나리오 설정 ------------
+static uint32_t cfg_cycles       = 1000;
+static uint32_t cfg_shot_delay_ms = 100;   // READY_UP 후 첫 탄까지
+static bool     cfg_body_shot    = false;  // true면 몸통샷 2회, false면 헤드샷 1회
+static const char *cfg_flash_path = NULL;   // flash 이미지 파일 (실행 전 복원, 끝나고 저장)
+static bool     cfg_trace        = false;  // true면 GPIO trace 기록('t'), 끝날 때 hex 덤프('d')
+static uint32_t cfg_emi_us       = 0;      // >0 이면 모터가 움직이는 동안 DETECT 입력에 이 간격으로 잡음 토글
+static const char *cfg_params    = NULL;   // 첫 READY_UP에서 입력할 파라미터 명령 ("p hold_down_ms 1500;p save;p")
+
+// ------------ 시나리오 상태 (target마다) ------------
+typedef struct {
+    mnq_phase_t prev_phase;
+    bool     ready_seen;
+    uint64_t ready_us;
+    uint64_t shot_us[4];
+    uint32_t shot_pin[4];
+    bool     shot_level[4];
+    int      shot_n;
+    int      shot_i;
+    uint32_t cycles;
+    uint64_t emi_next_us;
+    bool     emi_level;
+} sim_target_t;
+
+static sim_target_t sc[MNQ_TARGET_COUNT];
+
+// ------------ 통계 ------------
+static uint32_t st_cycles = 0;          // 전 target 합
+static uint64_t st_cycle_sum_us = 0;
+static uint64_t st_cycle_min_us = UINT64_MAX;
+static uint64_t st_cycle_max_us = 0;
+
+
+// N 사이클 후 펌웨어에 tick 통계 출력('s')을 요청하고, 이 시각에 정지
+static uint64_t st_stop_us = SIM_NEVER;
+
+static void scenario_schedule(sim_target_t *c, uint t, uint64_t now) {
+    uint64_t at = now + (uint64_t)cfg_shot_delay_ms * 1000u;
+    uint head = g_mnq_pins[t].detect_head;
+    uint body = g_mnq_pins[t].detect_body[0];
+    c->shot_n = 0;
+    c->shot_i = 0;
+
+    if (cfg_body_shot) {
+        for (int i = 0; i < 2; i++) {
+            uint64_t t0 = at + (uint64_t)i * (SHOT_PULSE_US + SHOT_GAP_US);
+            c->shot_pin[c->shot_n] = body; c->shot_level[c->shot_n] = 1; c->shot_us[c->shot_n++] = t0;
+            c->shot_pin[c->shot_n] = body; c->shot_level[c->shot_n] = 0; c->shot_us[c->shot_n++] = t0 + SHOT_PULSE_US;
+        }
+    } else {
+        c->shot_pin[c->shot_n] = head; c->shot_level[c->shot_n] = 1; c->shot_us[c->shot_n++] = at;
+        c->shot_pin[c->shot_n] = head; c->shot_level[c->shot_n] = 0; c->shot_us[c->shot_n++] = at + SHOT_PULSE_US;
+    }
+}
+
+static bool scenario_done(void) {
+    for (uint t = 0; t < MNQ_TARGET_COUNT; t++) {
+        if (sc[t].cycles < cfg_cycles) return false;
+    }
+    return true;
+}
+
+// target 1대 시나리오, 다음 탄 입력 시각 반환
+static uint64_t scenario_step(uint t, uint64_t now) {
+    sim_target_t *c = &sc[t];
+    mnq_phase_t phase = g_mnq[t].phase;
+
+    // READY_UP 진입 = 사이클 1회 완료
+    if (phase == PHASE_READY_UP && c->prev_phase != PHASE_READY_UP) {
+        if (c->ready_seen) {
+            uint64_t cyc = now - c->ready_us;
+            c->cycles++;
+            st_cycles++;
+            st_cycle_sum_us += cyc;
+            if (cyc < st_cycle_min_us) st_cycle_min_us = cyc;
+            if (cyc > st_cycle_max_us) st_cycle_max_us = cyc;
+            if (scenario_done() && st_stop_us == SIM_NEVER) {
+                sim_stdin_feed(cfg_trace ? "sd" : "s");
+                st_stop_us = now + 10000u;
+            }
+        } else if (t == 0) {
+            if (cfg_trace) sim_stdin_feed("t");
+            if (cfg_params) {
+                sim_stdin_feed(cfg_params);
+                sim_stdin_feed(";");
+            }
+        }
+        c->ready_seen = true;
+        c->ready_us = now;
+        scenario_schedule(c, t, now);
+    } else if (phase == PHASE_READY_UP && c->shot_i >= c->shot_n &&
+               (c->shot_n == 0 || now - c->shot_us[c->shot_n - 1] >= (uint64_t)cfg_shot_delay_ms * 1000u)) {
+        // 탄이 반영되지 않음(부팅 중 IRQ 설정 전 등) → 다시 쏨
+        scenario_schedule(c, t, now);
+    }
+    c->prev_phase = phase;
+
+    // 탄 입력
+    while (c->shot_i < c->shot_n && c->shot_us[c->shot_i] <= now) {
+        sim_gpio_drive(c->shot_pin[c->shot_i], c->shot_level[c->shot_i]);
+        c->shot_i++;
+    }
+    // 모터 EMI : 움직이는 동안 몸통 입력(detect_body[1]) 토글, 멈추면 LOW
+    uint64_t next = c->shot_i < c->shot_n ? c->shot_us[c->shot_i] : SIM_NEVER;
+    if (cfg_emi_us > 0) {
+        uint emi_pin = g_mnq_pins[t].detect_body[1];
+        if (phase == PHASE_MOVING_DOWN || phase == PHASE_MOVING_UP) {
+            if (now >= c->emi_next_us) {
+                c->emi_level = !c->emi_level;
+                sim_gpio_drive(emi_pin, c->emi_level);
+                c->emi_next_us = now + cfg_emi_us;
+            }
+            if (c->emi_next_us < next) next = c->emi_next_us;
+        } else if (c->emi_level) {
+            c->emi_level = false;
+            sim_gpio_drive(emi_pin, false);
+        }
+    }
+    return next;
+}
+
+static uint64_t plant_step(uint64_t now) {
+    plant_motion(now);
+    if (now >= st_stop_us) sim_stop();
+
+    uint64_t next = now + 1000u;
+    for (uint t = 0; t < MNQ_TARGET_COUNT; t++) {
+        uint64_t shot = scenario_step(t, now);
+        if (shot < next) next = shot;
+    }
+    return next;
+}
+
+static double wall_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-n cycles] [-d shot_delay_ms] [-b] [-f flash.bin] [-t] [-e emi_us] [-k top|under[:N]] [-j N] [-p cmds]\n", prog);
+    fprintf(stderr, "  -b : 몸통샷 2회 (기본은 헤드샷 1회)\n");
+    fprintf(stderr, "  -f : flash 이미지 파일 (학습값 유지, 전원 재투입 확인용)\n");
+    fprintf(stderr, "  -t : GPIO trace 기록 후 hex 덤프 출력 (trace_replay 입력)\n");
+    fprintf(stderr, "  -e : 모터가 움직이는 동안 DETECT_3에 us 간격 잡음 (IRQ guard 확인)\n");
+    fprintf(stderr, "  -k : LIMIT_SW_TOP(아래 끝)/LIMIT_SW_UNDER(위 끝)가 N번째 도착마다 안 눌림 (N 생략 시 1 = 항상)\n");
+    fprintf(stderr, "  -j : N번째 스트로크마다 중간에서 %u ms 걸림 (모터 전류 stall)\n", PLANT_JAM_MS);
+    fprintf(stderr, "  -p : 파라미터 명령, 예: -p \"p hold_down_ms 1500;p save\" (param_store.h)\n");
+}
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            cfg_cycles = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-d") && i + 1 < argc) {
+            cfg_shot_delay_ms = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-b")) {
+            cfg_body_shot = true;
+        } else if (!strcmp(argv[i], "-f") && i + 1 < argc) {
+            cfg_flash_path = argv[++i];
+        } else if (!strcmp(argv[i], "-t")) {
+            cfg_trace = true;
+        } else if (!strcmp(argv[i], "-e") && i + 1 < argc) {
+            cfg_emi_us = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-j") && i + 1 < argc) {
+            plant_jam_every = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
+            cfg_params = argv[++i];
+        } else if (!strcmp(argv[i], "-k") && i + 1 < argc) {
+            const char *sw = argv[++i];
+            const char *colon = strchr(sw, ':');
+            uint32_t every = colon ? (uint32_t)strtoul(colon + 1, NULL, 0) : 1u;
+            size_t len = colon ? (size_t)(colon - sw) : strlen(sw);
+            if (len == 3 && !strncmp(sw, "top", 3))        plant_stuck_every[1] = every;
+            else if (len == 5 && !strncmp(sw, "under", 5)) plant_stuck_every[0] = every;
+            else {
+                usage(argv[0]);
+                return 2;
+            }
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    for (uint t = 0; t < MNQ_TARGET_COUNT; t++) sc[t].prev_phase = PHASE_READY_UP;
+
+    sim_reset();
+    if (cfg_flash_path) sim_flash_load(cfg_flash_path);
+
+    plant_init();
+    sim_set_plant(plant_step);
+
+    double t0 = wall_sec();
+    sim_run(mnq_firmware_main);
+    double wall = wall_sec() - t0;
+    if (cfg_flash_path && !sim_flash_save(cfg_flash_path)) {
+        fprintf(stderr, "flash image save failed: %s\n", cfg_flash_path);
+    }
+
+    double virt = (double)sim_now_us() / 1e6;
+    printf("targets         : %u\n", (unsigned)MNQ_TARGET_COUNT);
+    printf("cycles          : %u\n", st_cycles);
+    printf("virtual time    : %.1f s\n", virt);
+    printf("wall time       : %.3f s\n", wall);
+    if (wall > 0.0) printf("cycles / sec    : %.0f\n", (double)st_cycles / wall);
+    if (st_cycles > 0) {
+        printf("cycle time      : avg %.1f ms, min %.1f ms, max %.1f ms\n",
+               (double)st_cycle_sum_us / st_cycles / 1000.0,
+               (double)st_cycle_min_us / 1000.0,
+               (double)st_cycle_max_us / 1000.0);
+    }
+    if (st_travel_n[1]) printf("travel down     : avg %.1f ms\n", (double)st_travel_sum_us[1] / st_travel_n[1] / 1000.0);
+    if (st_travel_n[0]) printf("travel up       : avg %.1f ms\n", (double)st_travel_sum_us[0] / st_travel_n[0] / 1000.0);
+    printf("flash erases    : %u\n", sim_flash_erase_count());
+    if (plant_stuck_every[0] || plant_stuck_every[1]) {
+        printf("stuck arrivals  : top %u, under %u\n", st_stuck_n[1], st_stuck_n[0]);
+    }
+    if (plant_jam_every) printf("jammed strokes  : %u\n", st_jam_n);
+
+    return scenario_done() ? 0 : 1;
+}
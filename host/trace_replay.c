@@ -0,0 +1,618 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "pico/stdlib.h"
+#include "gpio_trace_format.h"
+#include "trace_replay.h"
+
+/*
+GPIO trace 재생 (host)
+- sub_pcb_mnq의 't'/'d' 명령으로 받은 trace(hex 덤프 로그 또는 바이너리)를 읽어서
+  sub_pico_mnq_1.c / sub_pico_mnq_2.c / 1ms_x_5times.c 에 똑같이 넣고 HIT 출력을 비교
+- 펌웨어마다 fork 해서 동시에 재생 (가상 시계, 실제 시간보다 훨씬 빠름)
+- DETECT 상승엣지 묶음(REPLAY_SHOT_GAP_US 이상 떨어지면 새 탄)을 탄 1발로 보고 펌웨어별 판정(h/b/n)과 지연 비교
+- 정답 라벨(-l, 탄마다 h/b/n)이 있으면 정답/오분류/누락/오검출 집계
+- trace가 없으면 -s로 합성 trace 생성 (라벨 포함, -w로 저장 가능)
+*/
+
+// trace 채널 중 탄 감지 입력 (sub_pcb_mnq.c / 탄 감지 보드 공통 핀)
+#define PIN_DETECT_1            3
+#define PIN_DETECT_2            4
+#define PIN_DETECT_3            5
+#define PIN_LIMIT_SW_TOP        15
+#define PIN_LIMIT_SW_UNDER      16
+
+#define PIN_HIT_1               12
+#define PIN_HIT_2               13
+#define PIN_HIT_3               14
+
+// 이 간격 이상 DETECT 엣지가 없으면 다음 상승엣지부터 새 탄
+#define REPLAY_SHOT_GAP_US      40000u
+
+#define REPLAY_MAX_LIST         32
+
+// ------------ 펌웨어 ------------
+typedef struct {
+    const char  *name;
+    replay_fw_fn run;
+    uint8_t      head_pin;      // 이 출력이 있으면 헤드샷
+    uint8_t      body_pin[2];   // 이 출력이면 몸통샷 (0 = 없음)
+} replay_variant_t;
+
+static const replay_variant_t g_variants[] = {
+    { "sub_pico_mnq_1.c", replay_fw_sub_pico_mnq_1, PIN_HIT_1, { PIN_HIT_2, 0 } },
+    { "sub_pico_mnq_2.c", replay_fw_sub_pico_mnq_2, PIN_HIT_1, { PIN_HIT_2, 0 } },
+    // 채널별 디바운스 : HIT_1 = DETECT_2(머리), HIT_2/HIT_3 = DETECT_1/DETECT_3(몸통)
+    { "1ms_x_5times.c",   replay_fw_1ms_x_5times,   PIN_HIT_1, { PIN_HIT_2, PIN_HIT_3 } },
+};
+
+#define VARIANT_COUNT   (int)(sizeof(g_variants) / sizeof(g_variants[0]))
+
+// ------------ trace ------------
+static gpio_trace_hdr_t g_hdr;
+static replay_edge_t   *g_edges = NULL;
+static int              g_edge_n = 0;
+static uint64_t         g_end_us = 0;
+
+// ------------ 탄 구간 ------------
+typedef struct {
+    uint64_t t_us;          // 첫 DETECT 상승엣지
+    char     label;         // h/b/n, 0 = 라벨 없음
+} replay_shot_t;
+
+static replay_shot_t *g_shots = NULL;
+static int            g_shot_n = 0;
+static bool           g_labeled = false;
+
+// ------------ 결과 ------------
+typedef struct {
+    uint32_t n;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+} replay_acc_t;
+
+typedef struct {
+    replay_msg_t *hits;
+    int           hit_n;
+    uint64_t      wall_us;
+    bool          ok;
+
+    char         *cls;          // 탄별 판정
+    uint32_t      out_count[3]; // HIT_1/2/3 출력 수
+    uint32_t      head, body, none;
+    uint32_t      extra;        // 탄 1발에 출력이 2번 이상
+    uint32_t      correct, wrong, missed, false_hit;
+    replay_acc_t  latency;
+} replay_result_t;
+
+static replay_result_t g_res[VARIANT_COUNT];
+
+static void acc_add(replay_acc_t *a, uint64_t v) {
+    if (a->n == 0 || v < a->min) a->min = v;
+    if (a->n == 0 || v > a->max) a->max = v;
+    a->n++;
+    a->sum += v;
+}
+
+static bool is_detect_pin(uint pin) {
+    return pin == PIN_DETECT_1 || pin == PIN_DETECT_2 || pin == PIN_DETECT_3;
+}
+
+// ------------ trace 읽기 ------------
+static uint8_t *read_file(const char *path, size_t *len) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return NULL;
+    }
+    size_t cap = 65536, n = 0;
+    uint8_t *buf = malloc(cap);
+    size_t r;
+    while (buf && (r = fread(buf + n, 1, cap - n, f)) > 0) {
+        n += r;
+        if (n == cap) buf = realloc(buf, cap *= 2);
+    }
+    fclose(f);
+    *len = n;
+    return buf;
+}
+
+static int hex_val(int c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// 시리얼 로그에서 마지막 "TR BEGIN" ~ "TR END" 블록을 바이너리로 (다른 줄은 무시)
+static uint8_t *parse_hex_dump(const char *text, size_t len, size_t *out_len) {
+    uint8_t *out = malloc(len / 2 + 1);
+    size_t n = 0;
+    bool in_block = false;
+    bool done = false;
+
+    const char *p = text;
+    const char *end = text + len;
+    while (p < end && out) {
+        const char *eol = memchr(p, '\n', (size_t)(end - p));
+        if (!eol) eol = end;
+
+        const char *tr = NULL;
+        for (const char *q = p; q + 3 <= eol; q++) {
+            if (q[0] == 'T' && q[1] == 'R' && q[2] == ' ') { tr = q + 3; break; }
+        }
+        if (tr) {
+            if (!strncmp(tr, "BEGIN", 5)) {
+                in_block = true;
+                done = false;
+                n = 0;
+            } else if (!strncmp(tr, "END", 3)) {
+                if (in_block) done = true;
+                in_block = false;
+            } else if (in_block) {
+                for (const char *q = tr; q + 1 < eol; q += 2) {
+                    int hi = hex_val(q[0]), lo = hex_val(q[1]);
+                    if (hi < 0 || lo < 0) break;
+                    out[n++] = (uint8_t)(hi << 4 | lo);
+                }
+            }
+        }
+        p = eol + 1;
+    }
+    if (!done) {
+        free(out);
+        return NULL;
+    }
+    *out_len = n;
+    return out;
+}
+
+// 바이너리 trace → 재생 엣지 목록 (시작 레벨 엣지는 0 시각)
+static bool trace_decode(const uint8_t *buf, size_t len) {
+    if (len < GPIO_TRACE_HDR_SIZE || !gpio_trace_hdr_read(buf, &g_hdr)) {
+        fprintf(stderr, "not a GPIO trace\n");
+        return false;
+    }
+    if (len < GPIO_TRACE_HDR_SIZE + (size_t)g_hdr.data_len) {
+        fprintf(stderr, "trace truncated (%zu of %u event bytes)\n",
+                len - GPIO_TRACE_HDR_SIZE, g_hdr.data_len);
+        g_hdr.data_len = (uint32_t)(len - GPIO_TRACE_HDR_SIZE);
+    }
+
+    const uint8_t *p = buf + GPIO_TRACE_HDR_SIZE;
+    uint32_t left = g_hdr.data_len;
+    int cap = g_hdr.ch_count + (int)left;       // 이벤트는 최소 1 byte
+    g_edges = malloc(sizeof(replay_edge_t) * (size_t)cap);
+    g_edge_n = 0;
+
+    for (uint i = 0; i < g_hdr.ch_count; i++) {
+        g_edges[g_edge_n++] = (replay_edge_t){ 0, g_hdr.pins[i], (g_hdr.init_levels >> i) & 1u };
+    }
+
+    uint64_t t = REPLAY_START_US;
+    while (left > 0) {
+        uint32_t delta;
+        uint ch;
+        bool level;
+        uint n = gpio_trace_get_event(p, left, &delta, &ch, &level);
+        if (n == 0 || ch >= g_hdr.ch_count) {
+            fprintf(stderr, "bad trace event at byte %u\n", g_hdr.data_len - left);
+            break;
+        }
+        t += delta;
+        g_edges[g_edge_n++] = (replay_edge_t){ t, g_hdr.pins[ch], level };
+        p += n;
+        left -= n;
+    }
+    g_end_us = t + REPLAY_TAIL_US;
+    return true;
+}
+
+// ------------ 합성 trace ------------
+static uint32_t g_rand = 1;
+
+static uint32_t rnd(uint32_t n) {
+    g_rand = g_rand * 1103515245u + 12345u;
+    return ((g_rand >> 16) & 0x7fffu) % n;
+}
+
+static uint8_t *g_syn_buf;
+static uint32_t g_syn_len;
+static uint64_t g_syn_last;
+
+typedef struct {
+    uint64_t t_us;
+    uint8_t  ch;
+    bool     level;
+} syn_edge_t;
+
+static int syn_cmp(const void *a, const void *b) {
+    const syn_edge_t *x = a, *y = b;
+    if (x->t_us != y->t_us) return x->t_us < y->t_us ? -1 : 1;
+    return (int)y->ch - (int)x->ch;     // 같은 시각이면 P2 먼저
+}
+
+static void syn_pulse(syn_edge_t *e, int *n, uint8_t ch, uint64_t t, uint32_t width_us) {
+    e[(*n)++] = (syn_edge_t){ t, ch, true };
+    e[(*n)++] = (syn_edge_t){ t + width_us, ch, false };
+}
+
+// 현장 파형 흉내 : 헤드/몸통/노이즈, 폭 지터, 상승 채터링
+static uint8_t *trace_synth(int shots, size_t *len, char **labels) {
+    static const uint8_t pins[] = { PIN_DETECT_1, PIN_DETECT_2, PIN_DETECT_3, PIN_LIMIT_SW_TOP, PIN_LIMIT_SW_UNDER };
+    gpio_trace_hdr_t h;
+    memset(&h, 0, sizeof(h));
+    memset(h.pins, 0xff, sizeof(h.pins));
+    h.ch_count = sizeof(pins);
+    memcpy(h.pins, pins, sizeof(pins));
+    h.init_levels = (1u << 3) | (1u << 4);      // 리밋 스위치 pull-up
+    h.start_us = 0;
+
+    syn_edge_t *e = malloc(sizeof(syn_edge_t) * (size_t)shots * 16);
+    int n = 0;
+    *labels = malloc((size_t)shots + 1);
+
+    uint64_t t = 50000;
+    for (int i = 0; i < shots; i++) {
+        uint32_t w = 8000 + rnd(4001);          // P1 8~12 ms
+        uint32_t kind = rnd(10);
+        if (kind < 4) {
+            // 헤드 : P2가 P1보다 0~1 ms 먼저, P1보다 길게
+            uint32_t lead = rnd(1001);
+            syn_pulse(e, &n, 1, t - lead, w + lead + 2000 + rnd(6001));
+            syn_pulse(e, &n, 0, t, w);
+            (*labels)[i] = 'h';
+        } else if (kind < 8) {
+            // 몸통
+            if (kind == 7) {
+                // 상승 채터링 2번
+                syn_pulse(e, &n, 0, t, 200 + rnd(300));
+                syn_pulse(e, &n, 0, t + 800, 200 + rnd(300));
+                syn_pulse(e, &n, 0, t + 1600, w);
+            } else {
+                syn_pulse(e, &n, 0, t, w);
+            }
+            (*labels)[i] = 'b';
+        } else {
+            // 노이즈 : 1~3 ms
+            syn_pulse(e, &n, (uint8_t)(kind == 8 ? 0 : 1), t, 1000 + rnd(2001));
+            (*labels)[i] = 'n';
+        }
+        t += 80000 + rnd(320001);
+    }
+    (*labels)[shots] = 0;
+    qsort(e, (size_t)n, sizeof(e[0]), syn_cmp);
+
+    size_t cap = GPIO_TRACE_HDR_SIZE + (size_t)n * 5;
+    g_syn_buf = malloc(cap);
+    g_syn_len = 0;
+    g_syn_last = 0;
+    for (int i = 0; i < n; i++) {
+        uint8_t *p = g_syn_buf + GPIO_TRACE_HDR_SIZE + g_syn_len;
+        g_syn_len += gpio_trace_put_event(p, (uint)(cap - GPIO_TRACE_HDR_SIZE - g_syn_len),
+                                          (uint32_t)(e[i].t_us - g_syn_last), e[i].ch, e[i].level);
+        g_syn_last = e[i].t_us;
+    }
+    h.data_len = g_syn_len;
+    gpio_trace_hdr_write(g_syn_buf, &h);
+    free(e);
+
+    *len = GPIO_TRACE_HDR_SIZE + g_syn_len;
+    return g_syn_buf;
+}
+
+// ------------ 탄 구간 분할 ------------
+static void shots_build(void) {
+    g_shots = malloc(sizeof(replay_shot_t) * (size_t)(g_edge_n + 1));
+    g_shot_n = 0;
+
+    uint64_t last_edge = 0;
+    bool any = false;
+    for (int i = 0; i < g_edge_n; i++) {
+        const replay_edge_t *e = &g_edges[i];
+        if (e->t_us == 0 || !is_detect_pin(e->pin)) continue;
+        if (e->level && (!any || e->t_us - last_edge >= REPLAY_SHOT_GAP_US)) {
+            g_shots[g_shot_n++] = (replay_shot_t){ e->t_us, 0 };
+        }
+        last_edge = e->t_us;
+        any = true;
+    }
+}
+
+static bool labels_apply(const char *labels) {
+    int n = 0;
+    for (const char *p = labels; *p; p++) {
+        if (*p != 'h' && *p != 'b' && *p != 'n') continue;
+        if (n < g_shot_n) g_shots[n].label = *p;
+        n++;
+    }
+    if (n != g_shot_n) {
+        fprintf(stderr, "label count %d != shot count %d\n", n, g_shot_n);
+        return false;
+    }
+    g_labeled = true;
+    return true;
+}
+
+// ------------ 재생 ------------
+static bool read_all(int fd, replay_result_t *r) {
+    int cap = 256;
+    r->hits = malloc(sizeof(replay_msg_t) * (size_t)cap);
+    r->hit_n = 0;
+
+    replay_msg_t m;
+    size_t got = 0;
+    ssize_t k;
+    while ((k = read(fd, (uint8_t *)&m + got, sizeof(m) - got)) > 0) {
+        got += (size_t)k;
+        if (got < sizeof(m)) continue;
+        got = 0;
+        if (m.kind == REPLAY_MSG_DONE) {
+            r->wall_us = m.t_us;
+            r->ok = true;
+        } else {
+            if (r->hit_n == cap) r->hits = realloc(r->hits, sizeof(replay_msg_t) * (size_t)(cap *= 2));
+            r->hits[r->hit_n++] = m;
+        }
+    }
+    return r->ok;
+}
+
+static int hit_index(uint32_t pin) {
+    return pin == PIN_HIT_1 ? 0 : pin == PIN_HIT_2 ? 1 : pin == PIN_HIT_3 ? 2 : -1;
+}
+
+static char classify(const replay_variant_t *v, uint32_t pin) {
+    if (pin == v->head_pin) return 'h';
+    if (pin == v->body_pin[0] || (v->body_pin[1] && pin == v->body_pin[1])) return 'b';
+    return 0;
+}
+
+// 탄 구간 [shot, 다음 shot)의 출력으로 판정 : 머리 출력이 하나라도 있으면 h, 아니면 첫 몸통 출력
+static void evaluate(const replay_variant_t *v, replay_result_t *r) {
+    r->cls = malloc((size_t)g_shot_n + 1);
+    memset(r->cls, 'n', (size_t)g_shot_n);
+    r->cls[g_shot_n] = 0;
+
+    int s = -1;
+    uint32_t outs_in_shot = 0;
+    for (int i = 0; i < r->hit_n; i++) {
+        const replay_msg_t *m = &r->hits[i];
+        int hi = hit_index(m->pin);
+        if (hi >= 0) r->out_count[hi]++;
+
+        char c = classify(v, m->pin);
+        if (!c) continue;
+
+        while (s + 1 < g_shot_n && g_shots[s + 1].t_us <= m->t_us) {
+            s++;
+            outs_in_shot = 0;
+        }
+        if (s < 0) {
+            r->false_hit++;     // 첫 탄 전 출력
+            continue;
+        }
+        if (outs_in_shot++ == 0) acc_add(&r->latency, m->t_us - g_shots[s].t_us);
+        else                     r->extra++;
+        if (c == 'h' || r->cls[s] == 'n') r->cls[s] = c;
+    }
+
+    for (int i = 0; i < g_shot_n; i++) {
+        char c = r->cls[i];
+        if (c == 'h') r->head++;
+        else if (c == 'b') r->body++;
+        else r->none++;
+
+        if (!g_labeled) continue;
+        char want = g_shots[i].label;
+        if (c == want)        r->correct++;
+        else if (c == 'n')    r->missed++;
+        else if (want == 'n') r->false_hit++;
+        else                  r->wrong++;
+    }
+}
+
+// ------------ JSON ------------
+static void json_result(FILE *f, const replay_variant_t *v, const replay_result_t *r) {
+    double trace_ms = (double)(g_end_us - REPLAY_START_US) / 1000.0;
+
+    fprintf(f, "    {\"firmware\": \"%s\", \"ok\": %s, \"wall_ms\": %.3f, \"speedup\": %.1f,\n",
+            v->name, r->ok ? "true" : "false", (double)r->wall_us / 1000.0,
+            r->wall_us ? trace_ms * 1000.0 / (double)r->wall_us : 0.0);
+    fprintf(f, "     \"outputs\": {\"hit_1\": %u, \"hit_2\": %u, \"hit_3\": %u}, \"head\": %u, \"body\": %u, \"none\": %u, \"extra\": %u,\n",
+            r->out_count[0], r->out_count[1], r->out_count[2], r->head, r->body, r->none, r->extra);
+    if (g_labeled) {
+        fprintf(f, "     \"correct\": %u, \"wrong\": %u, \"missed\": %u, \"false\": %u, \"accuracy\": %.4f,\n",
+                r->correct, r->wrong, r->missed, r->false_hit,
+                g_shot_n ? (double)r->correct / g_shot_n : 0.0);
+    }
+    if (r->latency.n == 0) {
+        fprintf(f, "     \"latency_us\": null}");
+    } else {
+        fprintf(f, "     \"latency_us\": {\"n\": %u, \"avg\": %.3f, \"min\": %.3f, \"max\": %.3f}}",
+                r->latency.n, (double)r->latency.sum / r->latency.n,
+                (double)r->latency.min, (double)r->latency.max);
+    }
+}
+
+// 펌웨어끼리 판정이 다른 탄 (앞 REPLAY_MAX_LIST개)
+static void json_disagree(FILE *f) {
+    int n = 0;
+    fprintf(f, "  \"disagree\": [");
+    for (int i = 0; i < g_shot_n; i++) {
+        bool diff = false;
+        for (int v = 1; v < VARIANT_COUNT; v++) {
+            if (g_res[v].cls[i] != g_res[0].cls[i]) diff = true;
+        }
+        if (!diff) continue;
+        if (n < REPLAY_MAX_LIST) {
+            fprintf(f, "%s{\"shot\": %d, \"t_ms\": %.3f", n ? ", " : "", i,
+                    (double)(g_shots[i].t_us - REPLAY_START_US) / 1000.0);
+            if (g_labeled) fprintf(f, ", \"label\": \"%c\"", g_shots[i].label);
+            fprintf(f, ", \"got\": \"");
+            for (int v = 0; v < VARIANT_COUNT; v++) fputc(g_res[v].cls[i], f);
+            fprintf(f, "\"}");
+        }
+        n++;
+    }
+    fprintf(f, "],\n  \"disagree_count\": %d,\n", n);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-l labels] [-o out.json] [-v] trace.(log|bin)\n", prog);
+    fprintf(stderr, "       %s -s shots[:seed] [-w trace.bin] [-o out.json] [-v]\n", prog);
+    fprintf(stderr, "  trace : sub_pcb_mnq 'd' 덤프가 담긴 시리얼 로그 또는 바이너리\n");
+    fprintf(stderr, "  labels: 탄마다 h/b/n (파일, 공백 무시)\n");
+}
+
+int main(int argc, char **argv) {
+    const char *trace_path = NULL;
+    const char *label_path = NULL;
+    const char *out_path = NULL;
+    const char *write_path = NULL;
+    int synth_shots = 0;
+    bool verbose = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-l") && i + 1 < argc) {
+            label_path = argv[++i];
+        } else if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (!strcmp(argv[i], "-w") && i + 1 < argc) {
+            write_path = argv[++i];
+        } else if (!strcmp(argv[i], "-s") && i + 1 < argc) {
+            char *colon;
+            synth_shots = (int)strtol(argv[++i], &colon, 0);
+            if (*colon == ':') g_rand = (uint32_t)strtoul(colon + 1, NULL, 0);
+        } else if (!strcmp(argv[i], "-v")) {
+            verbose = true;
+        } else if (argv[i][0] != '-' && !trace_path) {
+            trace_path = argv[i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!trace_path == !synth_shots) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    uint8_t *bin = NULL;
+    size_t bin_len = 0;
+    char *labels = NULL;
+    const char *trace_name = trace_path;
+
+    if (synth_shots > 0) {
+        bin = trace_synth(synth_shots, &bin_len, &labels);
+        trace_name = "synthetic";
+        if (write_path) {
+            FILE *f = fopen(write_path, "wb");
+            if (!f || fwrite(bin, 1, bin_len, f) != bin_len) {
+                perror(write_path);
+                return 2;
+            }
+            fclose(f);
+        }
+    } else {
+        size_t len;
+        uint8_t *raw = read_file(trace_path, &len);
+        if (!raw) return 2;
+        if (len >= 4 && gpio_trace_get_le(raw, 4) == GPIO_TRACE_MAGIC) {
+            bin = raw;
+            bin_len = len;
+        } else {
+            bin = parse_hex_dump((const char *)raw, len, &bin_len);
+            free(raw);
+            if (!bin) {
+                fprintf(stderr, "%s: no complete TR BEGIN/END block\n", trace_path);
+                return 2;
+            }
+        }
+    }
+
+    if (!trace_decode(bin, bin_len)) return 2;
+    shots_build();
+
+    if (label_path) {
+        size_t len;
+        uint8_t *raw = read_file(label_path, &len);
+        if (!raw) return 2;
+        raw = realloc(raw, len + 1);
+        raw[len] = 0;
+        labels = (char *)raw;
+    }
+    if (labels && !labels_apply(labels)) return 2;
+
+    // 펌웨어마다 fork, 동시에 재생
+    pid_t pid[VARIANT_COUNT];
+    int fd[VARIANT_COUNT];
+    fflush(NULL);
+    for (int v = 0; v < VARIANT_COUNT; v++) {
+        int p[2];
+        if (pipe(p) < 0) {
+            perror("pipe");
+            return 2;
+        }
+        pid[v] = fork();
+        if (pid[v] < 0) {
+            perror("fork");
+            return 2;
+        }
+        if (pid[v] == 0) {
+            close(p[0]);
+            for (int k = 0; k < v; k++) close(fd[k]);
+            _exit(g_variants[v].run(g_edges, g_edge_n, g_end_us, p[1]));
+        }
+        close(p[1]);
+        fd[v] = p[0];
+    }
+
+    int fail = 0;
+    for (int v = 0; v < VARIANT_COUNT; v++) {
+        read_all(fd[v], &g_res[v]);
+        close(fd[v]);
+        int status = 0;
+        waitpid(pid[v], &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || !g_res[v].ok) {
+            fprintf(stderr, "%s replay failed\n", g_variants[v].name);
+            fail = 1;
+        }
+        evaluate(&g_variants[v], &g_res[v]);
+    }
+
+    if (verbose) {
+        fprintf(stderr, "shot  t_ms        label");
+        for (int v = 0; v < VARIANT_COUNT; v++) fprintf(stderr, "  %s", g_variants[v].name);
+        fprintf(stderr, "\n");
+        for (int i = 0; i < g_shot_n; i++) {
+            fprintf(stderr, "%4d  %10.3f  %c    ", i, (double)(g_shots[i].t_us - REPLAY_START_US) / 1000.0,
+                    g_labeled ? g_shots[i].label : '-');
+            for (int v = 0; v < VARIANT_COUNT; v++) fprintf(stderr, "  %-16c", g_res[v].cls[i]);
+            fprintf(stderr, "\n");
+        }
+    }
+
+    FILE *out = out_path ? fopen(out_path, "w") : stdout;
+    if (!out) {
+        perror(out_path);
+        return 2;
+    }
+    fprintf(out, "{\"bench\": \"trace_replay\", \"trace\": \"%s\", \"bytes\": %zu, \"edges\": %d, \"duration_ms\": %.3f, \"shots\": %d, \"labeled\": %s,\n",
+            trace_name, bin_len, g_edge_n - g_hdr.ch_count, (double)(g_end_us - REPLAY_START_US) / 1000.0,
+            g_shot_n, g_labeled ? "true" : "false");
+    json_disagree(out);
+    fprintf(out, "  \"results\": [\n");
+    for (int v = 0; v < VARIANT_COUNT; v++) {
+        if (v) fprintf(out, ",\n");
+        json_result(out, &g_variants[v], &g_res[v]);
+    }
+    fprintf(out, "\n]}\n");
+    if (out != stdout) fclose(out);
+
+    return fail;
+}
@@ -0,0 +1,43 @@
+#ifndef TRACE_REPLAY_H
+#define TRACE_REPLAY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+trace_replay 공용 정의
+- trace_replay.c    : trace 읽기/합성, 탄 구간 분할, 판정, JSON
+- trace_replay_fw.c : 탄 감지 펌웨어 1개를 include 해서 엣지 목록을 재생 (펌웨어마다 따로 컴파일)
+*/
+
+// 부팅(StartSignal 4s) 후 trace 0 시각
+#define REPLAY_START_US         5000000u
+
+// 마지막 엣지 후 출력 대기
+#define REPLAY_TAIL_US          200000u
+
+// 재생할 입력 엣지 (부팅 기준 시각)
+typedef struct {
+    uint64_t t_us;
+    uint8_t  pin;
+    bool     level;
+} replay_edge_t;
+
+// 자식 → 부모 pipe 메시지
+#define REPLAY_MSG_HIT          0u      // t_us = HIT 상승 시각, pin = HIT 핀
+#define REPLAY_MSG_DONE         1u      // t_us = 재생에 걸린 wall time (us)
+
+typedef struct {
+    uint64_t t_us;
+    uint32_t pin;
+    uint32_t kind;
+} replay_msg_t;
+
+// 펌웨어별 재생 (fork된 자식에서 호출, 결과는 fd로 replay_msg_t)
+typedef int (*replay_fw_fn)(const replay_edge_t *edges, int n, uint64_t end_us, int fd);
+
+int replay_fw_sub_pico_mnq_1(const replay_edge_t *edges, int n, uint64_t end_us, int fd);
+int replay_fw_sub_pico_mnq_2(const replay_edge_t *edges, int n, uint64_t end_us, int fd);
+int replay_fw_1ms_x_5times(const replay_edge_t *edges, int n, uint64_t end_us, int fd);
+
+#endif
@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "trace_replay.h"
+
+/*
+trace 재생 : 탄 감지 펌웨어 1개 (REPLAY_FW_SRC / REPLAY_FW_ENTRY, CMake에서 지정)
+- 펌웨어 소스는 그대로 include, 엣지를 시각대로 넣고 HIT_1/2/3 상승엣지를 fd로 보냄
+- 가상 시계라 실제 시간보다 훨씬 빠르게 재생
+*/
+
+// 3종 object를 한 실행 파일로 링크하므로 entry는 파일 안에서만 (static 선언을 먼저 → 펌웨어의 int main도 static)
+static int replay_firmware_main(void);
+#define main replay_firmware_main
+#include REPLAY_FW_SRC
+#undef main
+
+// plant/측정 주기 (지연 측정 해상도)
+#define REPLAY_STEP_US          50u
+
+static const uint g_hit_pins[3] = { HIT_1, HIT_2, HIT_3 };
+
+static const replay_edge_t *g_edges;
+static int      g_edge_n = 0;
+static int      g_edge_i = 0;
+static uint64_t g_end_us = 0;
+static int      g_fd = -1;
+static bool     st_prev_hit[3];
+
+static void send_msg(uint32_t kind, uint32_t pin, uint64_t t_us) {
+    replay_msg_t m = { t_us, pin, kind };
+    if (write(g_fd, &m, sizeof(m)) != (ssize_t)sizeof(m)) sim_stop();
+}
+
+static uint64_t replay_step(uint64_t now) {
+    while (g_edge_i < g_edge_n && g_edges[g_edge_i].t_us <= now) {
+        sim_gpio_drive(g_edges[g_edge_i].pin, g_edges[g_edge_i].level);
+        g_edge_i++;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        bool hit = sim_gpio_out(g_hit_pins[i]);
+        if (hit && !st_prev_hit[i]) send_msg(REPLAY_MSG_HIT, g_hit_pins[i], now);
+        st_prev_hit[i] = hit;
+    }
+
+    if (now >= g_end_us) sim_stop();
+
+    uint64_t next = now + REPLAY_STEP_US;
+    if (g_edge_i < g_edge_n && g_edges[g_edge_i].t_us < next) next = g_edges[g_edge_i].t_us;
+    return next;
+}
+
+int REPLAY_FW_ENTRY(const replay_edge_t *edges, int n, uint64_t end_us, int fd) {
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    g_edges = edges;
+    g_edge_n = n;
+    g_edge_i = 0;
+    g_end_us = end_us;
+    g_fd = fd;
+
+    sim_reset();
+    sim_set_plant(replay_step);
+    sim_run(replay_firmware_main);
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    uint64_t wall_us = (uint64_t)(t1.tv_sec - t0.tv_sec) * 1000000u + (uint64_t)((t1.tv_nsec - t0.tv_nsec) / 1000);
+    send_msg(REPLAY_MSG_DONE, 0, wall_us);
+    return g_edge_i >= g_edge_n ? 0 : 1;
+}
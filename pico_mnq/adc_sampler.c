@@ -0,0 +1,144 @@
+#include "adc_sampler.h"
+#include "hardware/adc.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/sync.h"
+#include <stdio.h>
+
+// overrun 뒤 다시 읽기 시작할 위치 : 최신 샘플에서 ring 절반 전 (바로 덮어써질 가장 오래된 샘플은 버림)
+#define ADC_SAMPLER_RESYNC      (ADC_SAMPLER_RING_SAMPLES / 2u)
+
+// ADC 변환 1회 최소 클럭 (clk_adc 48 MHz → 500 kS/s)
+#define ADC_SAMPLER_MIN_CYCLES  96u
+
+static uint16_t g_ring[ADC_SAMPLER_RING_SAMPLES] __attribute__((aligned(1u << ADC_SAMPLER_RING_BITS)));
+
+static int g_dma_ch[2] = { -1, -1 };
+static uint g_inputs = 1;
+static uint64_t g_t0_ns = 0;            // 시작 시각 (변환 0은 t0 + 주기에 끝남)
+static uint64_t g_period_ps = 0;        // 변환 간격 (ps)
+static uint64_t g_rd = 0;               // 다음에 읽을 변환 번호
+
+static uint64_t g_read = 0;             // 통계 : 읽은 샘플 수
+static uint32_t g_overrun = 0;          // 통계 : overrun 횟수
+static uint64_t g_lost = 0;             // 통계 : 버린 샘플 수
+
+bool adc_sampler_start(uint first, uint n, uint32_t rate_hz)
+{
+    uint32_t clk_hz = clock_get_hz(clk_adc);
+    if (n == 0 || first + n > 4u || rate_hz == 0) return false;
+    uint32_t cycles = (uint32_t)((clk_hz + (uint64_t)rate_hz * n / 2u) / ((uint64_t)rate_hz * n));
+    if (cycles < ADC_SAMPLER_MIN_CYCLES) return false;
+
+    g_dma_ch[0] = dma_claim_unused_channel(false);
+    g_dma_ch[1] = dma_claim_unused_channel(false);
+    if (g_dma_ch[0] < 0 || g_dma_ch[1] < 0) return false;
+
+    adc_init();
+    for (uint i = 0; i < n; i++) adc_gpio_init(26u + first + i);
+    adc_select_input(first);
+    adc_set_round_robin(n > 1u ? ((1u << n) - 1u) << first : 0u);
+    // FIFO 1개 차면 DREQ, 12bit 그대로 (byte shift 없음)
+    adc_fifo_setup(true, true, 1, false, false);
+    adc_set_clkdiv((float)(cycles - 1u));
+
+    // 두 채널 모두 같은 ring에 1바퀴씩 쓰고 서로 chain → 끝난 채널은 write 주소가 ring 처음으로 돌아와 있음
+    for (uint k = 0; k < 2u; k++) {
+        dma_channel_config c = dma_channel_get_default_config((uint)g_dma_ch[k]);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+        channel_config_set_read_increment(&c, false);
+        channel_config_set_write_increment(&c, true);
+        channel_config_set_ring(&c, true, ADC_SAMPLER_RING_BITS);
+        channel_config_set_dreq(&c, DREQ_ADC);
+        channel_config_set_chain_to(&c, (uint)g_dma_ch[k ^ 1u]);
+        dma_channel_configure((uint)g_dma_ch[k], &c, g_ring, &adc_hw->fifo, ADC_SAMPLER_RING_SAMPLES, false);
+    }
+
+    g_inputs = n;
+    g_period_ps = (uint64_t)cycles * 1000000000000ull / clk_hz;
+    g_rd = 0;
+
+    uint32_t irq_state = save_and_disable_interrupts();
+    dma_channel_start((uint)g_dma_ch[0]);
+    g_t0_ns = time_us_64() * 1000u;
+    adc_run(true);
+    restore_interrupts(irq_state);
+
+    adc_sampler_reset();
+    return true;
+}
+
+uint64_t adc_sampler_index_at(uint64_t t_us)
+{
+    uint64_t t_ns = t_us * 1000u;
+    if (g_period_ps == 0 || t_ns < g_t0_ns) return 0;
+    return (t_ns - g_t0_ns) * 1000u / g_period_ps;
+}
+
+uint64_t adc_sampler_time_us(uint64_t idx)
+{
+    return (g_t0_ns + (idx + 1u) * g_period_ps / 1000u) / 1000u;
+}
+
+uint adc_sampler_inputs(void)
+{
+    return g_inputs;
+}
+
+uint32_t adc_sampler_period_ns(void)
+{
+    return (uint32_t)(g_period_ps / 1000u);
+}
+
+// 지금까지 기록된 샘플 수 : ring 안 위치(DMA write 주소)는 정확, 몇 바퀴째인지는 시각으로 (gpio_sampler.c와 같음)
+static uint64_t sampler_written(void)
+{
+    uint64_t est = adc_sampler_index_at(time_us_64());
+
+    uint ch = dma_channel_is_busy((uint)g_dma_ch[1]) ? (uint)g_dma_ch[1] : (uint)g_dma_ch[0];
+    uint32_t pos = (uint32_t)((dma_channel_hw_addr(ch)->write_addr - (uintptr_t)g_ring) / sizeof(uint16_t));
+
+    int32_t d = (int32_t)((pos - (uint32_t)est) & (ADC_SAMPLER_RING_SAMPLES - 1u));
+    if (d >= (int32_t)(ADC_SAMPLER_RING_SAMPLES / 2u)) d -= (int32_t)ADC_SAMPLER_RING_SAMPLES;
+    if (d < 0 && (uint64_t)-d > est) return 0;
+    return est + (uint64_t)(int64_t)d;
+}
+
+uint32_t adc_sampler_read(const uint16_t **samples, uint64_t *idx)
+{
+    if (g_dma_ch[0] < 0) return 0;
+
+    uint64_t wr = sampler_written();
+    if (wr <= g_rd) return 0;
+    if (wr - g_rd > ADC_SAMPLER_RING_SAMPLES - ADC_SAMPLER_RESYNC / 2u) {
+        uint64_t rd = wr - ADC_SAMPLER_RESYNC;
+        g_overrun++;
+        g_lost += rd - g_rd;
+        g_rd = rd;
+    }
+
+    uint32_t at = (uint32_t)g_rd & (ADC_SAMPLER_RING_SAMPLES - 1u);
+    uint32_t n = ADC_SAMPLER_RING_SAMPLES - at;
+    if ((uint64_t)n > wr - g_rd) n = (uint32_t)(wr - g_rd);
+
+    *samples = &g_ring[at];
+    *idx = g_rd;
+    g_rd += n;
+    g_read += n;
+    return n;
+}
+
+void adc_sampler_reset(void)
+{
+    g_read = 0;
+    g_overrun = 0;
+    g_lost = 0;
+}
+
+void adc_sampler_dump(void)
+{
+    uint32_t ns = adc_sampler_period_ns() * g_inputs;
+    printf("adc sampler: %u input(s) x %lu Hz (%lu ns) read=%llu overrun=%lu lost=%llu\n",
+           g_inputs, (unsigned long)(ns ? 1000000000u / ns : 0), (unsigned long)ns,
+           (unsigned long long)g_read, (unsigned long)g_overrun, (unsigned long long)g_lost);
+}
@@ -0,0 +1,45 @@
+#ifndef ADC_SAMPLER_H
+#define ADC_SAMPLER_H
+
+#include "pico/stdlib.h"
+
+/*
+DMA ADC 연속 샘플러 : ADC free-running(round robin) 변환 결과를 DMA(DREQ_ADC)로 ring buffer에 계속 기록
+- gpio_sampler.c와 같은 구조 : DMA 채널 2개가 서로 chain (ring 1바퀴씩 번갈아), 샘플당 CPU 비용 없음
+- 입력 first ~ first + n - 1 (GPIO 26 + 입력)을 차례로 변환, 변환 간격은 clk_adc(48 MHz) 정수 분주라 정확
+- 변환 번호(전 입력 합산, 시작부터 0, 1, ...) k의 입력 = first + k % n
+- 읽는 쪽은 poll로 새 샘플을 block 단위로 꺼냄 (current_sense.h 등으로 입력마다 판정)
+- ring 1바퀴(ADC_SAMPLER_RING_SAMPLES 변환) 안에 다시 읽지 않으면 overrun : 오래된 샘플을 버리고 번호가 건너뜀
+*/
+
+// ring 크기 (byte = 1 << bits, DMA write ring 정렬), 11 = 1024 샘플 (10 kHz에서 102 ms)
+#ifndef ADC_SAMPLER_RING_BITS
+#define ADC_SAMPLER_RING_BITS   11u
+#endif
+
+#define ADC_SAMPLER_RING_SAMPLES ((1u << ADC_SAMPLER_RING_BITS) / 2u)
+
+// 입력마다 rate_hz로 시작 (변환 간격 = clk_adc / (rate_hz × n) 반올림, 96 클럭 이상)
+// DMA 채널이 없거나 입력 범위 / rate가 맞지 않으면 false
+bool adc_sampler_start(uint first, uint n, uint32_t rate_hz);
+
+// 아직 안 읽은 샘플 중 ring에서 이어진 구간 하나 (ring 끝에서 잘림 → 0이 나올 때까지 반복)
+// *idx = 첫 변환 번호, 반환 = 샘플 수. 꺼낸 구간은 다음 호출 전에 처리할 것 (DMA가 1바퀴 뒤 덮어씀)
+uint32_t adc_sampler_read(const uint16_t **samples, uint64_t *idx);
+
+// 시각 → 그 시각까지 끝난 변환 수 (다음 변환 번호)
+uint64_t adc_sampler_index_at(uint64_t t_us);
+
+// 변환 번호 → 그 변환이 끝난 시각 (us)
+uint64_t adc_sampler_time_us(uint64_t idx);
+
+// 입력 수 (변환 번호 → 입력, 입력별 샘플 번호 계산용)
+uint adc_sampler_inputs(void);
+
+// 변환 간격 (ns, 입력 1개의 샘플 간격은 × 입력 수)
+uint32_t adc_sampler_period_ns(void);
+
+void adc_sampler_reset(void);
+void adc_sampler_dump(void);
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef CURRENT_SENSE_H
+#define CURRENT_SENSE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+모터 전류 stall 검출기 : 일정 간격 ADC 샘플(전류, count)을 하나씩 넣어 stall(걸림 / 끝 도착) 판정
+- 스트로크마다 arm (시작 샘플 번호) → 판정이 나오거나 disarm할 때까지 판정, 판정은 스트로크당 1번 (나오면 disarm)
+- arm 뒤 blank_n 샘플은 판정 안 함 (돌입 전류), 그 뒤 기준 = 지수 평균 (1 / 2^avg_shift, 넘는 샘플은 평균에 안 넣음)
+- 넘음 = stall_level 이상 (절대 과전류) 또는 기준 + rise 이상 (모터가 멈춰서 역기전력이 없어짐)
+  넘는 샘플이 confirm_n개 연속이면 판정 (잡음 1~2 샘플은 무시)
+- arm 뒤 최대 전류 (돌입 포함 / 돌입 뒤) 기록
+- 샘플 번호는 채널 기준 (0, 1, ...), arm 번호보다 앞선 샘플은 무시 (DMA ring에서 늦게 꺼낸 지난 샘플)
+- pico-sdk 의존 없음 → host 도구에서 합성/캡처 trace로 그대로 검증 (host/bench_current.c)
+(header only)
+*/
+
+typedef struct {
+    uint16_t blank_n;           // arm 뒤 판정 안 하는 샘플 수
+    uint16_t stall_level;       // 절대 기준 (count), 0 = 안 씀
+    uint16_t rise;              // 기준보다 이만큼 높으면 (count), 0 = 안 씀
+    uint16_t confirm_n;         // 연속 샘플 수 (1 이상)
+    uint8_t  avg_shift;         // 기준 평균 1 / 2^shift
+} csense_cfg_t;
+
+typedef enum {
+    CSENSE_NONE = 0,
+    CSENSE_STALL,               // 절대 기준
+    CSENSE_RISE                 // 기준 + rise
+} csense_kind_t;
+
+typedef struct {
+    csense_kind_t kind;
+    uint64_t idx;               // 판정 샘플 (연속 구간 마지막)
+    uint64_t over_idx;          // 연속 구간 첫 샘플 (stall 시작)
+    uint16_t level;             // 판정 샘플 값
+    uint16_t base;              // 그때 기준
+} csense_event_t;
+
+typedef struct {
+    csense_cfg_t cfg;
+    bool     armed;
+    uint64_t from;              // arm 샘플 번호
+    bool     avg_valid;
+    uint32_t avg_q;             // 기준 << avg_shift
+    uint16_t over_n;
+    uint64_t over_idx;
+    uint16_t peak;              // arm 뒤 최대 (돌입 포함)
+    uint16_t run_peak;          // blank 뒤 최대
+} csense_t;
+
+static inline void csense_init(csense_t *d, const csense_cfg_t *cfg) {
+    d->cfg = *cfg;
+    if (d->cfg.confirm_n == 0) d->cfg.confirm_n = 1;
+    d->armed = false;
+    d->avg_valid = false;
+    d->avg_q = 0;
+    d->peak = 0;
+    d->run_peak = 0;
+}
+
+// 스트로크 시작 : idx부터 판정, 최대 전류 다시
+static inline void csense_arm(csense_t *d, uint64_t idx) {
+    d->armed = true;
+    d->from = idx;
+    d->avg_valid = false;
+    d->avg_q = 0;
+    d->over_n = 0;
+    d->peak = 0;
+    d->run_peak = 0;
+}
+
+static inline void csense_disarm(csense_t *d) {
+    d->armed = false;
+}
+
+// 지금 기준 (blank 뒤 첫 샘플 전이면 0)
+static inline uint16_t csense_base(const csense_t *d) {
+    return d->avg_valid ? (uint16_t)(d->avg_q >> d->cfg.avg_shift) : 0u;
+}
+
+// 샘플 1개 (번호 idx, 값 v), 판정이 나오면 *ev에 쓰고 true (그 뒤로는 disarm)
+static inline bool csense_sample(csense_t *d, uint64_t idx, uint16_t v, csense_event_t *ev) {
+    if (!d->armed || idx < d->from) return false;
+    if (v > d->peak) d->peak = v;
+    if (idx - d->from < d->cfg.blank_n) return false;
+    if (v > d->run_peak) d->run_peak = v;
+
+    if (!d->avg_valid) {
+        d->avg_q = (uint32_t)v << d->cfg.avg_shift;
+        d->avg_valid = true;
+    }
+    uint16_t base = csense_base(d);
+    bool stall = d->cfg.stall_level && v >= d->cfg.stall_level;
+    bool rise = d->cfg.rise && (uint32_t)v >= (uint32_t)base + d->cfg.rise;
+
+    if (!stall && !rise) {
+        d->over_n = 0;
+        d->avg_q += v;
+        d->avg_q -= base;
+        return false;
+    }
+
+    if (d->over_n == 0) d->over_idx = idx;
+    if (++d->over_n < d->cfg.confirm_n) return false;
+
+    ev->kind = stall ? CSENSE_STALL : CSENSE_RISE;
+    ev->idx = idx;
+    ev->over_idx = d->over_idx;
+    ev->level = v;
+    ev->base = base;
+    d->armed = false;
+    return true;
+}
+
+// 샘플 s[0], s[stride], ... n개 (번호 idx부터 연속, round robin ADC ring의 한 입력 등)
+// 판정이 나오면 *ev에 쓰고 true (나머지 샘플은 disarm 상태라 버림)
+static inline bool csense_feed(csense_t *d, const uint16_t *s, uint32_t n, uint32_t stride, uint64_t idx,
+                               csense_event_t *ev) {
+    for (uint32_t i = 0; i < n && d->armed; i++) {
+        if (csense_sample(d, idx + i, s[(uint64_t)i * stride], ev)) return true;
+    }
+    return false;
+}
+
+#endif
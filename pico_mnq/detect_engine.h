@@ -0,0 +1,901 @@
+#ifndef DETECT_ENGINE_H
+#define DETECT_ENGINE_H
+
+// 0 = HIT 핀 펄스만, 1 = HIT 핀 펄스 + UART frame, 2 = UART frame만 (설명은 아래)
+#ifndef DETECT_HIT_LINK
+#define DETECT_HIT_LINK                 0
+#endif
+
+// 1 = P1/P2 판정을 DMA 연속 샘플 + block 판정으로 (설명은 아래)
+#ifndef DETECT_SAMPLER
+#define DETECT_SAMPLER                  0
+#endif
+
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/gpio.h"
+#include "hardware/sync.h"
+#include <stdio.h>
+
+#include "hit_pulse.h"
+#include "edge_ring.h"
+#include "hit_stats.h"
+#include "vcount.h"
+#include "irq_guard.h"
+#include "idle_sleep.h"
+#include "param_store.h"
+#if DETECT_HIT_LINK
+#include "hit_link.h"
+#endif
+#if DETECT_SAMPLER
+#include "gpio_sampler.h"
+#include "sample_decode.h"
+#endif
+
+/*
+탄 감지 엔진 (sub_pico_mnq_1.c / sub_pico_mnq_2.c / ../1ms_x_5times.c 공용)
+- 펌웨어 파일은 설정 매크로만 정의하고 이 헤더를 include → main 포함 펌웨어 전체가 생성됨
+- 판정 방식/샘플 수/간격/핀 매핑은 모두 컴파일 시 상수, 방식 분기는 #if로 빌드 때 결정 (hot path에 런타임 분기 없음)
+
+DETECT_STRATEGY
+  DETECT_STRATEGY_P1P2_LEVEL : P1(DETECT_1)이 HIGH면 확인 시작 (sub_pico_mnq_1.c)
+  DETECT_STRATEGY_P1P2_EDGE  : P1 LOW → HIGH 상승엣지에서 확인 시작 (sub_pico_mnq_2.c)
+    두 방식 모두 P1 확정(DETECT_CONFIRM_SAMPLES회 연속 HIGH) → P1 LOW → P1_TO_P2_DELAY_US 후
+    P2(DETECT_2) P2_CHECK_SAMPLES회 모두 HIGH면 헤드샷(DETECT_HEAD_HIT) 아니면 몸통샷(DETECT_BODY_HIT), 이후 HIT_LOCKOUT_MS 락아웃
+    P1 양 엣지 IRQ + 샘플 alarm으로 진행 (sleep_us 대기 없음, main은 stdio만 보고 잠듦)
+    DETECT_SAMPLER 1 : PIO가 GPIO를 DETECT_SAMPLER_HZ로 샘플, DMA가 RX FIFO에서 ring에 계속 기록 (gpio_sampler.c)
+                       main이 poll마다 새 샘플 block을 한 번에 판정 (sample_decode.h, 같은 판정 순서를 샘플 단위로)
+                       IRQ 없음, DETECT_SAMPLER_POLL_US = 엣지 대기 중 poll 주기 (확인/P2 단계는 예약 샘플 직후에 깨어남)
+  DETECT_STRATEGY_CHANNEL    : 채널별 독립 디바운스 (../1ms_x_5times.c)
+    IRQ 상승엣지 → 채널 arm → DETECT_SAMPLE_US마다 gpio_get_all() 1회로 armed 채널 모두 샘플 (세로 카운터, vcount.h)
+    DETECT_CONFIRM_SAMPLES회 연속 HIGH면 그 채널 HIT (최대 VCOUNT_MAX회)
+    상승엣지 IRQ 뒤 DETECT_IRQ_HOLDOFF_US 동안 그 핀 IRQ 끔 (irq_guard.c, 잡음 폭주 시 ISR 부하 상한)
+    채널 = DETECT_CHANNELS(X) 목록의 X(입력 핀, HIT 핀, 통계 이름)
+
+공통 : DETECT_CONFIRM_SAMPLES, DETECT_CONFIRM_INTERVAL_US, HIT_PULSE_US, HIT_MIN_GAP_US,
+       STAT_EDGE_SHIFT, STAT_OUT_SHIFT (통계 히스토그램 bucket 폭 1 << shift us)
+       DETECT_IDLE_WFI : 1이면 할 일 없을 때 __wfi로 잠듦 (idle_sleep.c, 다음 샘플 또는 입력 IRQ에서 깨어남)
+                         0이면 예전처럼 tight_loop 회전, DETECT_IDLE_MAX_US = 한 번에 최대로 자는 시간
+       DETECT_HIT_LINK : HIT를 메인 PCB로 UART frame {seq, ch, type, t_us} + CRC로도 보냄 (hit_link.c, 형식은 hit_link_format.h)
+                         type = HIT 라인 번호(HIT_1 = 1), t_us = 샷 시각(판정을 시작시킨 엣지)
+                         1 : HIT 핀 펄스와 같이 보냄, 2 : UART만 (HIT 핀은 LOW 유지, confirm → out 통계는 frame 송출 시각)
+                         HIT_LINK_UART / HIT_LINK_TX_PIN / HIT_LINK_BAUD
+
+조정 파라미터 (param_store.c, flash 마지막 sector) : 위 판정 시간/횟수 매크로는 기본값, 판정 코드는 g_param을 바로 읽음
+  stdio 'p' 명령으로 바꾸면 다음 판정부터 적용, p save로 flash 저장 (기록 동안 ~1ms, erase 때 ~50ms 감지 멈춤)
+  p save는 요청만 하고 기록은 판정 중인 샷이 없는 상태가 DETECT_SAVE_QUIET_MS 동안 이어진 뒤 main에서
+  core1을 안 띄우므로 flash_safe_execute(lockout) 대신 인터럽트만 끄고 기록 (param_store single_core)
+  P1/P2 : confirm_samples, confirm_us, p2_samples, p2_us, p1_p2_delay_us, lockout_ms
+  채널  : confirm_samples (최대 VCOUNT_MAX), sample_us
+  HIT 펄스 폭 / IRQ holdoff / 링크 baud는 초기화 때만 쓰므로 매크로 그대로
+*/
+
+#define DETECT_STRATEGY_P1P2_LEVEL      1
+#define DETECT_STRATEGY_P1P2_EDGE       2
+#define DETECT_STRATEGY_CHANNEL         3
+
+#ifndef DETECT_STRATEGY
+#error "DETECT_STRATEGY must be defined before including detect_engine.h"
+#endif
+
+#define DETECT_IS_P1P2  (DETECT_STRATEGY == DETECT_STRATEGY_P1P2_LEVEL || DETECT_STRATEGY == DETECT_STRATEGY_P1P2_EDGE)
+
+#if !DETECT_IS_P1P2 && DETECT_STRATEGY != DETECT_STRATEGY_CHANNEL
+#error "unknown DETECT_STRATEGY"
+#endif
+
+// ------------ 보드 핀 (세 펌웨어 공통) ------------
+#ifndef LED
+#define LED             PICO_DEFAULT_LED_PIN
+#endif
+
+// 입력
+#define DETECT_1        3   // P1
+#define DETECT_2        4   // P2
+#define DETECT_3        5
+
+// 출력 (메인 MCU)
+#define HIT_1           12
+#define HIT_2           13
+#define HIT_3           14
+
+// ------------ 기본 파라미터 ------------
+#ifndef DETECT_CONFIRM_SAMPLES
+#define DETECT_CONFIRM_SAMPLES          5
+#endif
+#ifndef DETECT_CONFIRM_INTERVAL_US
+#define DETECT_CONFIRM_INTERVAL_US      1000    // 1ms
+#endif
+
+#ifndef HIT_PULSE_US
+#define HIT_PULSE_US                    10000   // 10ms
+#endif
+#ifndef HIT_MIN_GAP_US
+#define HIT_MIN_GAP_US                  5000    // 5ms
+#endif
+
+#ifndef DETECT_IDLE_WFI
+#define DETECT_IDLE_WFI                 1
+#endif
+#ifndef DETECT_IDLE_MAX_US
+#define DETECT_IDLE_MAX_US              10000   // 10ms (stdio 명령 확인 주기)
+#endif
+#ifndef DETECT_SAVE_QUIET_MS
+#define DETECT_SAVE_QUIET_MS            1000    // p save 기록 전 판정 없이 조용해야 하는 시간
+#endif
+
+#if DETECT_HIT_LINK
+#ifndef HIT_LINK_UART
+#define HIT_LINK_UART                   uart1
+#endif
+#ifndef HIT_LINK_TX_PIN
+#define HIT_LINK_TX_PIN                 8       // UART1 TX
+#endif
+#ifndef HIT_LINK_BAUD
+#define HIT_LINK_BAUD                   1000000 // 1 Mbaud : 1 record frame 130us
+#endif
+#endif
+
+// HIT 핀 → 라인 번호 (link record type)
+#define HIT_LINE_NO(pin)                ((pin) - HIT_1 + 1)
+
+#ifndef STAT_OUT_SHIFT
+#define STAT_OUT_SHIFT                  6       // confirm → HIT : 64us 폭 (~1ms)
+#endif
+
+#if DETECT_IS_P1P2
+#ifndef P2_CHECK_SAMPLES
+#define P2_CHECK_SAMPLES                2
+#endif
+#ifndef P2_CHECK_INTERVAL_US
+#define P2_CHECK_INTERVAL_US            1000    // 1ms
+#endif
+#ifndef P1_TO_P2_DELAY_US
+#define P1_TO_P2_DELAY_US               1000    // 1ms
+#endif
+// 연속 트리거 방어(락아웃). 0이면 비활성
+#ifndef HIT_LOCKOUT_MS
+#define HIT_LOCKOUT_MS                  50
+#endif
+#ifndef DETECT_HEAD_HIT
+#define DETECT_HEAD_HIT                 HIT_1   // 헤드샷용 출력
+#endif
+#ifndef DETECT_BODY_HIT
+#define DETECT_BODY_HIT                 HIT_2   // 몸통샷용 출력
+#endif
+#ifndef STAT_EDGE_SHIFT
+#define STAT_EDGE_SHIFT                 10      // edge → confirm : 1024us 폭 (~16ms)
+#endif
+#ifndef DETECT_SAMPLER_HZ
+#define DETECT_SAMPLER_HZ               20000   // 50us 간격
+#endif
+#ifndef DETECT_SAMPLER_POLL_US
+#define DETECT_SAMPLER_POLL_US          1000    // 1ms (P1 확인 창보다 짧게, ring 1바퀴보다 짧게)
+#endif
+#else
+#if DETECT_SAMPLER
+#error "DETECT_SAMPLER is for the P1/P2 strategies"
+#endif
+#ifndef DETECT_CHANNELS
+#error "DETECT_STRATEGY_CHANNEL needs DETECT_CHANNELS(X)"
+#endif
+#ifndef STAT_EDGE_SHIFT
+#define STAT_EDGE_SHIFT                 9       // edge → confirm : 512us 폭 (~8ms)
+#endif
+// 샘플 tick (전 채널 공통)
+#ifndef DETECT_SAMPLE_US
+#define DETECT_SAMPLE_US                DETECT_CONFIRM_INTERVAL_US
+#endif
+// main loop 1회에 꺼내는 최대 이벤트 수
+#ifndef EDGE_DRAIN_BATCH
+#define EDGE_DRAIN_BATCH                8u
+#endif
+// 상승엣지 IRQ 뒤 그 핀 IRQ를 끄는 시간 (0이면 guard 없음), 확인 창(SAMPLES tick)보다 짧게
+#ifndef DETECT_IRQ_HOLDOFF_US
+#define DETECT_IRQ_HOLDOFF_US           1000    // 1ms
+#endif
+#endif
+
+// ------------ 조정 파라미터 ------------
+// X(이름, 기본값, min, max)
+#if DETECT_IS_P1P2
+#define DETECT_PARAMS(X) \
+    X(confirm_samples,  DETECT_CONFIRM_SAMPLES,     1,      20) \
+    X(confirm_us,       DETECT_CONFIRM_INTERVAL_US, 100,    10000) \
+    X(p2_samples,       P2_CHECK_SAMPLES,           1,      20) \
+    X(p2_us,            P2_CHECK_INTERVAL_US,       100,    10000) \
+    X(p1_p2_delay_us,   P1_TO_P2_DELAY_US,          0,      20000) \
+    X(lockout_ms,       HIT_LOCKOUT_MS,             0,      1000)
+#else
+#define DETECT_PARAMS(X) \
+    X(confirm_samples,  DETECT_CONFIRM_SAMPLES,     1,      VCOUNT_MAX) \
+    X(sample_us,        DETECT_SAMPLE_US,           100,    10000)
+#endif
+
+typedef union {
+    struct { DETECT_PARAMS(PARAM_FIELD) };
+    uint32_t v[0 DETECT_PARAMS(PARAM_ONE)];
+} detect_param_t;
+
+static detect_param_t g_param;
+static const param_desc_t g_param_desc[] = { DETECT_PARAMS(PARAM_DESC) };
+static param_store_t g_param_store;
+
+static void ConfigureGpio(void);
+static void StartSignal(void);
+static void detect_start(void);
+static void detect_poll(void);
+static void detect_idle(void);
+static void detect_param_service(void);
+#if DETECT_HIT_LINK == 2
+static void on_link_tx(uint ch, uint64_t t_us);
+#else
+static void on_hit_raise(uint pin, uint64_t t_us);
+#endif
+
+int main(void)
+{
+    stdio_init_all();
+    sleep_ms(10);
+
+    set_sys_clock_khz(125000, true);
+    busy_wait_ms(100);
+
+    // 조정 파라미터 (없으면 매크로 기본값)
+    param_store_init(&g_param_store, PARAM_STORE_FLASH_OFFSET, g_param_desc, g_param.v,
+                     sizeof(g_param_desc) / sizeof(g_param_desc[0]), NULL, 0);
+    g_param_store.single_core = true;
+    param_store_load(&g_param_store);
+
+    ConfigureGpio();
+    sleep_ms(10);
+
+    StartSignal();
+    sleep_ms(10);
+
+    detect_start();
+    while (true) {
+        detect_poll();
+        detect_param_service();
+        detect_idle();
+    }
+
+    return 0;
+}
+
+static void StartSignal(void)
+{
+    gpio_put(LED, 1);
+    sleep_ms(3000);
+    gpio_put(LED, 0);
+    sleep_ms(1000);
+}
+
+static void detect_input_init(uint pin)
+{
+    gpio_init(pin);
+    gpio_set_dir(pin, GPIO_IN);
+    gpio_pull_down(pin);
+}
+
+// 잠들기 (DETECT_IDLE_WFI), deadline_us : 다음에 poll 해야 하는 시각
+static void detect_sleep(uint64_t deadline_us, idle_pending_fn pending)
+{
+#if DETECT_IDLE_WFI
+    uint64_t max_us = time_us_64() + DETECT_IDLE_MAX_US;
+    if ((int64_t)(deadline_us - max_us) > 0) deadline_us = max_us;
+    if (!idle_sleep_until(deadline_us, pending)) tight_loop_contents();
+#else
+    (void)deadline_us;
+    (void)pending;
+    tight_loop_contents();
+#endif
+}
+
+// s / r 명령 때 같이 출력/초기화할 모듈 통계
+static void detect_extra_dump(void)
+{
+#if DETECT_IDLE_WFI
+    idle_sleep_dump();
+#endif
+#if DETECT_HIT_LINK
+    hit_link_dump();
+#endif
+#if DETECT_SAMPLER
+    gpio_sampler_dump();
+#endif
+}
+
+static void detect_extra_reset(void)
+{
+#if DETECT_IDLE_WFI
+    idle_sleep_reset();
+#endif
+#if DETECT_HIT_LINK
+    hit_link_reset();
+#endif
+#if DETECT_SAMPLER
+    gpio_sampler_reset();
+#endif
+}
+
+// s / r 외 stdio 문자 : p 명령 줄 (p save는 요청만, 기록은 detect_param_service)
+static bool detect_cmd(int c)
+{
+    return param_store_cli(&g_param_store, c);
+}
+
+static bool detect_busy(void);
+static uint64_t g_save_quiet_us = 0;    // 판정 중이 아닌 상태가 시작된 시각 (poll 때 본 것 기준)
+
+// p save 기록 : 인터럽트를 끄는 동안(~1ms, erase ~50ms) 감지가 멈추므로 판정 중인 샷이 없고
+// DETECT_SAVE_QUIET_MS 동안 조용할 때만 (sub_pcb_mnq가 모터가 멈췄을 때만 기록하는 것과 같은 방식)
+static void detect_param_service(void)
+{
+    uint64_t now = time_us_64();
+    if (!param_store_save_pending(&g_param_store) || detect_busy()) {
+        g_save_quiet_us = now;
+        return;
+    }
+    if (now - g_save_quiet_us < (uint64_t)DETECT_SAVE_QUIET_MS * 1000u) return;
+    param_store_service(&g_param_store);
+}
+
+static void detect_idle_init(void)
+{
+#if DETECT_IDLE_WFI
+    idle_sleep_init();
+#endif
+    hit_stats_set_extra(detect_extra_dump, detect_extra_reset);
+    hit_stats_set_cmd(detect_cmd);
+}
+
+// HIT 출력 (HIT 핀 펄스 초기화와 통계 hook 포함)
+static void detect_output_init(void)
+{
+    // HIT 출력: alarm 기반 펄스 스케줄러 (펄스 중에도 감지 계속)
+    hit_pulse_init(HIT_PULSE_US, HIT_MIN_GAP_US, LED);
+    hit_pulse_add_line(HIT_1);
+    hit_pulse_add_line(HIT_2);
+    hit_pulse_add_line(HIT_3);
+
+#if DETECT_HIT_LINK
+    hit_link_init(HIT_LINK_UART, HIT_LINK_TX_PIN, HIT_LINK_BAUD);
+#endif
+#if DETECT_HIT_LINK == 2
+    // 통계: record가 선로에 나간 시각
+    hit_link_set_hook(on_link_tx);
+#else
+    // 통계: HIT 핀이 실제로 올라간 시각을 hook으로 받음
+    hit_pulse_set_hook(on_hit_raise);
+#endif
+}
+
+// 메인 MCU로 HIT 전달 (비차단, 펄스 LOW는 alarm 콜백에서 / frame은 TX FIFO로), 실패하면 out_drop
+static void detect_report(uint ch, uint hit_pin, uint64_t shot_us)
+{
+    bool ok = true;
+#if DETECT_HIT_LINK != 2
+    ok = hit_pulse_fire(hit_pin);
+#endif
+#if DETECT_HIT_LINK
+    ok = hit_link_send(ch, HIT_LINE_NO(hit_pin), shot_us) && ok;
+#else
+    (void)shot_us;
+#endif
+    if (!ok) {
+        uint32_t irq_state = save_and_disable_interrupts();
+        hit_stats_out_drop(ch);
+        restore_interrupts(irq_state);
+    }
+}
+
+#if DETECT_HIT_LINK == 2
+// frame 송출 시각 → confirm → out 지연 기록 (alarm IRQ에서도 호출됨)
+static void on_link_tx(uint ch, uint64_t t_us)
+{
+    hit_stats_output(ch, t_us);
+}
+#endif
+
+#if DETECT_IS_P1P2
+#define STAT_CH_HEAD    0
+#define STAT_CH_BODY    1
+#define STAT_CH_COUNT   2
+
+static const char *const stat_names[STAT_CH_COUNT] = { "head", "body" };
+
+#if DETECT_SAMPLER
+// ------------ P1/P2 판정 (DMA 연속 샘플 + block 판정) ------------
+// PIO + DMA가 GPIO word를 DETECT_SAMPLER_HZ로 ring에 기록, main이 poll마다 새 샘플을 sample_decode.h로 한 번에 판정
+// 판정 순서는 IRQ + alarm 판정과 같고 단위만 샘플 (조정 파라미터 us → 샘플 수 반올림)
+// 엣지/판정 시각은 샘플 시각 그대로 (IRQ 지연 없음), HIT는 판정 샘플 뒤 첫 poll → 확인/P2 단계는 예약 샘플 직후로 깨어남
+// 입력 IRQ 없음 : 잡음이 많아도 CPU 부하는 poll당 샘플 수만큼으로 일정
+#define SAMPLER_HIT_BATCH       4u
+
+static sdec_t g_sdec;
+static uint32_t g_sdec_lockout = 0;     // 통계에 넘긴 락아웃 수 (g_sdec.lockout_rises까지)
+
+static uint32_t us_to_samples(uint32_t us, uint32_t period_ns)
+{
+    return (uint32_t)(((uint64_t)us * 1000u + period_ns / 2u) / period_ns);
+}
+
+static uint32_t us_to_step(uint32_t us, uint32_t period_ns)
+{
+    uint32_t n = us_to_samples(us, period_ns);
+    return n ? n : 1u;
+}
+
+// 조정 파라미터 → 샘플 수 (p 명령으로 바꾸면 다음 poll부터)
+static void sampler_cfg(sdec_cfg_t *c)
+{
+    uint32_t ns = gpio_sampler_period_ns();
+    c->p1_mask = 1u << DETECT_1;
+    c->p2_mask = 1u << DETECT_2;
+    c->edge = DETECT_STRATEGY == DETECT_STRATEGY_P1P2_EDGE;
+    c->confirm_n = g_param.confirm_samples;
+    c->confirm_step = us_to_step(g_param.confirm_us, ns);
+    c->p2_n = g_param.p2_samples;
+    c->p2_step = us_to_step(g_param.p2_us, ns);
+    c->delay = us_to_samples(g_param.p1_p2_delay_us, ns);
+    c->lockout = us_to_samples(g_param.lockout_ms * 1000u, ns);
+}
+
+// StartSignal 뒤 DMA 샘플링 시작 (LEVEL은 첫 샘플이 HIGH면 바로)
+static void detect_start(void)
+{
+    if (!gpio_sampler_start(DETECT_SAMPLER_HZ)) {
+        printf("sampler: no pio sm/dma channel or bad rate %u Hz\n", (unsigned)DETECT_SAMPLER_HZ);
+        return;
+    }
+    sdec_cfg_t cfg;
+    sampler_cfg(&cfg);
+    sdec_init(&g_sdec, &cfg, 0);
+}
+
+static void sampler_hit(const sdec_hit_t *h)
+{
+    uint ch = h->head ? STAT_CH_HEAD : STAT_CH_BODY;
+    uint64_t edge_us = gpio_sampler_time_us(h->edge_idx);
+    hit_stats_confirm(ch, edge_us, time_us_64());
+
+    // 메인 MCU로 신호 전달
+    detect_report(ch, h->head ? DETECT_HEAD_HIT : DETECT_BODY_HIT, edge_us);
+}
+
+// 새 샘플 block 판정 (overrun으로 번호가 건너뛰면 진행 중인 샷은 버리고 다시 대기)
+static void detect_poll(void)
+{
+    const uint32_t *s;
+    uint64_t idx;
+    uint32_t n;
+    sdec_hit_t hit[SAMPLER_HIT_BATCH];
+
+    hit_stats_poll(time_us_64());
+    sampler_cfg(&g_sdec.cfg);
+
+    while ((n = gpio_sampler_read(&s, &idx)) > 0) {
+        if (idx != g_sdec.pos) sdec_reset(&g_sdec, idx);
+        while (n > 0) {
+            uint64_t from = g_sdec.pos;
+            uint32_t k = sdec_feed(&g_sdec, s, n, hit, SAMPLER_HIT_BATCH);
+            uint32_t used = (uint32_t)(g_sdec.pos - from);
+            s += used;
+            n -= used;
+            for (uint32_t i = 0; i < k; i++) sampler_hit(&hit[i]);
+            for (; g_sdec_lockout != g_sdec.lockout_rises; g_sdec_lockout++) {
+                hit_stats_lockout(g_sdec.lockout_head ? STAT_CH_HEAD : STAT_CH_BODY);
+            }
+        }
+    }
+}
+
+// P1 상승 대기가 아니면 판정 중 (확인 / P2 / 락아웃)
+static bool detect_busy(void)
+{
+    return g_sdec.state != SDEC_WAIT_P1_RISE;
+}
+
+// 예약 샘플(확인 / P2 / 락아웃 끝)이 ring에 들어온 직후, 엣지 대기 중이면 poll 주기까지 잠듦
+static void detect_idle(void)
+{
+    uint64_t deadline = time_us_64() + DETECT_SAMPLER_POLL_US;
+    uint64_t next = sdec_next(&g_sdec);
+    if (next != UINT64_MAX) {
+        uint64_t t = gpio_sampler_time_us(next) + 1u;
+        if (t < deadline) deadline = t;
+    }
+    detect_sleep(deadline, NULL);
+}
+#else
+// ------------ P1/P2 판정 (IRQ + alarm, 비차단) ------------
+// P1 엣지 IRQ가 판정을 시작하고 확인 샘플 / P2 샘플은 alarm 1개를 다음 샘플 시각으로 재예약하며 진행
+// main은 stdio만 보고 나머지는 잠듦 (샷 하나에 core를 붙잡지 않음)
+// 샘플 시각은 예전 blocking 판정(sleep_us 루프)과 같음 → 같은 입력이면 같은 판정
+//   P1 확인 : 시작 t0, t0 + k × confirm_us (k < confirm_samples) 모두 HIGH면 t0 + confirm_samples × confirm_us에 확정
+//   확정 뒤 P1 하강엣지 tF → tF + p1_p2_delay_us부터 p2_us 간격 p2_samples회 P2, 락아웃은 첫 P2 샘플부터 lockout_ms
+// HIT는 판정이 정해진 샘플에서 바로 (몸통 = 첫 LOW, 헤드 = 마지막 HIGH), 예전처럼 마지막 샘플 뒤 p2_us를 더 기다리지 않음
+typedef enum {
+    ST_WAIT_P1_RISE = 0,
+    ST_CONFIRM_P1,
+    ST_WAIT_P1_FALL,
+    ST_DELAY_BEFORE_P2,
+    ST_CHECK_P2,
+    ST_LOCKOUT
+} hit_state_t;
+
+// GPIO IRQ / alarm 콜백에서만 바꿈 (같은 core, 같은 우선순위 → 서로 끼어들지 않음)
+static volatile hit_state_t g_state = ST_WAIT_P1_RISE;
+static uint64_t p1_edge_us = 0;         // 판정을 시작한 P1 엣지 시각
+static uint64_t p2_start_us = 0;        // 첫 P2 샘플 시각 (락아웃 기준)
+static uint64_t g_next_us = 0;          // alarm 예정 시각
+static uint32_t g_step_n = 0;           // 지금 단계의 샘플 수
+
+static uint64_t lockout_until_us = 0;
+static uint lockout_ch = STAT_CH_BODY;  // 락아웃을 건 히트의 채널
+
+static uint64_t p1_confirm_start(uint64_t t);
+
+// P1 상승 대기 (LEVEL은 P1이 이미 HIGH면 바로 확인 시작)
+static uint64_t p1_wait_rise(uint64_t t)
+{
+    g_state = ST_WAIT_P1_RISE;
+#if DETECT_STRATEGY == DETECT_STRATEGY_P1P2_LEVEL
+    if (gpio_get(DETECT_1)) return p1_confirm_start(t);
+#else
+    (void)t;
+#endif
+    return 0;
+}
+
+// 판정 확정 : 통계, HIT, 락아웃
+static uint64_t p1p2_decide(bool is_headshot, uint64_t t)
+{
+    uint ch = is_headshot ? STAT_CH_HEAD : STAT_CH_BODY;
+    hit_stats_confirm(ch, p1_edge_us, time_us_64());
+
+    // 메인 MCU로 신호 전달
+    detect_report(ch, is_headshot ? DETECT_HEAD_HIT : DETECT_BODY_HIT, p1_edge_us);
+
+    if (g_param.lockout_ms > 0) {
+        lockout_until_us = p2_start_us + (uint64_t)g_param.lockout_ms * 1000ULL;
+        lockout_ch = ch;
+        if (lockout_until_us > t) {
+            g_state = ST_LOCKOUT;
+            return lockout_until_us;
+        }
+    }
+    return p1_wait_rise(t);
+}
+
+// P2 확인 : p2_samples회 모두 HIGH면 헤드샷, LOW가 나오면 바로 몸통샷
+static uint64_t p2_sample(uint64_t t)
+{
+    if (g_step_n == 0) p2_start_us = t;
+    bool p2 = gpio_get(DETECT_2);
+    if (p2 && ++g_step_n < g_param.p2_samples) return t + g_param.p2_us;
+    return p1p2_decide(p2, t);
+}
+
+// P1 하강 (확정 뒤) → p1_p2_delay_us 뒤 P2 확인
+static uint64_t p1_fall(uint64_t t)
+{
+    g_step_n = 0;
+    if (g_param.p1_p2_delay_us == 0) {
+        g_state = ST_CHECK_P2;
+        return p2_sample(t);
+    }
+    g_state = ST_DELAY_BEFORE_P2;
+    return t + g_param.p1_p2_delay_us;
+}
+
+// P1 확인 샘플 : confirm_us 간격 confirm_samples회 연속 HIGH면 확정
+static uint64_t p1_confirm_sample(uint64_t t)
+{
+    if (g_step_n >= g_param.confirm_samples) {
+        // 확정 → P1 LOW 기다림 (이미 LOW면 바로)
+        g_state = ST_WAIT_P1_FALL;
+        return gpio_get(DETECT_1) ? 0 : p1_fall(t);
+    }
+    if (!gpio_get(DETECT_1)) return p1_wait_rise(t);
+    g_step_n++;
+    return t + g_param.confirm_us;
+}
+
+static uint64_t p1_confirm_start(uint64_t t)
+{
+    p1_edge_us = t;
+    g_step_n = 0;
+    g_state = ST_CONFIRM_P1;
+    return p1_confirm_sample(t);
+}
+
+// 예정 시각마다 지금 단계 처리, 다음 예정 시각으로 재예약 (음수 = 예정 시각 기준, 샘플 간격이 밀리지 않음)
+static int64_t p1p2_alarm_cb(alarm_id_t id, void *user_data)
+{
+    (void)id;
+    (void)user_data;
+    uint64_t at = g_next_us;
+    uint64_t next = 0;
+
+    switch (g_state) {
+    case ST_CONFIRM_P1:
+        next = p1_confirm_sample(at);
+        break;
+    case ST_DELAY_BEFORE_P2:
+        g_state = ST_CHECK_P2;
+        next = p2_sample(at);
+        break;
+    case ST_CHECK_P2:
+        next = p2_sample(at);
+        break;
+    case ST_LOCKOUT:
+        next = p1_wait_rise(at);
+        break;
+    default:
+        break;
+    }
+
+    if (next == 0) return 0;
+    g_next_us = next;
+    return -(int64_t)(next - at);
+}
+
+// IRQ에서 시작한 단계의 첫 alarm
+static void p1p2_schedule(uint64_t next)
+{
+    if (next == 0) return;
+    g_next_us = next;
+    if (add_alarm_at(from_us_since_boot(next), p1p2_alarm_cb, NULL, true) < 0) {
+        // alarm 슬롯 없음 → 이번 샷 버림
+        g_state = ST_WAIT_P1_RISE;
+    }
+}
+
+// P1 양 엣지 IRQ : 대기 상태에서만 단계 진행, 샘플 중 엣지는 무시 (샘플로 판정)
+static void p1_irq(uint gpio, uint32_t events)
+{
+    if (gpio != DETECT_1) return;
+    uint64_t t = time_us_64();
+
+    switch (g_state) {
+    case ST_WAIT_P1_RISE:
+        if (events & GPIO_IRQ_EDGE_RISE) p1p2_schedule(p1_confirm_start(t));
+        break;
+    case ST_WAIT_P1_FALL:
+        if (events & GPIO_IRQ_EDGE_FALL) p1p2_schedule(p1_fall(t));
+        break;
+    case ST_LOCKOUT:
+        // 락아웃 중 들어온 P1 상승은 버린 것으로 기록
+        if (events & GPIO_IRQ_EDGE_RISE) hit_stats_lockout(lockout_ch);
+        break;
+    default:
+        break;
+    }
+}
+
+// StartSignal 뒤 판정 시작 (LEVEL은 P1이 이미 HIGH면 바로)
+static void detect_start(void)
+{
+    gpio_set_irq_enabled_with_callback(DETECT_1, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true, &p1_irq);
+
+    uint32_t irq_state = save_and_disable_interrupts();
+    if (g_state == ST_WAIT_P1_RISE) p1p2_schedule(p1_wait_rise(time_us_64()));
+    restore_interrupts(irq_state);
+}
+
+// 판정은 IRQ에서 끝남 → main은 stdio만
+static void detect_poll(void)
+{
+    hit_stats_poll(time_us_64());
+}
+
+// P1 상승 대기가 아니면 판정 중 (확인 / P2 / 락아웃)
+static bool detect_busy(void)
+{
+    return g_state != ST_WAIT_P1_RISE;
+}
+
+// 다음 IRQ(P1 엣지, 샘플 alarm, HIT 펄스 alarm) 또는 stdio 확인 주기까지 잠듦
+static void detect_idle(void)
+{
+    detect_sleep(time_us_64() + DETECT_IDLE_MAX_US, NULL);
+}
+#endif
+
+static void ConfigureGpio(void)
+{
+    gpio_init(LED);
+    gpio_set_dir(LED, GPIO_OUT);
+    gpio_put(LED, 0);
+
+    // 입력(P1/P2)
+    detect_input_init(DETECT_1);
+    detect_input_init(DETECT_2);
+    detect_input_init(DETECT_3);
+    detect_idle_init();
+
+    hit_stats_init(stat_names, STAT_CH_COUNT, STAT_EDGE_SHIFT, STAT_OUT_SHIFT);
+    detect_output_init();
+}
+
+#if DETECT_HIT_LINK != 2
+// HIT 핀 HIGH 시각 → confirm → out 지연 기록 (alarm IRQ에서도 호출됨)
+static void on_hit_raise(uint pin, uint64_t t_us)
+{
+    if (pin == DETECT_HEAD_HIT)      hit_stats_output(STAT_CH_HEAD, t_us);
+    else if (pin == DETECT_BODY_HIT) hit_stats_output(STAT_CH_BODY, t_us);
+}
+#endif
+#else
+// ------------ 채널별 디바운스 (비차단, bit-parallel) ------------
+// 상승엣지가 들어오면 해당 채널 bit만 armed
+// sample_us마다 gpio_get_all() 1회로 armed 채널 전부를 세로 카운터로 동시에 샘플링
+// LOW가 한 번이라도 나오면 disarm, confirm_samples회 연속 HIGH면 그 채널 HIT
+// arm 후 첫 샘플은 다음 tick → 확정까지 최소 SAMPLES tick, 최대 SAMPLES + 1 tick (채널 수와 무관)
+typedef struct {
+    uint     detect_pin;
+    uint     hit_pin;
+    uint64_t edge_us;       // 확인을 시작시킨 상승엣지 시각
+} detect_ch_t;
+
+#define DETECT_CH_ENTRY(detect, hit, name)      { detect, hit, 0 },
+#define DETECT_CH_NAME(detect, hit, name)       name,
+#define DETECT_CH_MASK(detect, hit, name)       | (1u << (detect))
+
+static detect_ch_t g_ch[] = { DETECT_CHANNELS(DETECT_CH_ENTRY) };
+
+#define CH_COUNT        (sizeof(g_ch) / sizeof(g_ch[0]))
+#define DETECT_MASK     (0u DETECT_CHANNELS(DETECT_CH_MASK))
+
+#if DETECT_CONFIRM_SAMPLES < 1 || DETECT_CONFIRM_SAMPLES > VCOUNT_MAX
+#error "DETECT_CONFIRM_SAMPLES out of vertical counter range"
+#endif
+
+// 통계 채널 = g_ch 인덱스 (확인 중에 들어온 엣지는 lockout으로 기록)
+static const char *const stat_names[] = { DETECT_CHANNELS(DETECT_CH_NAME) };
+
+static uint8_t  g_pin_ch[32];           // GPIO → g_ch 인덱스
+static uint32_t g_armed = 0;            // 확인 중인 입력 bit
+static vcount_t g_cnt;                  // 연속 HIGH 샘플 수 (bit = GPIO)
+static uint64_t g_next_sample_us = 0;
+
+// ISR → main 엣지 이벤트 (시각 포함, 엣지가 합쳐지지 않음)
+static edge_ring_t g_edge_ring;
+
+static void gpio_irq_callback(uint gpio, uint32_t events)
+{
+    if (events & GPIO_IRQ_EDGE_RISE) {
+        edge_ring_push(&g_edge_ring, gpio, GPIO_IRQ_EDGE_RISE, time_us_64());
+        irq_guard_hold(gpio);
+    }
+}
+
+// holdoff 동안 걸러진 상승엣지 (alarm IRQ) : 아직 HIGH면 지금 시각으로 엣지 전달 (채터링 끝의 실제 펄스를 놓치지 않게)
+static void on_irq_suppressed(uint gpio, uint32_t latched, uint64_t t_us)
+{
+    hit_stats_irq_suppressed(g_pin_ch[gpio]);
+    if ((latched & GPIO_IRQ_EDGE_RISE) && gpio_get(gpio)) {
+        edge_ring_push(&g_edge_ring, gpio, GPIO_IRQ_EDGE_RISE, t_us);
+        irq_guard_hold(gpio);
+    }
+}
+
+static void ConfigureGpio(void)
+{
+    gpio_init(LED);
+    gpio_set_dir(LED, GPIO_OUT);
+    gpio_put(LED, 0);
+
+    detect_idle_init();
+    irq_guard_init(DETECT_IRQ_HOLDOFF_US);
+    irq_guard_set_hook(on_irq_suppressed);
+    for (uint i = 0; i < CH_COUNT; i++) {
+        g_pin_ch[g_ch[i].detect_pin] = (uint8_t)i;
+        detect_input_init(g_ch[i].detect_pin);
+        gpio_set_irq_enabled_with_callback(g_ch[i].detect_pin, GPIO_IRQ_EDGE_RISE, true, &gpio_irq_callback);
+        irq_guard_add_pin(g_ch[i].detect_pin, GPIO_IRQ_EDGE_RISE);
+    }
+
+    hit_stats_init(stat_names, CH_COUNT, STAT_EDGE_SHIFT, STAT_OUT_SHIFT);
+    detect_output_init();
+}
+
+// 채널 확인 시작 (이미 확인 중이면 lockout으로 기록)
+static void detect_arm(uint pin, uint64_t edge_us)
+{
+    uint32_t bit = 1u << pin;
+    uint ch = g_pin_ch[pin];
+
+    if (g_armed & bit) {
+        hit_stats_lockout(ch);
+        return;
+    }
+    g_armed |= bit;
+    vcount_clear(&g_cnt, bit);
+    g_ch[ch].edge_us = edge_us;
+}
+
+static void detect_fire(uint ch)
+{
+    hit_stats_confirm(ch, g_ch[ch].edge_us, time_us_64());
+    detect_report(ch, g_ch[ch].hit_pin, g_ch[ch].edge_us);
+}
+
+// 엣지 IRQ는 ConfigureGpio에서 이미 켜짐 (StartSignal 동안 들어온 엣지는 링에서 첫 poll 때 처리)
+static void detect_start(void)
+{
+}
+
+// 엣지 이벤트 → 채널 arm, tick마다 armed 채널 동시 샘플링, 확정되면 HIT 펄스 예약 (대기 없음)
+static void detect_poll(void)
+{
+    edge_event_t ev[EDGE_DRAIN_BATCH];
+    uint32_t ev_n = edge_ring_drain(&g_edge_ring, ev, EDGE_DRAIN_BATCH);
+
+    const uint64_t now_us = time_us_64();
+    hit_stats_poll(now_us);
+
+    const uint32_t was_armed = g_armed;
+    for (uint32_t e = 0; e < ev_n; e++) {
+        if ((DETECT_MASK >> ev[e].pin) & 1u) detect_arm(ev[e].pin, ev[e].t_us);
+    }
+
+    if ((int64_t)(now_us - g_next_sample_us) < 0) return;
+    if (was_armed == 0) {
+        // armed 채널 없이 지나간 tick(잠든 동안 포함)은 건너뜀 : tick 격자 유지, 방금 arm한 채널의 첫 샘플은 다음 tick
+        g_next_sample_us += ((now_us - g_next_sample_us) / g_param.sample_us + 1u) * g_param.sample_us;
+        return;
+    }
+    g_next_sample_us += g_param.sample_us;
+    if ((int64_t)(now_us - g_next_sample_us) >= 0) g_next_sample_us = now_us + g_param.sample_us;
+
+    if (g_armed == 0) return;
+
+    uint32_t high = gpio_get_all() & g_armed;
+    g_armed = high;                     // LOW가 나온 채널은 disarm
+    vcount_inc(&g_cnt, high);
+
+    uint32_t done = vcount_eq(&g_cnt, g_param.confirm_samples) & high;
+    g_armed &= ~done;
+    while (done) {
+        uint pin = (uint)__builtin_ctz(done);
+        done &= done - 1u;
+        detect_fire(g_pin_ch[pin]);
+    }
+}
+
+static bool edge_pending(void)
+{
+    return !edge_ring_empty(&g_edge_ring);
+}
+
+// 확인 중인 채널이나 아직 안 꺼낸 엣지가 있으면 판정 중
+static bool detect_busy(void)
+{
+    return g_armed != 0 || edge_pending();
+}
+
+// armed 채널이 있으면 다음 샘플 tick까지, 없으면 엣지 IRQ가 올 때까지 잠듦
+static void detect_idle(void)
+{
+    uint64_t deadline = g_armed ? g_next_sample_us : time_us_64() + DETECT_IDLE_MAX_US;
+    detect_sleep(deadline, edge_pending);
+}
+
+#if DETECT_HIT_LINK != 2
+// HIT 핀 HIGH 시각 → confirm → out 지연 기록 (alarm IRQ에서도 호출됨)
+static void on_hit_raise(uint pin, uint64_t t_us)
+{
+    for (uint i = 0; i < CH_COUNT; i++) {
+        if (g_ch[i].hit_pin == pin) {
+            hit_stats_output(i, t_us);
+            return;
+        }
+    }
+}
+#endif
+#endif
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef EDGE_RING_H
+#define EDGE_RING_H
+
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+/*
+GPIO 엣지 이벤트 링 버퍼 (lock-free, single producer / single consumer)
+- producer: gpio_irq_callback (ISR), consumer: main loop
+- ISR에서 {pin, edge, time_us_64()} 를 push, main에서 한 번에 여러 개 drain
+- 가득 차면 새 이벤트는 버리고 overflow 카운트 증가
+*/
+
+// 2의 거듭제곱
+#ifndef EDGE_RING_SIZE
+#define EDGE_RING_SIZE          64u
+#endif
+
+typedef struct {
+    uint64_t t_us;      // 엣지 시각 (time_us_64)
+    uint8_t  pin;
+    uint8_t  edge;      // GPIO_IRQ_EDGE_RISE / GPIO_IRQ_EDGE_FALL
+} edge_event_t;
+
+typedef struct {
+    volatile uint32_t head;         // producer만 씀
+    volatile uint32_t tail;         // consumer만 씀
+    volatile uint32_t overflow;     // producer만 씀
+    edge_event_t buf[EDGE_RING_SIZE];
+} edge_ring_t;
+
+// ISR에서 호출
+static inline bool edge_ring_push(edge_ring_t *r, uint pin, uint32_t edge, uint64_t t_us) {
+    uint32_t head = r->head;
+    if (head - r->tail >= EDGE_RING_SIZE) {
+        r->overflow++;
+        return false;
+    }
+
+    edge_event_t *e = &r->buf[head & (EDGE_RING_SIZE - 1u)];
+    e->t_us = t_us;
+    e->pin  = (uint8_t)pin;
+    e->edge = (uint8_t)edge;
+
+    // 내용 쓰기가 끝난 뒤 head 공개
+    __mem_fence_release();
+    r->head = head + 1u;
+    return true;
+}
+
+// main에서 호출: 최대 max개 꺼내서 out에 복사, 꺼낸 개수 반환
+static inline uint32_t edge_ring_drain(edge_ring_t *r, edge_event_t *out, uint32_t max) {
+    uint32_t tail = r->tail;
+    uint32_t n = r->head - tail;
+    __mem_fence_acquire();
+
+    if (n > max) n = max;
+    for (uint32_t i = 0; i < n; i++) {
+        out[i] = r->buf[(tail + i) & (EDGE_RING_SIZE - 1u)];
+    }
+
+    // 읽기가 끝난 뒤 슬롯 반환
+    __mem_fence_release();
+    r->tail = tail + n;
+    return n;
+}
+
+// 꺼낼 이벤트 없음 (main에서 잠들기 전 확인용)
+static inline bool edge_ring_empty(const edge_ring_t *r) {
+    return r->head == r->tail;
+}
+
+static inline uint32_t edge_ring_overflow(const edge_ring_t *r) {
+    return r->overflow;
+}
+
+#endif
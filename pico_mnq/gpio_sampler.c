@@ -0,0 +1,172 @@
+#include "gpio_sampler.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/pio.h"
+#include "hardware/sync.h"
+#include <stdio.h>
+
+// PIO 샘플 프로그램 (pioasm 없이 손으로 인코딩)
+//   .wrap_target
+//       in pins, 32        ; autopush 32 → 명령 1번 = GPIO 0~31 word 1개가 RX FIFO로
+//   .wrap
+// SM 클럭 분주 = 샘플 주기 (명령 1개 = SM 클럭 1개, 지터 없음)
+// SIO gpio_in은 core 전용 IOPORT라 DMA가 못 읽음 → PIO가 핀을 읽고 DMA는 RX FIFO(DREQ_PIOx_RXy)에서
+#define SAMPLER_PIO_IN_PINS_32  0x4000u     // IN, source = PINS, bit count 32 (= 0), delay 0
+
+static const uint16_t g_sample_insn[] = { SAMPLER_PIO_IN_PINS_32 };
+static const pio_program_t g_sample_prog = {
+    .instructions = g_sample_insn,
+    .length = 1,
+    .origin = -1,
+};
+
+// overrun 뒤 다시 읽기 시작할 위치 : 최신 샘플에서 ring 절반 전 (바로 덮어써질 가장 오래된 샘플은 버림)
+#define GPIO_SAMPLER_RESYNC     (GPIO_SAMPLER_RING_WORDS / 2u)
+
+static uint32_t g_ring[GPIO_SAMPLER_RING_WORDS] __attribute__((aligned(1u << GPIO_SAMPLER_RING_BITS)));
+
+static PIO g_pio = NULL;
+static uint g_sm = 0;
+static uint g_offset = 0;               // 프로그램 위치
+static int g_dma_ch[2] = { -1, -1 };
+static uint64_t g_t0_ns = 0;            // 시작 시각 (샘플 0은 첫 SM 클럭 = t0 + 주기)
+static uint64_t g_period_ps = 0;        // 샘플 주기 (ps, clk_sys 정수 분주)
+static uint64_t g_rd = 0;               // 다음에 읽을 샘플 번호
+
+static uint64_t g_read = 0;             // 통계 : 읽은 샘플 수
+static uint32_t g_overrun = 0;          // 통계 : overrun 횟수
+static uint64_t g_lost = 0;             // 통계 : 버린 샘플 수
+
+// 프로그램 자리와 빈 SM이 있는 PIO (pio0 먼저)
+static bool sampler_claim_sm(void)
+{
+    const PIO pios[2] = { pio0, pio1 };
+    for (uint i = 0; i < 2u; i++) {
+        if (!pio_can_add_program(pios[i], &g_sample_prog)) continue;
+        int sm = pio_claim_unused_sm(pios[i], false);
+        if (sm < 0) continue;
+        g_pio = pios[i];
+        g_sm = (uint)sm;
+        g_offset = pio_add_program(g_pio, &g_sample_prog);
+        return true;
+    }
+    return false;
+}
+
+bool gpio_sampler_start(uint32_t rate_hz)
+{
+    uint32_t clk_hz = clock_get_hz(clk_sys);
+    if (rate_hz == 0) return false;
+    uint32_t div = (clk_hz + rate_hz / 2u) / rate_hz;
+    if (div < 1u || div > 0xffffu) return false;
+
+    if (!sampler_claim_sm()) return false;
+    g_dma_ch[0] = dma_claim_unused_channel(false);
+    g_dma_ch[1] = dma_claim_unused_channel(false);
+    if (g_dma_ch[0] < 0 || g_dma_ch[1] < 0) return false;
+
+    // GPIO 0부터 32핀, 왼쪽 shift + autopush 32, RX FIFO 8단 (DMA chain 전환 동안 여유)
+    pio_sm_config sc = pio_get_default_sm_config();
+    sm_config_set_wrap(&sc, g_offset, g_offset);
+    sm_config_set_in_pins(&sc, 0);
+    sm_config_set_in_shift(&sc, false, true, 32);
+    sm_config_set_fifo_join(&sc, PIO_FIFO_JOIN_RX);
+    sm_config_set_clkdiv_int_frac(&sc, (uint16_t)div, 0);
+    pio_sm_init(g_pio, g_sm, g_offset, &sc);
+
+    // 두 채널 모두 같은 ring에 1바퀴(RING_WORDS회)씩 쓰고 서로 chain → 끝난 채널은 write 주소가 ring 처음으로 돌아와 있음
+    for (uint k = 0; k < 2u; k++) {
+        dma_channel_config c = dma_channel_get_default_config((uint)g_dma_ch[k]);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+        channel_config_set_read_increment(&c, false);
+        channel_config_set_write_increment(&c, true);
+        channel_config_set_ring(&c, true, GPIO_SAMPLER_RING_BITS);
+        channel_config_set_dreq(&c, pio_get_dreq(g_pio, g_sm, false));
+        channel_config_set_chain_to(&c, (uint)g_dma_ch[k ^ 1u]);
+        dma_channel_configure((uint)g_dma_ch[k], &c, g_ring, &g_pio->rxf[g_sm], GPIO_SAMPLER_RING_WORDS, false);
+    }
+
+    g_period_ps = (uint64_t)div * 1000000000000ull / clk_hz;
+    g_rd = 0;
+
+    // DMA가 먼저 기다리고 있다가 SM 시작 (샘플 0 = 시작 뒤 첫 SM 클럭)
+    uint32_t irq_state = save_and_disable_interrupts();
+    dma_channel_start((uint)g_dma_ch[0]);
+    g_t0_ns = time_us_64() * 1000u;
+    pio_sm_set_enabled(g_pio, g_sm, true);
+    restore_interrupts(irq_state);
+
+    gpio_sampler_reset();
+    return true;
+}
+
+uint64_t gpio_sampler_index_at(uint64_t t_us)
+{
+    uint64_t t_ns = t_us * 1000u;
+    if (g_period_ps == 0 || t_ns < g_t0_ns) return 0;
+    return (t_ns - g_t0_ns) * 1000u / g_period_ps;
+}
+
+uint64_t gpio_sampler_time_us(uint64_t idx)
+{
+    return (g_t0_ns + (idx + 1u) * g_period_ps / 1000u) / 1000u;
+}
+
+uint32_t gpio_sampler_period_ns(void)
+{
+    return (uint32_t)(g_period_ps / 1000u);
+}
+
+// 지금까지 기록된 샘플 수 : ring 안 위치(DMA write 주소)는 정확, 몇 바퀴째인지는 시각으로
+// 시각 추정 오차(1 샘플 정도)가 ring 절반보다 작으면 위치에 맞는 가장 가까운 값이 정답
+static uint64_t sampler_written(void)
+{
+    uint64_t est = gpio_sampler_index_at(time_us_64());
+
+    uint ch = dma_channel_is_busy((uint)g_dma_ch[1]) ? (uint)g_dma_ch[1] : (uint)g_dma_ch[0];
+    uint32_t pos = (uint32_t)((dma_channel_hw_addr(ch)->write_addr - (uintptr_t)g_ring) / sizeof(uint32_t));
+
+    int32_t d = (int32_t)((pos - (uint32_t)est) & (GPIO_SAMPLER_RING_WORDS - 1u));
+    if (d >= (int32_t)(GPIO_SAMPLER_RING_WORDS / 2u)) d -= (int32_t)GPIO_SAMPLER_RING_WORDS;
+    if (d < 0 && (uint64_t)-d > est) return 0;
+    return est + (uint64_t)(int64_t)d;
+}
+
+uint32_t gpio_sampler_read(const uint32_t **samples, uint64_t *idx)
+{
+    if (g_dma_ch[0] < 0) return 0;
+
+    uint64_t wr = sampler_written();
+    if (wr <= g_rd) return 0;
+    if (wr - g_rd > GPIO_SAMPLER_RING_WORDS - GPIO_SAMPLER_RESYNC / 2u) {
+        uint64_t rd = wr - GPIO_SAMPLER_RESYNC;
+        g_overrun++;
+        g_lost += rd - g_rd;
+        g_rd = rd;
+    }
+
+    uint32_t at = (uint32_t)g_rd & (GPIO_SAMPLER_RING_WORDS - 1u);
+    uint32_t n = GPIO_SAMPLER_RING_WORDS - at;
+    if ((uint64_t)n > wr - g_rd) n = (uint32_t)(wr - g_rd);
+
+    *samples = &g_ring[at];
+    *idx = g_rd;
+    g_rd += n;
+    g_read += n;
+    return n;
+}
+
+void gpio_sampler_reset(void)
+{
+    g_read = 0;
+    g_overrun = 0;
+    g_lost = 0;
+}
+
+void gpio_sampler_dump(void)
+{
+    uint32_t ns = gpio_sampler_period_ns();
+    printf("sampler: %lu Hz (%lu ns) read=%llu overrun=%lu lost=%llu\n",
+           (unsigned long)(ns ? 1000000000u / ns : 0), (unsigned long)ns,
+           (unsigned long long)g_read, (unsigned long)g_overrun, (unsigned long long)g_lost);
+}
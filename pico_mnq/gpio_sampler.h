@@ -0,0 +1,43 @@
+#ifndef GPIO_SAMPLER_H
+#define GPIO_SAMPLER_H
+
+#include "pico/stdlib.h"
+
+/*
+PIO + DMA GPIO 연속 샘플러 : PIO SM이 "in pins, 32"로 GPIO 0~31 word를 분주 주기로 RX FIFO에 넣고
+DMA가 RX FIFO(DREQ_PIOx_RXy)에서 ring buffer로 계속 기록 (SIO gpio_in은 IOPORT라 DMA로 못 읽음)
+- 샘플당 CPU 비용 없음, 샘플 간격은 SM 클럭 분주(clk_sys 정수 분주)라 정확 (지터 없음)
+- PIO 명령 메모리 1칸 + SM 1개 (pio0, 없으면 pio1), DMA 채널 2개
+- DMA 채널 2개가 서로 chain (각각 ring 1바퀴씩 번갈아) → 끊김 없이 무한 반복
+- 읽는 쪽은 poll로 새 샘플을 block 단위로 꺼냄 (sample_decode.h 등으로 한 번에 판정)
+  샘플 번호는 시작부터 0, 1, ... (64bit), 번호 → 시각은 gpio_sampler_time_us
+- ring 1바퀴(GPIO_SAMPLER_RING_WORDS 샘플) 안에 다시 읽지 않으면 overrun : 오래된 샘플을 버리고 번호가 건너뜀
+*/
+
+// ring 크기 (byte = 1 << bits, DMA write ring 정렬), 12 = 1024 샘플 (20kHz에서 51ms)
+#ifndef GPIO_SAMPLER_RING_BITS
+#define GPIO_SAMPLER_RING_BITS  12u
+#endif
+
+#define GPIO_SAMPLER_RING_WORDS ((1u << GPIO_SAMPLER_RING_BITS) / 4u)
+
+// rate_hz로 시작 (clk_sys 정수 분주로 반올림, 실제 주기는 gpio_sampler_period_ns)
+// PIO 자리 / SM / DMA 채널이 없거나 분주가 16bit를 넘으면 false
+bool gpio_sampler_start(uint32_t rate_hz);
+
+// 아직 안 읽은 샘플 중 ring에서 이어진 구간 하나 (ring 끝에서 잘림 → 0이 나올 때까지 반복)
+// *idx = 첫 샘플 번호, 반환 = 샘플 수. 꺼낸 구간은 다음 호출 전에 처리할 것 (DMA가 1바퀴 뒤 덮어씀)
+uint32_t gpio_sampler_read(const uint32_t **samples, uint64_t *idx);
+
+// 샘플 번호 → 그 샘플을 찍은 시각 (us)
+uint64_t gpio_sampler_time_us(uint64_t idx);
+
+// 시각 → 그 시각까지 찍힌 샘플 수 (다음 샘플 번호)
+uint64_t gpio_sampler_index_at(uint64_t t_us);
+
+uint32_t gpio_sampler_period_ns(void);
+
+void gpio_sampler_reset(void);
+void gpio_sampler_dump(void);
+
+#endif
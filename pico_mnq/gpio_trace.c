@@ -0,0 +1,161 @@
+#include "gpio_trace.h"
+#include "hardware/gpio.h"
+#include "hardware/structs/iobank0.h"
+#include "hardware/sync.h"
+#include <stdio.h>
+
+#define PIN_NONE                0xffu
+
+// hex 덤프 한 줄 byte 수
+#define DUMP_LINE_BYTES         32u
+
+#define TRACE_EDGES             (GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL)
+
+static gpio_trace_hdr_t g_hdr;
+static uint8_t g_pin_ch[32];            // GPIO → 채널, PIN_NONE이면 기록 안 함
+static uint8_t g_buf[GPIO_TRACE_BUF_SIZE];
+static volatile uint32_t g_len = 0;
+static volatile bool g_active = false;
+static volatile bool g_overflow = false;
+static uint64_t g_last_us = 0;
+static uint32_t g_remote = 0;           // 다른 core 콜백이 기록하는 핀 (IRQ 안 켬)
+static spin_lock_t *g_lock = NULL;      // 버퍼/시각 (양쪽 core의 gpio_trace_irq, start, dump)
+static uint8_t g_saved_events[GPIO_TRACE_MAX_CH];  // start 전 로컬 핀 IRQ 이벤트 (stop/dump 때 복원)
+static bool g_irq_saved = false;
+
+bool gpio_trace_init(const uint *pins, uint n) {
+    if (n == 0 || n > GPIO_TRACE_MAX_CH) return false;
+
+    for (uint i = 0; i < 32; i++) g_pin_ch[i] = PIN_NONE;
+    for (uint i = 0; i < GPIO_TRACE_MAX_CH; i++) g_hdr.pins[i] = PIN_NONE;
+    for (uint i = 0; i < n; i++) {
+        if (pins[i] >= 32) return false;
+        g_hdr.pins[i] = (uint8_t)pins[i];
+        g_pin_ch[pins[i]] = (uint8_t)i;
+    }
+    g_hdr.ch_count = (uint8_t)n;
+    g_remote = 0;
+    g_active = false;
+    g_len = 0;
+    if (!g_lock) g_lock = spin_lock_init((uint)spin_lock_claim_unused(true));
+    return true;
+}
+
+void gpio_trace_set_remote(uint pin) {
+    if (pin < 32) g_remote |= 1u << pin;
+}
+
+// 이 core에서 이 핀에 켜둔 IRQ 이벤트 (IO_BANK0 PROCn_INTE)
+static uint32_t pin_irq_events(uint pin) {
+    io_irq_ctrl_hw_t *ctrl = get_core_num() ? &io_bank0_hw->proc1_irq_ctrl : &io_bank0_hw->proc0_irq_ctrl;
+    return (ctrl->inte[pin >> 3] >> (4u * (pin & 7u))) & 0xfu;
+}
+
+// start가 새로 켠 엣지만 끔 (start 전에 켜져 있던 이벤트는 그대로)
+static void trace_irq_restore(void) {
+    if (!g_irq_saved) return;
+    for (uint i = 0; i < g_hdr.ch_count; i++) {
+        uint pin = g_hdr.pins[i];
+        if (g_remote & (1u << pin)) continue;
+        uint32_t added = TRACE_EDGES & ~(uint32_t)g_saved_events[i];
+        if (added) gpio_set_irq_enabled(pin, added, false);
+    }
+    g_irq_saved = false;
+}
+
+void gpio_trace_start(void) {
+    uint32_t irq_state = spin_lock_blocking(g_lock);
+
+    g_hdr.init_levels = 0;
+    for (uint i = 0; i < g_hdr.ch_count; i++) {
+        uint pin = g_hdr.pins[i];
+        if (gpio_get(pin)) g_hdr.init_levels |= (uint8_t)(1u << i);
+        // 기존에 켜둔 IRQ 이벤트는 저장해 두고 양 엣지 추가 (다른 core가 맡는 핀은 그 core가 이미 켬)
+        // 정지 전에 다시 start하면 처음 저장한 값 유지 (이미 켠 양 엣지를 원래 값으로 착각하지 않게)
+        if (g_remote & (1u << pin)) continue;
+        if (!g_irq_saved) g_saved_events[i] = (uint8_t)pin_irq_events(pin);
+        gpio_set_irq_enabled(pin, TRACE_EDGES, true);
+    }
+    g_irq_saved = true;
+    g_hdr.start_us = time_us_64();
+    g_last_us = g_hdr.start_us;
+    g_len = 0;
+    g_overflow = false;
+    g_active = true;
+
+    spin_unlock(g_lock, irq_state);
+}
+
+void gpio_trace_stop(void) {
+    uint32_t irq_state = spin_lock_blocking(g_lock);
+    g_active = false;
+    spin_unlock(g_lock, irq_state);
+    trace_irq_restore();
+}
+
+bool gpio_trace_active(void) {
+    return g_active;
+}
+
+static void trace_put(uint ch, bool level, uint64_t t_us) {
+    uint64_t delta = t_us > g_last_us ? t_us - g_last_us : 0;
+    if (delta > 0x0fffffffu) delta = 0x0fffffffu;
+
+    uint32_t len = g_len;
+    uint n = gpio_trace_put_event(&g_buf[len], GPIO_TRACE_BUF_SIZE - len, (uint32_t)delta, ch, level);
+    if (n == 0) {
+        // IRQ는 여기서 되돌리지 않음 (다른 core 콜백일 수 있음) → stop/dump 때 복원, 그동안 들어온 엣지는 무시
+        g_overflow = true;
+        g_active = false;
+        return;
+    }
+    g_len = len + n;
+    // 다른 core가 먼저 늦은 시각을 기록했으면 그대로 (lock 순서와 시각이 어긋나도 시간은 뒤로 안 감)
+    if (t_us > g_last_us) g_last_us = t_us;
+}
+
+void gpio_trace_irq(uint gpio, uint32_t events, uint64_t t_us) {
+    if (!g_active || gpio >= 32) return;
+    uint ch = g_pin_ch[gpio];
+    if (ch == PIN_NONE) return;
+
+    bool rise = (events & GPIO_IRQ_EDGE_RISE) != 0;
+    bool fall = (events & GPIO_IRQ_EDGE_FALL) != 0;
+    uint32_t irq_state = spin_lock_blocking(g_lock);
+    if (!g_active) {
+        // 기다리는 동안 dump / overflow로 멈춤
+    } else if (rise && fall) {
+        // 두 엣지가 한 번에 → 지금 레벨이 마지막, 반대 레벨을 먼저 기록
+        bool level = gpio_get(gpio);
+        trace_put(ch, !level, t_us);
+        trace_put(ch, level, t_us);
+    } else if (rise || fall) {
+        trace_put(ch, rise, t_us);
+    }
+    spin_unlock(g_lock, irq_state);
+}
+
+void gpio_trace_dump(void) {
+    uint8_t hdr[GPIO_TRACE_HDR_SIZE];
+
+    // 기록 중이면 멈춘 뒤 출력 (출력 중 버퍼가 바뀌지 않게, 다른 core가 기록 중이면 끝날 때까지 대기)
+    uint32_t irq_state = spin_lock_blocking(g_lock);
+    g_active = false;
+    spin_unlock(g_lock, irq_state);
+    trace_irq_restore();
+    g_hdr.data_len = g_len;
+    gpio_trace_hdr_write(hdr, &g_hdr);
+
+    printf("TR BEGIN %lu%s\n", (unsigned long)(GPIO_TRACE_HDR_SIZE + g_len), g_overflow ? " overflow" : "");
+
+    uint32_t total = GPIO_TRACE_HDR_SIZE + g_len;
+    for (uint32_t off = 0; off < total; off += DUMP_LINE_BYTES) {
+        printf("TR ");
+        for (uint32_t i = off; i < off + DUMP_LINE_BYTES && i < total; i++) {
+            uint8_t b = i < GPIO_TRACE_HDR_SIZE ? hdr[i] : g_buf[i - GPIO_TRACE_HDR_SIZE];
+            printf("%02x", b);
+        }
+        printf("\n");
+    }
+    printf("TR END\n");
+}
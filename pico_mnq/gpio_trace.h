@@ -0,0 +1,41 @@
+#ifndef GPIO_TRACE_H
+#define GPIO_TRACE_H
+
+#include "pico/stdlib.h"
+#include "gpio_trace_format.h"
+
+/*
+GPIO 변화 기록 (현장 오판정 재현용)
+- 등록한 핀(최대 8개)의 모든 엣지를 us 시각과 함께 RAM 버퍼에 delta/varint로 기록 (형식: gpio_trace_format.h)
+- 기록은 GPIO IRQ 콜백에서 gpio_trace_irq() 호출 (양 엣지 IRQ는 gpio_trace_start가 켬)
+  다른 core의 GPIO 콜백이 맡는 핀은 gpio_trace_set_remote로 지정 → gpio_trace_start가 IRQ를 켜지 않음
+  (IO_BANK0 INTR 엣지 latch는 두 core가 같이 써서 한 핀을 두 core가 ack하면 서로 엣지를 지움)
+  그 core가 양 엣지 IRQ를 켜고 콜백에서 gpio_trace_irq 호출, 버퍼는 spin lock으로 두 core가 같이 기록
+- start 전에 로컬 핀에 켜져 있던 IRQ 이벤트는 저장, stop/dump 때 start가 추가한 엣지만 끔
+  (start/stop/dump는 같은 core에서 호출, IRQ 활성은 core별)
+- 버퍼가 차면 기록 중지 (앞부분 유지), overflow 표시
+- stdio로 hex 덤프: "TR BEGIN <byte 수>" / "TR <hex>" ... / "TR END" → host/trace_replay로 재생
+*/
+
+#ifndef GPIO_TRACE_BUF_SIZE
+#define GPIO_TRACE_BUF_SIZE     16384u
+#endif
+
+// 기록할 핀 등록 (채널 번호 = 순서)
+bool gpio_trace_init(const uint *pins, uint n);
+
+// 이 핀의 엣지 IRQ/gpio_trace_irq 호출은 다른 core 콜백이 맡음 (gpio_trace_init 뒤, start 전)
+void gpio_trace_set_remote(uint pin);
+
+// 기록 시작(버퍼 비움, 시작 레벨/IRQ 이벤트 저장) / 정지(IRQ 이벤트 복원)
+void gpio_trace_start(void);
+void gpio_trace_stop(void);
+bool gpio_trace_active(void);
+
+// GPIO IRQ 콜백에서 호출 (어느 core든)
+void gpio_trace_irq(uint gpio, uint32_t events, uint64_t t_us);
+
+// header + 이벤트를 stdio로 hex 출력
+void gpio_trace_dump(void);
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef GPIO_TRACE_FORMAT_H
+#define GPIO_TRACE_FORMAT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+GPIO trace 바이너리 형식 (펌웨어 기록 / host 재생 공용, header only)
+
+header (28 byte, little endian)
+  0  magic      "GTRC"
+  4  version    1
+  5  ch_count   채널 수 (최대 8)
+  6  init       bit n = 채널 n 시작 레벨
+  7  reserved
+  8  pins[8]    채널별 GPIO 번호
+  16 start_us   기록 시작 시각 (time_us_64)
+  24 data_len   이벤트 바이트 수
+
+이벤트 (data_len byte)
+  varint( delta_us << 4 | ch << 1 | level )
+  - delta_us : 직전 이벤트(첫 이벤트는 start_us)부터 us
+  - varint   : 7bit씩 LSB 먼저, 상위 bit = 다음 byte 있음
+  - 1ms 안쪽 간격이면 2 byte, 0.13s 안쪽이면 3 byte
+*/
+
+#define GPIO_TRACE_MAGIC        0x43525447u     // "GTRC"
+#define GPIO_TRACE_VERSION      1u
+#define GPIO_TRACE_MAX_CH       8u
+#define GPIO_TRACE_HDR_SIZE     28u
+
+typedef struct {
+    uint8_t  ch_count;
+    uint8_t  init_levels;
+    uint8_t  pins[GPIO_TRACE_MAX_CH];
+    uint64_t start_us;
+    uint32_t data_len;
+} gpio_trace_hdr_t;
+
+static inline void gpio_trace_put_le(uint8_t *p, uint64_t v, uint n) {
+    for (uint i = 0; i < n; i++) p[i] = (uint8_t)(v >> (8u * i));
+}
+
+static inline uint64_t gpio_trace_get_le(const uint8_t *p, uint n) {
+    uint64_t v = 0;
+    for (uint i = 0; i < n; i++) v |= (uint64_t)p[i] << (8u * i);
+    return v;
+}
+
+static inline void gpio_trace_hdr_write(uint8_t *p, const gpio_trace_hdr_t *h) {
+    gpio_trace_put_le(&p[0], GPIO_TRACE_MAGIC, 4);
+    p[4] = GPIO_TRACE_VERSION;
+    p[5] = h->ch_count;
+    p[6] = h->init_levels;
+    p[7] = 0;
+    for (uint i = 0; i < GPIO_TRACE_MAX_CH; i++) p[8 + i] = h->pins[i];
+    gpio_trace_put_le(&p[16], h->start_us, 8);
+    gpio_trace_put_le(&p[24], h->data_len, 4);
+}
+
+static inline bool gpio_trace_hdr_read(const uint8_t *p, gpio_trace_hdr_t *h) {
+    if (gpio_trace_get_le(&p[0], 4) != GPIO_TRACE_MAGIC) return false;
+    if (p[4] != GPIO_TRACE_VERSION || p[5] == 0 || p[5] > GPIO_TRACE_MAX_CH) return false;
+    h->ch_count = p[5];
+    h->init_levels = p[6];
+    for (uint i = 0; i < GPIO_TRACE_MAX_CH; i++) h->pins[i] = p[8 + i];
+    h->start_us = gpio_trace_get_le(&p[16], 8);
+    h->data_len = (uint32_t)gpio_trace_get_le(&p[24], 4);
+    return true;
+}
+
+// 이벤트 1개 인코딩, 쓴 byte 수 반환 (cap 부족이면 0)
+static inline uint gpio_trace_put_event(uint8_t *p, uint cap, uint32_t delta_us, uint ch, bool level) {
+    uint64_t v = ((uint64_t)delta_us << 4) | ((uint64_t)ch << 1) | (level ? 1u : 0u);
+    uint n = 0;
+    do {
+        if (n >= cap) return 0;
+        uint8_t b = (uint8_t)(v & 0x7fu);
+        v >>= 7;
+        p[n++] = v ? (uint8_t)(b | 0x80u) : b;
+    } while (v);
+    return n;
+}
+
+// 이벤트 1개 디코딩, 읽은 byte 수 반환 (잘린 데이터면 0)
+static inline uint gpio_trace_get_event(const uint8_t *p, uint len, uint32_t *delta_us, uint *ch, bool *level) {
+    uint64_t v = 0;
+    uint n = 0;
+    for (;;) {
+        if (n >= len || n >= 10) return 0;
+        uint8_t b = p[n];
+        v |= (uint64_t)(b & 0x7fu) << (7u * n);
+        n++;
+        if (!(b & 0x80u)) break;
+    }
+    *level = (v & 1u) != 0;
+    *ch = (uint)((v >> 1) & 0x7u);
+    *delta_us = (uint32_t)(v >> 4);
+    return n;
+}
+
+#endif
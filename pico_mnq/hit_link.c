@@ -0,0 +1,166 @@
+#include "hit_link.h"
+#include "hit_stats.h"
+#include "hardware/sync.h"
+#include <stdio.h>
+
+// 대기 시간 히스토그램 bucket 폭 (1 << shift us)
+#define HIT_LINK_WAIT_SHIFT     4u
+
+#define QUEUE_MASK              (HIT_LINK_QUEUE_SIZE - 1u)
+
+#if (HIT_LINK_QUEUE_SIZE & QUEUE_MASK) != 0
+#error "HIT_LINK_QUEUE_SIZE must be a power of 2"
+#endif
+
+// ------------ link state ------------
+typedef struct {
+    hit_link_rec_t rec;
+    uint64_t queued_us;
+} link_slot_t;
+
+static uart_inst_t *g_uart = NULL;
+static uint g_baud = 0;
+static link_slot_t g_queue[HIT_LINK_QUEUE_SIZE];
+static uint32_t g_head = 0;             // 다음에 넣을 위치
+static uint32_t g_tail = 0;             // 다음에 보낼 위치
+static uint16_t g_seq = 0;
+static uint64_t g_busy_until_us = 0;    // 송출 중인 frame이 선로에서 끝나는 시각
+static volatile alarm_id_t g_alarm = 0; // 묶음 송출 alarm, 0이면 없음
+static hit_link_hook_t g_hook = NULL;
+
+// ------------ stats ------------
+static uint64_t g_since_us = 0;
+static uint64_t g_busy_us = 0;          // 선로 점유 시간 합
+static uint32_t g_frames = 0;
+static uint32_t g_recs = 0;
+static uint32_t g_bytes = 0;
+static uint32_t g_drop = 0;             // 대기열 초과
+static uint32_t g_batch[HIT_LINK_MAX_BATCH];    // [n-1] = n record frame 수
+static hit_hist_t g_wait;               // send → frame 시작 (us)
+
+// 8N1 : byte당 10 bit
+static uint32_t frame_us(uint32_t len) {
+    return (uint32_t)(((uint64_t)len * 10u * 1000000u + g_baud - 1u) / g_baud);
+}
+
+// 대기열 앞에서 최대 HIT_LINK_MAX_BATCH개를 frame 1개로 송출 (인터럽트 비활성 상태에서 호출)
+static void link_tx(uint64_t now) {
+    hit_link_rec_t rec[HIT_LINK_MAX_BATCH];
+    uint64_t queued[HIT_LINK_MAX_BATCH];
+    uint32_t n = 0;
+    while (n < HIT_LINK_MAX_BATCH && g_tail != g_head) {
+        link_slot_t *s = &g_queue[g_tail++ & QUEUE_MASK];
+        rec[n] = s->rec;
+        queued[n] = s->queued_us;
+        n++;
+    }
+    if (n == 0) return;
+
+    uint8_t frame[HIT_LINK_FRAME_MAX];
+    uint32_t len = hit_link_frame_write(frame, rec, n);
+    for (uint32_t i = 0; i < len; i++) uart_putc_raw(g_uart, (char)frame[i]);
+
+    uint32_t us = frame_us(len);
+    g_busy_until_us = now + us;
+    g_busy_us += us;
+    g_frames++;
+    g_recs += n;
+    g_bytes += len;
+    g_batch[n - 1]++;
+    for (uint32_t i = 0; i < n; i++) {
+        hit_hist_add(&g_wait, (uint32_t)(now - queued[i]));
+        if (g_hook) g_hook(rec[i].ch, now);
+    }
+}
+
+// 앞 frame이 끝난 시각 (alarm IRQ context) : 모인 record를 묶어서 송출, 더 남았으면 다음 frame 끝에 다시
+static int64_t link_alarm_cb(alarm_id_t id, void *user_data) {
+    (void)id;
+    (void)user_data;
+    uint32_t irq_state = save_and_disable_interrupts();
+    link_tx(time_us_64());
+    int64_t next = 0;
+    if (g_tail != g_head) next = (int64_t)(g_busy_until_us - time_us_64());
+    if (next <= 0) g_alarm = 0;
+    restore_interrupts(irq_state);
+    return next > 0 ? next : 0;
+}
+
+void hit_link_init(uart_inst_t *uart, uint tx_pin, uint baud) {
+    g_uart = uart;
+    g_baud = uart_init(uart, baud);
+    if (g_baud == 0) g_baud = baud;
+    uart_set_format(uart, 8, 1, UART_PARITY_NONE);
+    uart_set_fifo_enabled(uart, true);
+    gpio_set_function(tx_pin, GPIO_FUNC_UART);
+
+    g_head = g_tail = 0;
+    g_seq = 0;
+    g_busy_until_us = 0;
+    g_alarm = 0;
+    g_wait.shift = HIT_LINK_WAIT_SHIFT;
+    hit_link_reset();
+}
+
+bool hit_link_send(uint ch, uint type, uint64_t shot_us) {
+    if (!g_uart) return false;
+    bool ok = true;
+
+    uint32_t irq_state = save_and_disable_interrupts();
+    if (g_head - g_tail >= HIT_LINK_QUEUE_SIZE) {
+        g_drop++;
+        ok = false;
+    } else {
+        uint64_t now = time_us_64();
+        link_slot_t *s = &g_queue[g_head++ & QUEUE_MASK];
+        s->rec.seq = g_seq++;
+        s->rec.ch = (uint8_t)ch;
+        s->rec.type = (uint8_t)type;
+        s->rec.t_us = (uint32_t)shot_us;
+        s->queued_us = now;
+
+        if (g_alarm == 0) {
+            if ((int64_t)(now - g_busy_until_us) >= 0) {
+                // 선로 비어 있음 → 바로 송출
+                link_tx(now);
+            } else {
+                // 송출 중 → 앞 frame 끝에 모아서 송출
+                alarm_id_t id = add_alarm_at(from_us_since_boot(g_busy_until_us), link_alarm_cb, NULL, true);
+                if (id > 0) g_alarm = id;
+                else        link_tx(now);   // alarm 슬롯 없음 → FIFO에 바로 (FIFO가 찰 때까지 기다릴 수 있음)
+            }
+        }
+    }
+    restore_interrupts(irq_state);
+    return ok;
+}
+
+void hit_link_set_hook(hit_link_hook_t hook) {
+    g_hook = hook;
+}
+
+void hit_link_reset(void) {
+    uint32_t irq_state = save_and_disable_interrupts();
+    g_since_us = time_us_64();
+    g_busy_us = 0;
+    g_frames = 0;
+    g_recs = 0;
+    g_bytes = 0;
+    g_drop = 0;
+    for (uint32_t i = 0; i < HIT_LINK_MAX_BATCH; i++) g_batch[i] = 0;
+    hit_hist_clear(&g_wait);
+    restore_interrupts(irq_state);
+}
+
+void hit_link_dump(void) {
+    uint64_t total = time_us_64() - g_since_us;
+    uint32_t permille = total ? (uint32_t)(g_busy_us * 1000u / total) : 0;
+
+    printf("link: baud=%u frames=%lu hits=%lu bytes=%lu drop=%lu util %lu.%lu%%\n",
+           g_baud, (unsigned long)g_frames, (unsigned long)g_recs, (unsigned long)g_bytes,
+           (unsigned long)g_drop, (unsigned long)(permille / 10u), (unsigned long)(permille % 10u));
+    printf("  batch:");
+    for (uint32_t i = 0; i < HIT_LINK_MAX_BATCH; i++) printf(" %lu=%lu", (unsigned long)(i + 1u), (unsigned long)g_batch[i]);
+    printf("\n");
+    hit_hist_dump("wait", &g_wait);
+}
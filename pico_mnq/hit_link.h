@@ -0,0 +1,36 @@
+#ifndef HIT_LINK_H
+#define HIT_LINK_H
+
+#include "pico/stdlib.h"
+#include "hardware/uart.h"
+#include "hit_link_format.h"
+
+/*
+메인 PCB로 HIT를 UART frame으로 전달 (형식은 hit_link_format.h)
+- hit_link_send()는 record를 대기열에 넣고 바로 반환 (TX FIFO에 쓰는 시간만, 수 us)
+- 선로가 비어 있으면 바로 1 record frame 송출, 송출 중에 들어온 record는 모아 두었다가
+  앞 frame이 끝나는 시각(alarm)에 한 frame으로 묶어 송출 (최대 HIT_LINK_MAX_BATCH개)
+- frame ≤ TX FIFO 크기이고 선로가 빈 뒤에만 쓰므로 FIFO가 차서 기다리는 일 없음
+- 통계 : frame/record/byte 수, 선로 사용률(송출 시간 / 경과 시간), 묶음 크기, 대기 시간, 대기열 초과로 버린 수
+- 호출한 core의 기본 alarm pool 사용 (hit_link_send와 같은 core)
+*/
+
+// 송출 대기 record 수 (2의 거듭제곱)
+#ifndef HIT_LINK_QUEUE_SIZE
+#define HIT_LINK_QUEUE_SIZE     16u
+#endif
+
+// baud : 요청 baud (실제 baud는 uart_init 반환값으로 계산)
+void hit_link_init(uart_inst_t *uart, uint tx_pin, uint baud);
+
+// record 송출 요청 (어느 context에서나), 대기열이 가득 차면 false
+bool hit_link_send(uint ch, uint type, uint64_t shot_us);
+
+// record가 선로에 나간 시각 통지 (frame 시작, 통계용). alarm IRQ 안에서도 호출됨, NULL이면 사용 안 함
+typedef void (*hit_link_hook_t)(uint ch, uint64_t t_us);
+void hit_link_set_hook(hit_link_hook_t hook);
+
+void hit_link_reset(void);
+void hit_link_dump(void);
+
+#endif
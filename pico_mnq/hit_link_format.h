@@ -0,0 +1,133 @@
+#ifndef HIT_LINK_FORMAT_H
+#define HIT_LINK_FORMAT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+HIT UART frame 형식 (탄 감지 펌웨어 송신 / 메인 PCB·host 수신 공용, header only)
+
+frame (little endian)
+  0     sync      0xA5 0x5A
+  2     count     record 수 (1 ~ HIT_LINK_MAX_BATCH)
+  3     record    count × 8 byte
+          0  seq    u16, record마다 +1 (수신 쪽에서 끊기면 누락)
+          2  ch     탄 감지 채널 (통계 채널 번호)
+          3  type   HIT 라인 번호 1~3 (HIT_1/2/3 핀과 같은 의미)
+          4  t_us   u32, 샷 시각 (판정을 시작시킨 엣지, time_us_32 기준)
+  3+8n  crc       u16, CRC-16/CCITT-FALSE (count ~ record 끝)
+
+- 최대 frame(3 record) = 29 byte → RP2040 UART TX FIFO(32 byte)에 한 번에 들어감
+- 1 Mbaud 8N1 기준 1 record frame 130us, 3 record frame 290us
+*/
+
+#define HIT_LINK_SYNC0          0xA5u
+#define HIT_LINK_SYNC1          0x5Au
+#define HIT_LINK_MAX_BATCH      3u
+#define HIT_LINK_REC_SIZE       8u
+#define HIT_LINK_HDR_SIZE       3u
+#define HIT_LINK_CRC_SIZE       2u
+#define HIT_LINK_FRAME_SIZE(n)  (HIT_LINK_HDR_SIZE + (n) * HIT_LINK_REC_SIZE + HIT_LINK_CRC_SIZE)
+#define HIT_LINK_FRAME_MAX      HIT_LINK_FRAME_SIZE(HIT_LINK_MAX_BATCH)
+
+typedef struct {
+    uint16_t seq;
+    uint8_t  ch;
+    uint8_t  type;
+    uint32_t t_us;
+} hit_link_rec_t;
+
+static inline uint16_t hit_link_crc16(uint16_t crc, const uint8_t *p, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        crc ^= (uint16_t)p[i] << 8;
+        for (int k = 0; k < 8; k++) crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+// frame 1개 인코딩, 쓴 byte 수 반환 (p는 HIT_LINK_FRAME_MAX 이상)
+static inline uint32_t hit_link_frame_write(uint8_t *p, const hit_link_rec_t *rec, uint32_t n) {
+    p[0] = HIT_LINK_SYNC0;
+    p[1] = HIT_LINK_SYNC1;
+    p[2] = (uint8_t)n;
+    uint8_t *r = &p[HIT_LINK_HDR_SIZE];
+    for (uint32_t i = 0; i < n; i++, r += HIT_LINK_REC_SIZE) {
+        r[0] = (uint8_t)rec[i].seq;
+        r[1] = (uint8_t)(rec[i].seq >> 8);
+        r[2] = rec[i].ch;
+        r[3] = rec[i].type;
+        r[4] = (uint8_t)rec[i].t_us;
+        r[5] = (uint8_t)(rec[i].t_us >> 8);
+        r[6] = (uint8_t)(rec[i].t_us >> 16);
+        r[7] = (uint8_t)(rec[i].t_us >> 24);
+    }
+    uint16_t crc = hit_link_crc16(0xffffu, &p[2], 1u + n * HIT_LINK_REC_SIZE);
+    r[0] = (uint8_t)crc;
+    r[1] = (uint8_t)(crc >> 8);
+    return HIT_LINK_FRAME_SIZE(n);
+}
+
+// ------------ 수신 (byte 단위) ------------
+typedef struct {
+    uint8_t  buf[HIT_LINK_FRAME_MAX];
+    uint32_t n;             // buf에 받은 byte
+    uint32_t frames;        // CRC 맞은 frame
+    uint32_t crc_err;       // CRC 틀린 frame (버림)
+    uint32_t skipped;       // sync 찾느라 버린 byte
+} hit_link_rx_t;
+
+static inline void hit_link_rx_init(hit_link_rx_t *rx) {
+    rx->n = 0;
+    rx->frames = 0;
+    rx->crc_err = 0;
+    rx->skipped = 0;
+}
+
+// byte 1개 입력, 온전한 frame이 완성되면 record 수 반환 (record는 hit_link_rx_rec로), 아니면 0
+// sync/count가 틀리거나 CRC가 틀리면 그 frame을 버리고 다음 sync부터 다시 찾음
+static inline uint32_t hit_link_rx_byte(hit_link_rx_t *rx, uint8_t b) {
+    if (rx->n == 0) {
+        if (b == HIT_LINK_SYNC0) rx->buf[rx->n++] = b;
+        else                     rx->skipped++;
+        return 0;
+    }
+    if (rx->n == 1) {
+        if (b == HIT_LINK_SYNC1) {
+            rx->buf[rx->n++] = b;
+        } else {
+            rx->skipped++;
+            rx->n = (b == HIT_LINK_SYNC0) ? 1u : 0u;
+        }
+        return 0;
+    }
+    if (rx->n == 2 && (b == 0 || b > HIT_LINK_MAX_BATCH)) {
+        rx->skipped += 2;
+        rx->n = (b == HIT_LINK_SYNC0) ? 1u : 0u;
+        return 0;
+    }
+
+    rx->buf[rx->n++] = b;
+    uint32_t count = rx->buf[2];
+    if (rx->n < HIT_LINK_FRAME_SIZE(count)) return 0;
+
+    rx->n = 0;
+    const uint8_t *c = &rx->buf[HIT_LINK_HDR_SIZE + count * HIT_LINK_REC_SIZE];
+    uint16_t crc = hit_link_crc16(0xffffu, &rx->buf[2], 1u + count * HIT_LINK_REC_SIZE);
+    if (crc != (uint16_t)(c[0] | (c[1] << 8))) {
+        rx->crc_err++;
+        return 0;
+    }
+    rx->frames++;
+    return count;
+}
+
+// 방금 완성된 frame의 i번째 record
+static inline void hit_link_rx_rec(const hit_link_rx_t *rx, uint32_t i, hit_link_rec_t *out) {
+    const uint8_t *r = &rx->buf[HIT_LINK_HDR_SIZE + i * HIT_LINK_REC_SIZE];
+    out->seq = (uint16_t)(r[0] | (r[1] << 8));
+    out->ch = r[2];
+    out->type = r[3];
+    out->t_us = (uint32_t)r[4] | ((uint32_t)r[5] << 8) | ((uint32_t)r[6] << 16) | ((uint32_t)r[7] << 24);
+}
+
+#endif
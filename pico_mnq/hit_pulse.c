@@ -0,0 +1,155 @@
+#include "hit_pulse.h"
+#include "hardware/sync.h"
+
+// ------------ line state ------------
+// alarm 1개로 "HIGH → LOW → (gap) → HIGH ..." 를 콜백 반환값(재예약)으로 이어감
+typedef struct {
+    uint pin;
+    volatile bool high;             // 현재 HIGH
+    volatile uint8_t pending;       // 송출 대기 펄스 수
+    volatile alarm_id_t alarm;      // 진행 중 alarm, 0이면 없음
+    volatile uint64_t low_since_us; // 마지막으로 LOW가 된 시각
+} hit_line_t;
+
+static hit_line_t g_lines[HIT_PULSE_MAX_LINES];
+static uint g_line_count = 0;
+
+static uint32_t g_pulse_us = 10000;
+static uint32_t g_gap_us = 0;
+static int g_led_pin = -1;
+static volatile uint32_t g_high_mask = 0;
+static hit_pulse_hook_t g_hook = NULL;
+
+static int find_line(uint pin) {
+    for (uint i = 0; i < g_line_count; i++) {
+        if (g_lines[i].pin == pin) return (int)i;
+    }
+    return -1;
+}
+
+static void line_raise(uint idx) {
+    hit_line_t *l = &g_lines[idx];
+    gpio_put(l->pin, 1);
+    l->high = true;
+    g_high_mask |= 1u << idx;
+    if (g_led_pin >= 0) gpio_put((uint)g_led_pin, 1);
+    if (g_hook) g_hook(l->pin, time_us_64());
+}
+
+static void line_drop(uint idx) {
+    hit_line_t *l = &g_lines[idx];
+    gpio_put(l->pin, 0);
+    l->high = false;
+    l->low_since_us = time_us_64();
+    g_high_mask &= ~(1u << idx);
+    if (g_led_pin >= 0 && g_high_mask == 0) gpio_put((uint)g_led_pin, 0);
+}
+
+// alarm 콜백 (IRQ context)
+// - HIGH였으면 LOW로, 대기 펄스가 있으면 gap 뒤 다시 호출
+// - LOW(gap 끝)였으면 다음 펄스 HIGH, pulse 뒤 다시 호출
+static int64_t line_alarm_cb(alarm_id_t id, void *user_data) {
+    (void)id;
+    uint idx = (uint)(uintptr_t)user_data;
+    hit_line_t *l = &g_lines[idx];
+
+    if (l->high) {
+        line_drop(idx);
+        if (l->pending == 0) {
+            l->alarm = 0;
+            return 0;
+        }
+        return g_gap_us > 0 ? (int64_t)g_gap_us : 1;
+    }
+
+    if (l->pending == 0) {
+        l->alarm = 0;
+        return 0;
+    }
+    l->pending--;
+    line_raise(idx);
+    return (int64_t)g_pulse_us;
+}
+
+void hit_pulse_init(uint32_t pulse_us, uint32_t min_gap_us, int led_pin) {
+    g_pulse_us = pulse_us;
+    g_gap_us = min_gap_us;
+    g_led_pin = led_pin;
+    g_line_count = 0;
+    g_high_mask = 0;
+}
+
+bool hit_pulse_add_line(uint pin) {
+    if (find_line(pin) >= 0) return true;
+    if (g_line_count >= HIT_PULSE_MAX_LINES) return false;
+
+    hit_line_t *l = &g_lines[g_line_count++];
+    l->pin = pin;
+    l->high = false;
+    l->pending = 0;
+    l->alarm = 0;
+    l->low_since_us = 0;
+
+    gpio_init(pin);
+    gpio_set_dir(pin, GPIO_OUT);
+    gpio_put(pin, 0);
+    return true;
+}
+
+bool hit_pulse_fire(uint pin) {
+    int idx = find_line(pin);
+    if (idx < 0) return false;
+    hit_line_t *l = &g_lines[idx];
+    bool ok = true;
+
+    uint32_t irq_state = save_and_disable_interrupts();
+    if (l->alarm == 0) {
+        uint64_t now = time_us_64();
+        uint64_t ready = l->low_since_us + g_gap_us;
+
+        if (now >= ready) {
+            // 바로 HIGH, pulse 뒤 LOW
+            line_raise((uint)idx);
+            l->alarm = add_alarm_in_us(g_pulse_us, line_alarm_cb, (void *)(uintptr_t)idx, true);
+            if (l->alarm < 0) {
+                // alarm 슬롯 없음 → HIGH로 남지 않게 바로 내림
+                l->alarm = 0;
+                line_drop((uint)idx);
+                ok = false;
+            }
+        } else {
+            // 아직 gap 중 → gap 끝나는 시각에 HIGH
+            l->pending++;
+            l->alarm = add_alarm_at(from_us_since_boot(ready), line_alarm_cb, (void *)(uintptr_t)idx, true);
+            if (l->alarm < 0) {
+                l->alarm = 0;
+                l->pending--;
+                ok = false;
+            }
+        }
+    } else if (l->pending < UINT8_MAX) {
+        // 진행 중인 alarm이 이어서 처리
+        l->pending++;
+    } else {
+        ok = false;
+    }
+    restore_interrupts(irq_state);
+
+    return ok;
+}
+
+void hit_pulse_set_hook(hit_pulse_hook_t hook) {
+    g_hook = hook;
+}
+
+void hit_pulse_clear(void) {
+    uint32_t irq_state = save_and_disable_interrupts();
+    for (uint i = 0; i < g_line_count; i++) {
+        hit_line_t *l = &g_lines[i];
+        if (l->alarm > 0) cancel_alarm(l->alarm);
+        l->alarm = 0;
+        l->pending = 0;
+        if (l->high) line_drop(i);
+    }
+    restore_interrupts(irq_state);
+}
@@ -0,0 +1,32 @@
+#ifndef HIT_PULSE_H
+#define HIT_PULSE_H
+
+#include "pico/stdlib.h"
+
+/*
+HIT 출력 펄스 스케줄러 (hardware alarm 기반, 비차단)
+- hit_pulse_fire()는 HIT 핀을 올리고 바로 반환, 내리는 건 alarm 콜백에서 처리
+- 서로 다른 HIT 핀은 동시에 HIGH 가능
+- 같은 핀에 펄스가 겹치면 대기열에 넣고, 이전 펄스가 내려간 뒤 min_gap 이후 송출
+- LED는 HIT 중 하나라도 HIGH면 HIGH
+*/
+
+#define HIT_PULSE_MAX_LINES     4
+
+// pulse_us: 펄스 폭, min_gap_us: 같은 핀에서 LOW 유지 최소 시간, led_pin: -1이면 사용 안 함
+void hit_pulse_init(uint32_t pulse_us, uint32_t min_gap_us, int led_pin);
+
+// 핀 등록 (출력 설정 포함)
+bool hit_pulse_add_line(uint pin);
+
+// 펄스 요청. 대기열이 가득 차면 false
+bool hit_pulse_fire(uint pin);
+
+// 모든 HIT 핀 LOW, 대기열/alarm 정리
+void hit_pulse_clear(void);
+
+// HIT 핀이 실제로 HIGH가 된 시각 통지 (통계용). alarm IRQ 안에서도 호출됨, NULL이면 사용 안 함
+typedef void (*hit_pulse_hook_t)(uint pin, uint64_t t_us);
+void hit_pulse_set_hook(hit_pulse_hook_t hook);
+
+#endif
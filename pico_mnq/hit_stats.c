@@ -0,0 +1,107 @@
+#include "hit_stats.h"
+#include "hardware/sync.h"
+#include <stdio.h>
+
+// stdio 명령 확인 주기 (getchar가 busy-poll 루프를 늦추지 않게)
+#define HIT_STATS_POLL_US       10000u
+
+hit_stats_ch_t g_hit_stats[HIT_STATS_MAX_CH];
+
+static uint g_ch_count = 0;
+static uint64_t g_next_poll_us = 0;
+static void (*g_extra_dump)(void) = NULL;
+static void (*g_extra_reset)(void) = NULL;
+static bool (*g_cmd)(int c) = NULL;
+
+// shift(bucket 폭)는 유지
+void hit_hist_clear(hit_hist_t *h) {
+    for (uint i = 0; i < HIT_STATS_BUCKETS; i++) h->bucket[i] = 0;
+    h->count = 0;
+    h->min_us = UINT32_MAX;
+    h->max_us = 0;
+    h->sum_us = 0;
+}
+
+void hit_stats_init(const char *const *names, uint n, uint edge_shift, uint out_shift) {
+    if (n > HIT_STATS_MAX_CH) n = HIT_STATS_MAX_CH;
+    g_ch_count = n;
+    for (uint i = 0; i < n; i++) {
+        hit_stats_ch_t *c = &g_hit_stats[i];
+        c->name = names[i];
+        c->edge_to_confirm.shift = (uint8_t)edge_shift;
+        c->confirm_to_out.shift = (uint8_t)out_shift;
+        c->pend_head = c->pend_tail = 0;
+    }
+    hit_stats_reset();
+}
+
+void hit_stats_reset(void) {
+    // 히스토그램/카운터는 IRQ에서도 기록 (P1/P2 판정 alarm, GPIO 엣지, HIT hook) → 인터럽트 막고 초기화
+    uint32_t irq_state = save_and_disable_interrupts();
+    for (uint i = 0; i < g_ch_count; i++) {
+        hit_stats_ch_t *c = &g_hit_stats[i];
+        hit_hist_clear(&c->edge_to_confirm);
+        hit_hist_clear(&c->confirm_to_out);
+        c->lockout = 0;
+        c->out_drop = 0;
+        c->irq_suppressed = 0;
+    }
+    restore_interrupts(irq_state);
+}
+
+// "  e2c n=.. min/avg/max=../../.. us | w=1024us: 0 3 12 1" (마지막 0이 아닌 bucket까지만)
+void hit_hist_dump(const char *label, const hit_hist_t *h) {
+    if (h->count == 0) {
+        printf("  %s n=0\n", label);
+        return;
+    }
+    int last = HIT_STATS_BUCKETS - 1;
+    while (last > 0 && h->bucket[last] == 0) last--;
+
+    printf("  %s n=%lu min/avg/max=%lu/%lu/%lu us | w=%luus:",
+           label, (unsigned long)h->count,
+           (unsigned long)h->min_us, (unsigned long)(h->sum_us / h->count), (unsigned long)h->max_us,
+           (unsigned long)(1ul << h->shift));
+    for (int i = 0; i <= last; i++) printf(" %lu", (unsigned long)h->bucket[i]);
+    printf("%s\n", last == HIT_STATS_BUCKETS - 1 ? "+" : "");
+}
+
+void hit_stats_dump(void) {
+    // 출력 중 IRQ가 값을 바꿔도 되도록 복사해서 출력
+    for (uint i = 0; i < g_ch_count; i++) {
+        hit_stats_ch_t snap;
+        uint32_t irq_state = save_and_disable_interrupts();
+        snap = g_hit_stats[i];
+        restore_interrupts(irq_state);
+
+        printf("hit %u %s: lockout=%lu drop=%lu irq=%lu\n", i, snap.name ? snap.name : "-",
+               (unsigned long)snap.lockout, (unsigned long)snap.out_drop, (unsigned long)snap.irq_suppressed);
+        hit_hist_dump("e2c", &snap.edge_to_confirm);
+        hit_hist_dump("c2o", &snap.confirm_to_out);
+    }
+}
+
+void hit_stats_poll(uint64_t now_us) {
+    if (now_us < g_next_poll_us) return;
+    g_next_poll_us = now_us + HIT_STATS_POLL_US;
+
+    int c = getchar_timeout_us(0);
+    if (g_cmd && g_cmd(c)) {
+        // 다른 모듈 명령
+    } else if (c == 's') {
+        hit_stats_dump();
+        if (g_extra_dump) g_extra_dump();
+    } else if (c == 'r') {
+        hit_stats_reset();
+        if (g_extra_reset) g_extra_reset();
+    }
+}
+
+void hit_stats_set_extra(void (*dump)(void), void (*reset)(void)) {
+    g_extra_dump = dump;
+    g_extra_reset = reset;
+}
+
+void hit_stats_set_cmd(bool (*cmd)(int c)) {
+    g_cmd = cmd;
+}
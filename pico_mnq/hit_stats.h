@@ -0,0 +1,113 @@
+#ifndef HIT_STATS_H
+#define HIT_STATS_H
+
+#include "pico/stdlib.h"
+
+/*
+탄 감지 통계 (항상 켜둠, 채널별)
+- edge → confirm : 입력 엣지부터 판정 확정까지 (us)
+- confirm → out  : 판정 확정부터 HIT 핀이 실제로 HIGH 될 때까지 (us, hit_pulse hook으로 기록)
+                   DETECT_HIT_LINK == 2면 HIT record가 UART 선로에 나간 시각까지 (hit_link hook)
+- lockout        : 락아웃/확인 중이라 버려진 엣지 수
+- irq            : IRQ guard holdoff 동안 걸러진 엣지가 있었던 횟수 (irq_guard.c 사용 펌웨어만)
+- 히스토그램은 고정 폭 bucket (폭 = 1 << shift us), 마지막 bucket은 그 이상 전부
+- 기록 비용: shift 1번 + 비교/증가 몇 번 (나눗셈, 부동소수점 없음)
+- stdio : s = 출력, r = 초기화 (hit_stats_poll), 그 밖의 문자는 hit_stats_set_cmd로 넘김
+- 기록은 main 또는 IRQ(P1/P2 alarm 판정, GPIO 엣지, hit_pulse/hit_link alarm)에서, 모두 같은 core
+  → s / r(main)은 인터럽트를 끄고 복사/초기화 (출력 중 IRQ가 바꾼 값과 섞이지 않음)
+*/
+
+#define HIT_STATS_MAX_CH        4
+#define HIT_STATS_BUCKETS       16
+#define HIT_STATS_PENDING       4       // confirm 후 아직 HIT 출력 안 된 것 (2의 거듭제곱)
+
+typedef struct {
+    uint8_t  shift;                     // bucket 폭 = 1 << shift (us)
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+    uint32_t bucket[HIT_STATS_BUCKETS];
+} hit_hist_t;
+
+typedef struct {
+    const char *name;
+    hit_hist_t edge_to_confirm;         // hit_stats_confirm (main, P1/P2 IRQ 판정은 alarm IRQ)
+    hit_hist_t confirm_to_out;          // hit_pulse / hit_link hook (main 또는 alarm IRQ)
+    uint32_t lockout;                   // 버려진 엣지 수 (main 또는 GPIO IRQ)
+    uint32_t out_drop;                  // HIT 출력 요청 실패 수
+    uint32_t irq_suppressed;            // IRQ guard가 걸러낸 holdoff 수 (alarm IRQ에서만 씀)
+
+    // confirm 시각 대기열 (hit_stats_confirm push → hook pop, 쓰는 쪽이 하나씩이라 lock 없음)
+    volatile uint32_t pend_head;
+    volatile uint32_t pend_tail;
+    uint32_t pend_us[HIT_STATS_PENDING];
+} hit_stats_ch_t;
+
+extern hit_stats_ch_t g_hit_stats[HIT_STATS_MAX_CH];
+
+// names: 채널 이름 (n개), edge_shift / out_shift: 각 히스토그램 bucket 폭 (1 << shift us)
+void hit_stats_init(const char *const *names, uint n, uint edge_shift, uint out_shift);
+void hit_stats_reset(void);
+void hit_stats_dump(void);
+
+// stdio 명령 확인 (poll_interval_us 마다 1번만 getchar, 나머지는 바로 반환)
+void hit_stats_poll(uint64_t now_us);
+
+// s / r 때 같이 실행할 다른 모듈 통계 출력/초기화 (NULL이면 없음)
+void hit_stats_set_extra(void (*dump)(void), void (*reset)(void));
+
+// s / r 보다 먼저 받는 stdio 문자 처리 (true면 s / r로 보지 않음, 파라미터 줄 입력 등), NULL이면 없음
+void hit_stats_set_cmd(bool (*cmd)(int c));
+
+// 히스토그램 초기화(shift 유지) / "  label n=.. min/avg/max=.. | w=..us: ..." 출력 (다른 모듈 지연 측정에도 사용)
+void hit_hist_clear(hit_hist_t *h);
+void hit_hist_dump(const char *label, const hit_hist_t *h);
+
+static inline void hit_hist_add(hit_hist_t *h, uint32_t us) {
+    uint32_t b = us >> h->shift;
+    if (b >= HIT_STATS_BUCKETS) b = HIT_STATS_BUCKETS - 1u;
+    h->bucket[b]++;
+    h->count++;
+    h->sum_us += us;
+    if (us < h->min_us) h->min_us = us;
+    if (us > h->max_us) h->max_us = us;
+}
+
+// 판정 확정 : edge→confirm 기록, HIT 출력 대기열에 confirm 시각 추가 (hit_pulse_fire 전에 호출)
+static inline void hit_stats_confirm(uint ch, uint64_t edge_us, uint64_t confirm_us) {
+    hit_stats_ch_t *c = &g_hit_stats[ch];
+    hit_hist_add(&c->edge_to_confirm, (uint32_t)(confirm_us - edge_us));
+
+    uint32_t head = c->pend_head;
+    if (head - c->pend_tail < HIT_STATS_PENDING) {
+        c->pend_us[head & (HIT_STATS_PENDING - 1u)] = (uint32_t)confirm_us;
+        c->pend_head = head + 1u;
+    }
+}
+
+// HIT 핀 HIGH 시각 (hit_pulse hook에서 호출) : 가장 오래된 confirm 시각과 짝지어 기록
+static inline void hit_stats_output(uint ch, uint64_t out_us) {
+    hit_stats_ch_t *c = &g_hit_stats[ch];
+    uint32_t tail = c->pend_tail;
+    if (tail == c->pend_head) return;
+    hit_hist_add(&c->confirm_to_out, (uint32_t)out_us - c->pend_us[tail & (HIT_STATS_PENDING - 1u)]);
+    c->pend_tail = tail + 1u;
+}
+
+// hit_pulse_fire 실패 : 방금 넣은 confirm 시각 취소 (인터럽트 비활성 상태에서 호출)
+static inline void hit_stats_out_drop(uint ch) {
+    hit_stats_ch_t *c = &g_hit_stats[ch];
+    c->out_drop++;
+    if (c->pend_head != c->pend_tail) c->pend_head--;
+}
+
+static inline void hit_stats_lockout(uint ch) {
+    g_hit_stats[ch].lockout++;
+}
+
+static inline void hit_stats_irq_suppressed(uint ch) {
+    g_hit_stats[ch].irq_suppressed++;
+}
+
+#endif
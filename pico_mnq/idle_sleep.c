@@ -0,0 +1,78 @@
+#include "idle_sleep.h"
+#include "hit_stats.h"
+#include "hardware/sync.h"
+#include <stdio.h>
+
+// timer 깨우기 지연 히스토그램 bucket 폭 (1 << shift us)
+#define IDLE_WAKE_SHIFT         0u
+
+static uint64_t g_since_us = 0;         // 통계 시작 시각
+static uint64_t g_sleep_us = 0;         // __wfi 안에 있던 시간
+static uint32_t g_wake_timer = 0;       // deadline alarm으로 깨어남
+static uint32_t g_wake_irq = 0;         // deadline 전에 다른 IRQ로 깨어남
+static uint32_t g_skip = 0;             // pending이라 잠들지 않음
+static hit_hist_t g_wake_lat;           // deadline → 깨어난 뒤 첫 명령 (us)
+
+// deadline alarm : 깨우기만 함
+static int64_t idle_alarm_cb(alarm_id_t id, void *user_data) {
+    (void)id;
+    (void)user_data;
+    return 0;
+}
+
+void idle_sleep_init(void) {
+    g_wake_lat.shift = IDLE_WAKE_SHIFT;
+    idle_sleep_reset();
+}
+
+bool idle_sleep_until(uint64_t deadline_us, idle_pending_fn pending) {
+    if ((int64_t)(deadline_us - time_us_64()) < (int64_t)IDLE_MIN_SLEEP_US) return false;
+
+    alarm_id_t id = add_alarm_at(from_us_since_boot(deadline_us), idle_alarm_cb, NULL, false);
+    if (id <= 0) return false;
+
+    bool slept = false;
+    uint32_t irq_state = save_and_disable_interrupts();
+    if (pending && pending()) {
+        g_skip++;
+    } else {
+        uint64_t t0 = time_us_64();
+        __wfi();
+        uint64_t t1 = time_us_64();     // 깨어난 뒤 첫 명령 (ISR은 아직)
+
+        g_sleep_us += t1 - t0;
+        if (t1 >= deadline_us) {
+            g_wake_timer++;
+            hit_hist_add(&g_wake_lat, (uint32_t)(t1 - deadline_us));
+        } else {
+            g_wake_irq++;
+        }
+        slept = true;
+    }
+    restore_interrupts(irq_state);
+
+    // 다른 IRQ로 먼저 깨어났으면 남은 alarm 정리 (이미 실행됐으면 아무것도 안 함)
+    cancel_alarm(id);
+    return slept;
+}
+
+void idle_sleep_reset(void) {
+    uint32_t irq_state = save_and_disable_interrupts();
+    g_since_us = time_us_64();
+    g_sleep_us = 0;
+    g_wake_timer = 0;
+    g_wake_irq = 0;
+    g_skip = 0;
+    hit_hist_clear(&g_wake_lat);
+    restore_interrupts(irq_state);
+}
+
+void idle_sleep_dump(void) {
+    uint64_t total = time_us_64() - g_since_us;
+    uint32_t permille = total ? (uint32_t)(g_sleep_us * 1000u / total) : 0;
+
+    printf("idle: sleep %lu.%lu%% wake timer=%lu irq=%lu skip=%lu\n",
+           (unsigned long)(permille / 10u), (unsigned long)(permille % 10u),
+           (unsigned long)g_wake_timer, (unsigned long)g_wake_irq, (unsigned long)g_skip);
+    hit_hist_dump("wake", &g_wake_lat);
+}
@@ -0,0 +1,32 @@
+#ifndef IDLE_SLEEP_H
+#define IDLE_SLEEP_H
+
+#include "pico/stdlib.h"
+
+/*
+main loop 저전력 대기 (tight_loop 회전 대신 __wfi)
+- idle_sleep_until(deadline, pending) : 인터럽트 막고 pending() 확인 → 할 일 없으면 __wfi
+  deadline에 hardware alarm을 걸어두므로 GPIO IRQ가 없어도 deadline에는 깨어남
+- 인터럽트 비활성(PRIMASK) 상태로 __wfi → 확인과 잠들기 사이에 들어온 IRQ도 놓치지 않음 (pending이면 바로 깨어남)
+  깨어난 뒤 첫 명령은 ISR보다 먼저 실행 → alarm 깨우기는 deadline부터 첫 명령까지 지연을 그대로 측정
+- GPIO 등 다른 IRQ로 깨어난 경우는 IRQ 발생 시각을 모르므로 횟수만 셈
+- 통계 : 잠든 시간 비율, 깨어난 횟수(timer/irq), timer 깨우기 지연 히스토그램 (1us 폭)
+*/
+
+// 남은 시간이 이보다 짧으면 잠들지 않고 바로 반환 (alarm 설정 비용보다 짧은 대기)
+#ifndef IDLE_MIN_SLEEP_US
+#define IDLE_MIN_SLEEP_US       20u
+#endif
+
+// 인터럽트 비활성 상태에서 호출, true면 잠들지 않음 (ISR이 넘긴 일이 남아 있는지)
+typedef bool (*idle_pending_fn)(void);
+
+void idle_sleep_init(void);
+
+// deadline_us까지 또는 IRQ가 올 때까지 잠듦. 실제로 잠들었으면 true
+bool idle_sleep_until(uint64_t deadline_us, idle_pending_fn pending);
+
+void idle_sleep_reset(void);
+void idle_sleep_dump(void);
+
+#endif
@@ -0,0 +1,126 @@
+#include "irq_guard.h"
+#include "hardware/gpio.h"
+#include "hardware/structs/iobank0.h"
+#include "hardware/sync.h"
+#include <stdio.h>
+
+// ------------ pin state ------------
+typedef struct {
+    uint gpio;
+    uint32_t events;                    // 껐다 켤 IRQ 이벤트
+    volatile alarm_id_t alarm;          // holdoff 중이면 재활성 alarm, 0이면 IRQ 켜짐
+    irq_guard_stats_t st;
+} guard_pin_t;
+
+static guard_pin_t g_pins[IRQ_GUARD_MAX_PINS];
+static uint g_pin_count = 0;
+static uint8_t g_pin_idx[32];           // GPIO → g_pins 인덱스
+static uint32_t g_holdoff_us = 0;
+static irq_guard_hook_t g_hook = NULL;
+
+#define PIN_NONE                0xffu
+
+// raw latch에서 GPIO 1개의 엣지 이벤트 (EDGE_FALL/EDGE_RISE bit 위치는 gpio_irq_level과 같음)
+static inline uint32_t latched_events(uint gpio) {
+    uint32_t raw = io_bank0_hw->intr[gpio >> 3] >> (4u * (gpio & 7u));
+    return raw & (GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL);
+}
+
+// holdoff 끝 (alarm IRQ context) : latch 확인 → IRQ 재활성 (gpio_set_irq_enabled가 latch를 지움)
+static int64_t rearm_cb(alarm_id_t id, void *user_data) {
+    (void)id;
+    guard_pin_t *p = &g_pins[(uint)(uintptr_t)user_data];
+
+    uint32_t latched = latched_events(p->gpio) & p->events;
+    if (latched) p->st.suppressed++;
+
+    p->alarm = 0;
+    gpio_set_irq_enabled(p->gpio, p->events, true);
+
+    if (latched && g_hook) g_hook(p->gpio, latched, time_us_64());
+    return 0;
+}
+
+void irq_guard_init(uint32_t holdoff_us) {
+    g_holdoff_us = holdoff_us;
+    g_pin_count = 0;
+    for (uint i = 0; i < 32; i++) g_pin_idx[i] = PIN_NONE;
+}
+
+bool irq_guard_add_pin(uint gpio, uint32_t events) {
+    if (gpio >= 32) return false;
+    if (g_pin_idx[gpio] != PIN_NONE) return true;
+    if (g_pin_count >= IRQ_GUARD_MAX_PINS) return false;
+
+    guard_pin_t *p = &g_pins[g_pin_count];
+    p->gpio = gpio;
+    p->events = events;
+    p->alarm = 0;
+    p->st.held = 0;
+    p->st.suppressed = 0;
+    g_pin_idx[gpio] = (uint8_t)g_pin_count++;
+    return true;
+}
+
+bool irq_guard_hold(uint gpio) {
+    if (g_holdoff_us == 0 || gpio >= 32 || g_pin_idx[gpio] == PIN_NONE) return false;
+    uint idx = g_pin_idx[gpio];
+    guard_pin_t *p = &g_pins[idx];
+    if (p->alarm != 0) return false;
+
+    // IRQ 끄기 (latch도 지움 → 재활성 때 latch = holdoff 동안 들어온 엣지)
+    gpio_set_irq_enabled(gpio, p->events, false);
+    alarm_id_t id = add_alarm_in_us(g_holdoff_us, rearm_cb, (void *)(uintptr_t)idx, true);
+    if (id <= 0) {
+        // alarm 슬롯 없음 → 꺼진 채로 남지 않게 바로 다시 켬
+        gpio_set_irq_enabled(gpio, p->events, true);
+        return false;
+    }
+    p->alarm = id;
+    p->st.held++;
+    return true;
+}
+
+void irq_guard_release_all(void) {
+    uint32_t irq_state = save_and_disable_interrupts();
+    for (uint i = 0; i < g_pin_count; i++) {
+        guard_pin_t *p = &g_pins[i];
+        if (p->alarm == 0) continue;
+        cancel_alarm(p->alarm);
+        p->alarm = 0;
+        gpio_set_irq_enabled(p->gpio, p->events, true);
+    }
+    restore_interrupts(irq_state);
+}
+
+void irq_guard_set_hook(irq_guard_hook_t hook) {
+    g_hook = hook;
+}
+
+bool irq_guard_get(uint idx, uint *gpio, irq_guard_stats_t *out) {
+    if (idx >= g_pin_count) return false;
+    uint32_t irq_state = save_and_disable_interrupts();
+    *gpio = g_pins[idx].gpio;
+    *out = g_pins[idx].st;
+    restore_interrupts(irq_state);
+    return true;
+}
+
+void irq_guard_reset(void) {
+    uint32_t irq_state = save_and_disable_interrupts();
+    for (uint i = 0; i < g_pin_count; i++) {
+        g_pins[i].st.held = 0;
+        g_pins[i].st.suppressed = 0;
+    }
+    restore_interrupts(irq_state);
+}
+
+void irq_guard_dump(void) {
+    printf("irq guard: holdoff=%luus\n", (unsigned long)g_holdoff_us);
+    for (uint i = 0; i < g_pin_count; i++) {
+        uint gpio;
+        irq_guard_stats_t st;
+        irq_guard_get(i, &gpio, &st);
+        printf("  gpio %u: held=%lu suppressed=%lu\n", gpio, (unsigned long)st.held, (unsigned long)st.suppressed);
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef IRQ_GUARD_H
+#define IRQ_GUARD_H
+
+#include "pico/stdlib.h"
+
+/*
+GPIO IRQ storm guard (DETECT 입력, 모터 EMI / 센서 채터링 대비)
+- 인정된 엣지 뒤 irq_guard_hold() → 그 핀 IRQ 끄고, hardware alarm이 holdoff 뒤 다시 켬
+- holdoff 동안 들어온 엣지는 IRQ 없이 IO_BANK0 raw latch(INTR)에만 남음 → 재활성 때 확인해서 suppressed 기록
+  latch는 엣지 종류마다 1bit라 holdoff 1번에 최대 1로 셈 (실제로 걸러진 엣지 수의 하한)
+- 핀당 IRQ는 holdoff마다 최대 1번 → 잡음이 아무리 심해도 ISR 부하 상한 = 핀 수 / holdoff
+- 재활성 hook : latch에 엣지가 있었으면 alarm IRQ 안에서 호출 (늦게 온 엣지 처리, 통계용), NULL이면 사용 안 함
+- IRQ를 켜고 끄는 core = 호출한 core (gpio IRQ 콜백과 같은 core의 기본 alarm pool 사용)
+*/
+
+#define IRQ_GUARD_MAX_PINS      8
+
+typedef struct {
+    uint32_t held;                      // holdoff 시작 횟수 (인정된 엣지)
+    uint32_t suppressed;                // 엣지를 걸러낸 holdoff 수 (latch 기준)
+} irq_guard_stats_t;
+
+// holdoff_us : 0이면 guard 없음 (irq_guard_hold가 아무것도 안 함)
+void irq_guard_init(uint32_t holdoff_us);
+
+// guard할 핀과 IRQ 이벤트 등록 (IRQ 설정은 호출 쪽에서, 이 이벤트만 껐다 켬)
+bool irq_guard_add_pin(uint gpio, uint32_t events);
+
+// GPIO IRQ 콜백에서 인정된 엣지 뒤 호출. 이미 holdoff 중이거나 등록 안 된 핀이면 false
+bool irq_guard_hold(uint gpio);
+
+// holdoff 중인 핀 모두 바로 IRQ 재활성 (alarm 취소, hook 호출 안 함). holdoff를 건 core에서 호출
+void irq_guard_release_all(void);
+
+// 재활성 때 latch에 엣지가 있었으면 호출 (alarm IRQ context)
+typedef void (*irq_guard_hook_t)(uint gpio, uint32_t latched_events, uint64_t t_us);
+void irq_guard_set_hook(irq_guard_hook_t hook);
+
+// 통계 (핀 등록 순서 = idx)
+bool irq_guard_get(uint idx, uint *gpio, irq_guard_stats_t *out);
+void irq_guard_reset(void);
+void irq_guard_dump(void);
+
+#endif
@@ -0,0 +1,196 @@
+# 1ms_x_5times 판정 지연 벤치마크 (보드에서 실행) : Python 루프 vs mnqdetect (C module)
+# - 자극 : STIM_PIN PWM (하드웨어, CPU 안 씀) 주기 PERIOD_MS, HIGH PULSE_MS → 점퍼로 DETECT_2
+# - 측정 : 자극 상승과 HIT_1 상승(점퍼로 SENSE_PIN)을 hard IRQ에서 ticks_us로 기록 (두 경로 모두 같은 방법)
+#          지연 = HIT 상승 - 자극 상승, 판정 창(5 x 1ms)을 뺀 나머지가 경로 오버헤드
+# - 경로마다 부하 없음 / 부하(루프마다 작은 객체 할당 → 주기적인 GC) 두 번
+#   부하 없음은 gc.disable() 상태에서 샷당 할당 byte도 출력
+#
+# 배선 : GPIO 16 → GPIO 4 (DETECT_2), GPIO 12 (HIT_1) → GPIO 17
+# mpremote run pico_mnq/mnqdetect/bench_mnqdetect.py
+
+from machine import Pin, PWM
+import machine
+import array
+import gc
+import utime
+import micropython
+
+try:
+    import mnqdetect
+except ImportError:
+    mnqdetect = None
+
+DETECT_2 = 4
+HIT_1 = 12          # DETECT_2용 출력
+STIM_PIN = 16
+SENSE_PIN = 17
+
+PERIOD_MS = 50
+PULSE_MS = 8
+SHOTS = 200
+WINDOW_US = 5 * 1000    # 판정 창 (samples x sample_us)
+MISS_US = 40000         # 자극 후 이 안에 HIT가 없으면 누락
+
+micropython.alloc_emergency_exception_buf(100)
+
+# ------------ 측정 (hard IRQ, 할당 없음) ------------
+N = SHOTS + 8
+t_stim = array.array('i', bytes(4 * N))
+t_hit = array.array('i', bytes(4 * N))
+n_stim = 0
+n_hit = 0
+
+def _stim_irq(_p):
+    global n_stim
+    if n_stim < N:
+        t_stim[n_stim] = utime.ticks_us()
+        n_stim += 1
+
+def _hit_irq(_p):
+    global n_hit
+    if n_hit < N:
+        t_hit[n_hit] = utime.ticks_us()
+        n_hit += 1
+
+detect2 = Pin(DETECT_2, Pin.IN, Pin.PULL_DOWN)
+stim = Pin(STIM_PIN, Pin.OUT, value=0)
+sense = Pin(SENSE_PIN, Pin.IN, Pin.PULL_DOWN)
+
+# ------------ 부하 ------------
+junk = None
+
+def load_step():
+    global junk
+    junk = [0] * 16     # 64+ byte, 수백 번마다 GC
+
+# ------------ Python 경로 (1ms_x_5times.py 루프 그대로, DETECT_2 → HIT_1) ------------
+flag2 = False
+
+def _irq_detect2(_pin):
+    global flag2
+    flag2 = True
+
+def readsignal_detect(pin):
+    if pin.value() == 0:
+        return False
+    for _ in range(5):
+        if pin.value() == 0:
+            return False
+        utime.sleep_ms(1)
+    return True
+
+def python_setup():
+    global hit1
+    hit1 = Pin(HIT_1, Pin.OUT, value=0)
+    detect2.irq(trigger=Pin.IRQ_RISING, handler=_irq_detect2)
+
+def python_step(load):
+    global flag2
+    irq_state = machine.disable_irq()
+    d2 = flag2; flag2 = False
+    machine.enable_irq(irq_state)
+    if d2:
+        if readsignal_detect(detect2):
+            hit1.value(1)
+            print("D2")
+            utime.sleep_ms(10)
+        hit1.value(0)
+    if load:
+        load_step()
+    utime.sleep_ms(1)
+
+def python_teardown():
+    detect2.irq(handler=None)
+    hit1.value(0)
+
+# ------------ mnqdetect 경로 ------------
+ev = array.array('i', bytes(4 * 4 * 8))
+
+def native_setup():
+    mnqdetect.init(((DETECT_2, HIT_1),), samples=5, sample_us=1000, pulse_us=10000, gap_us=5000)
+    detect2.irq(trigger=Pin.IRQ_RISING, handler=mnqdetect.edge, hard=True)
+
+def native_step(load):
+    mnqdetect.read(ev)      # 이벤트는 버림 (측정은 SENSE 핀)
+    if load:
+        load_step()
+    utime.sleep_ms(1)
+
+def native_teardown():
+    detect2.irq(handler=None)
+    mnqdetect.deinit()
+
+# ------------ 실행 ------------
+def run(name, setup, step, teardown, load):
+    global n_stim, n_hit
+    setup()
+    stim.irq(trigger=Pin.IRQ_RISING, handler=_stim_irq, hard=True)
+    sense.irq(trigger=Pin.IRQ_RISING, handler=_hit_irq, hard=True)
+
+    gc.collect()
+    if not load:
+        gc.disable()
+    a0 = gc.mem_alloc()
+    n_stim = 0
+    n_hit = 0
+    pwm = PWM(Pin(STIM_PIN))
+    pwm.freq(1000 // PERIOD_MS)
+    pwm.duty_u16(65535 * PULSE_MS // PERIOD_MS)
+
+    while n_stim < SHOTS:
+        step(load)
+    t_end = utime.ticks_add(utime.ticks_us(), MISS_US)
+    while utime.ticks_diff(t_end, utime.ticks_us()) > 0:
+        step(load)
+
+    pwm.deinit()
+    stim.init(Pin.OUT, value=0)
+    a1 = gc.mem_alloc()
+    gc.enable()
+    stim.irq(handler=None)
+    sense.irq(handler=None)
+    teardown()
+    report(name, load, (a1 - a0) // SHOTS if not load else -1)
+
+def pct(v, p):
+    return v[min(len(v) - 1, len(v) * p // 100)]
+
+def report(name, load, alloc):
+    # 자극마다 그 뒤 MISS_US 안의 첫 HIT
+    lat = []
+    miss = 0
+    j = 0
+    for i in range(min(n_stim, SHOTS)):
+        s = t_stim[i]
+        while j < n_hit and utime.ticks_diff(t_hit[j], s) < 0:
+            j += 1
+        if j < n_hit and utime.ticks_diff(t_hit[j], s) < MISS_US:
+            lat.append(utime.ticks_diff(t_hit[j], s))
+            j += 1
+        else:
+            miss += 1
+    lat.sort()
+    tag = "%s %s" % (name, "load" if load else "idle")
+    if not lat:
+        print("%-14s no hits, miss %d" % (tag, miss))
+        return
+    mean = sum(lat) // len(lat)
+    print("%-14s n %3d miss %2d  min %5d p50 %5d p90 %5d p99 %5d max %5d mean %5d  over %5d us%s" % (
+        tag, len(lat), miss, lat[0], pct(lat, 50), pct(lat, 90), pct(lat, 99), lat[-1], mean,
+        pct(lat, 99) - WINDOW_US, "" if alloc < 0 else "  alloc %d B/shot" % alloc))
+    # 500us 폭 히스토그램
+    b0 = lat[0] // 500
+    hist = [0] * (lat[-1] // 500 - b0 + 1)
+    for v in lat:
+        hist[v // 500 - b0] += 1
+    for k, c in enumerate(hist):
+        if c:
+            print("    %6d us | %s %d" % ((b0 + k) * 500, "#" * (c * 40 // len(lat)), c))
+
+print("edge -> HIT latency (us), over = p99 - %d us debounce window" % WINDOW_US)
+for load in (False, True):
+    run("python", python_setup, python_step, python_teardown, load)
+    if mnqdetect is not None:
+        run("mnqdetect", native_setup, native_step, native_teardown, load)
+if mnqdetect is None:
+    print("mnqdetect not in this firmware (build with USER_C_MODULES=pico_mnq/mnqdetect/micropython.cmake)")
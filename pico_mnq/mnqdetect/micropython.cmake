@@ -0,0 +1,15 @@
+# MicroPython user C module : mnqdetect (1ms_x_5times.c 채널 디바운스 + HIT 펄스, rp2 port)
+# cd micropython/ports/rp2 && make BOARD=RPI_PICO USER_C_MODULES=<repo>/pico_mnq/mnqdetect/micropython.cmake
+add_library(usermod_mnqdetect INTERFACE)
+
+target_sources(usermod_mnqdetect INTERFACE
+    ${CMAKE_CURRENT_LIST_DIR}/modmnqdetect.c
+    ${CMAKE_CURRENT_LIST_DIR}/../hit_pulse.c
+)
+
+target_include_directories(usermod_mnqdetect INTERFACE
+    ${CMAKE_CURRENT_LIST_DIR}
+    ${CMAKE_CURRENT_LIST_DIR}/..
+)
+
+target_link_libraries(usermod INTERFACE usermod_mnqdetect)
@@ -0,0 +1,360 @@
+#include "py/runtime.h"
+#include "py/mphal.h"
+
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+#include "hardware/sync.h"
+#include <string.h>
+
+#include "hit_pulse.h"
+#include "vcount.h"
+
+/*
+MicroPython user C module : mnqdetect
+../../1ms_x_5times.c (detect_engine.h CHANNEL 방식) 판정을 MicroPython 안에서 그대로 실행
+- 판정/HIT 펄스는 전부 IRQ context의 C 코드 (인터프리터, GC, print와 무관), Python은 설정과 이벤트 수신만
+- 상승엣지 : Pin.irq(handler=mnqdetect.edge, hard=True) → 엣지 시각 기록 + 채널 arm (할당 없음)
+- 샘플 : armed 채널이 있는 동안만 sample_us repeating timer (기본 alarm pool), gpio_get_all() 1회로 전 채널 세로 카운터(vcount.h)
+  samples회 연속 HIGH면 hit_pulse_fire (../hit_pulse.c, 펄스 중에도 감지 계속), LOW가 나오면 disarm
+  첫 arm은 엣지 + sample_us에 첫 샘플 → 확정 = 엣지 + samples × sample_us (이미 돌고 있으면 다음 tick부터, 최대 + 1 tick)
+- 이벤트 : HIT 핀이 실제로 올라간 시각에 링에 push (hit 핀 -1이면 확정 시각에)
+  read(buf)가 호출 쪽이 미리 만든 array('i')에 복사 → Python 쪽 수신도 할당 없음
+  이벤트 1개 = EVENT_WORDS(4)개 int : ch, edge_ticks, edge → confirm us, confirm → HIT us
+  edge_ticks = 엣지 시각 time.ticks_us() 기준 (2^30 wrap, small int), 모든 값이 small int라 인덱싱도 할당 없음
+- IRQ storm guard (../irq_guard.c)는 쓰지 않음 (GPIO IRQ는 MicroPython machine.Pin 소유)
+
+  import mnqdetect
+  from machine import Pin
+  mnqdetect.init(((3, 13), (4, 12), (5, 14)), samples=5, sample_us=1000, pulse_us=10000, gap_us=5000)
+  for p in (3, 4, 5):
+      Pin(p, Pin.IN, Pin.PULL_DOWN).irq(trigger=Pin.IRQ_RISING, handler=mnqdetect.edge, hard=True)
+  ev = array.array('i', bytes(4 * mnqdetect.EVENT_WORDS * 8))
+  n = mnqdetect.read(ev)          # 꺼낸 이벤트 수
+*/
+
+#define MNQDETECT_MAX_CH        HIT_PULSE_MAX_LINES
+#define MNQDETECT_EVENT_WORDS   4
+
+// 2의 거듭제곱
+#define EVENT_RING_SIZE         32u
+#define PEND_SIZE               4u      // 채널별 HIT 송출 대기 (hit_pulse 대기열과 같이 감)
+
+#define TICKS_MASK              0x3fffffffu     // time.ticks_us() 주기 (MICROPY_PY_TIME_TICKS_PERIOD)
+
+typedef struct {
+    int32_t w[MNQDETECT_EVENT_WORDS];
+} mnq_event_t;
+
+// 확정됐지만 HIT 핀이 아직 안 올라간 샷 (gap 대기)
+typedef struct {
+    uint32_t edge_us;
+    uint32_t confirm_us;
+} mnq_pend_t;
+
+typedef struct {
+    uint     detect_pin;
+    int      hit_pin;               // -1이면 HIT 출력 없이 이벤트만
+    uint32_t edge_us;               // 확인을 시작시킨 상승엣지 시각 (time_us_32)
+    mnq_pend_t pend[PEND_SIZE];
+    uint8_t  pend_head;
+    uint8_t  pend_tail;
+} mnq_ch_t;
+
+static mnq_ch_t g_ch[MNQDETECT_MAX_CH];
+static uint g_ch_count = 0;
+static uint8_t g_pin_ch[32];            // GPIO → g_ch 인덱스
+static uint32_t g_mask = 0;             // DETECT 입력 bit
+
+static uint32_t g_samples = 5;
+static uint32_t g_sample_us = 1000;
+static bool g_ready = false;
+
+static uint32_t g_armed = 0;            // 확인 중인 입력 bit
+static vcount_t g_cnt;
+static repeating_timer_t g_tick;
+static bool g_tick_on = false;
+
+// IRQ → Python 이벤트 (SPSC, producer = IRQ, consumer = read)
+static mnq_event_t g_ev[EVENT_RING_SIZE];
+static volatile uint32_t g_ev_head = 0;
+static volatile uint32_t g_ev_tail = 0;
+
+// 통계
+static volatile uint32_t g_stat_edges = 0;
+static volatile uint32_t g_stat_lockout = 0;    // 확인 중에 들어온 엣지
+static volatile uint32_t g_stat_hits = 0;
+static volatile uint32_t g_stat_drop = 0;       // HIT 펄스 예약 실패
+static volatile uint32_t g_stat_lost = 0;       // 이벤트 링이 가득 차서 버림
+
+// ------------ 이벤트 ------------
+static void event_push(uint ch, uint32_t edge_us, uint32_t confirm_us, uint32_t out_us) {
+    uint32_t head = g_ev_head;
+    if (head - g_ev_tail >= EVENT_RING_SIZE) {
+        g_stat_lost++;
+        return;
+    }
+    mnq_event_t *e = &g_ev[head & (EVENT_RING_SIZE - 1u)];
+    e->w[0] = (int32_t)ch;
+    e->w[1] = (int32_t)(edge_us & TICKS_MASK);
+    e->w[2] = (int32_t)((confirm_us - edge_us) & TICKS_MASK);
+    e->w[3] = (int32_t)((out_us - confirm_us) & TICKS_MASK);
+
+    __mem_fence_release();
+    g_ev_head = head + 1u;
+}
+
+// HIT 핀 HIGH (hit_pulse hook, alarm IRQ 또는 hit_pulse_fire 안에서)
+static void on_hit_raise(uint pin, uint64_t t_us) {
+    for (uint i = 0; i < g_ch_count; i++) {
+        mnq_ch_t *c = &g_ch[i];
+        if (c->hit_pin != (int)pin) continue;
+        if (c->pend_head == c->pend_tail) return;
+        const mnq_pend_t *p = &c->pend[c->pend_tail & (PEND_SIZE - 1u)];
+        c->pend_tail++;
+        event_push(i, p->edge_us, p->confirm_us, (uint32_t)t_us);
+        return;
+    }
+}
+
+// ------------ 판정 (IRQ context) ------------
+static void detect_fire(uint ch) {
+    mnq_ch_t *c = &g_ch[ch];
+    uint32_t confirm_us = time_us_32();
+    g_stat_hits++;
+
+    if (c->hit_pin < 0) {
+        event_push(ch, c->edge_us, confirm_us, confirm_us);
+        return;
+    }
+
+    // 대기열이 가득 차도 펄스는 냄 (이벤트만 빠짐)
+    bool queued = (uint8_t)(c->pend_head - c->pend_tail) < PEND_SIZE;
+    if (queued) {
+        mnq_pend_t *p = &c->pend[c->pend_head & (PEND_SIZE - 1u)];
+        p->edge_us = c->edge_us;
+        p->confirm_us = confirm_us;
+        c->pend_head++;
+    } else {
+        g_stat_lost++;
+    }
+    uint8_t tail = c->pend_tail;
+    if (!hit_pulse_fire((uint)c->hit_pin)) {
+        g_stat_drop++;
+        // hook이 안 불렸으면 (HIT 핀이 안 올라감) 방금 넣은 항목 회수
+        if (queued && c->pend_tail == tail) c->pend_head--;
+    }
+}
+
+// sample_us tick : armed 채널 동시 샘플, 없으면 timer 정지
+// GPIO IRQ(edge)와 timer IRQ는 같은 core0 기본 우선순위 → 서로 끼어들지 않음
+static bool tick_cb(repeating_timer_t *rt) {
+    (void)rt;
+    uint32_t high = gpio_get_all() & g_armed;
+    g_armed = high;                     // LOW가 나온 채널은 disarm
+    vcount_inc(&g_cnt, high);
+
+    uint32_t done = vcount_eq(&g_cnt, g_samples) & high;
+    g_armed &= ~done;
+    while (done) {
+        uint pin = (uint)__builtin_ctz(done);
+        done &= done - 1u;
+        detect_fire(g_pin_ch[pin]);
+    }
+
+    g_tick_on = g_armed != 0;
+    return g_tick_on;
+}
+
+// Pin.irq(handler=mnqdetect.edge, hard=True) : hard IRQ 안에서 바로 호출됨 (할당/예외 없음)
+static mp_obj_t mnqdetect_edge(mp_obj_t pin_in) {
+    uint32_t t_us = time_us_32();
+    if (!g_ready) return mp_const_none;
+    uint gpio = mp_obj_is_small_int(pin_in) ? (uint)MP_OBJ_SMALL_INT_VALUE(pin_in) : (uint)mp_hal_get_pin_obj(pin_in);
+    if (gpio >= 32 || !((g_mask >> gpio) & 1u)) return mp_const_none;
+
+    uint32_t bit = 1u << gpio;
+    uint32_t irq_state = save_and_disable_interrupts();
+    g_stat_edges++;
+    if (g_armed & bit) {
+        g_stat_lockout++;
+    } else {
+        g_armed |= bit;
+        vcount_clear(&g_cnt, bit);
+        g_ch[g_pin_ch[gpio]].edge_us = t_us;
+        if (!g_tick_on) {
+            // 음수 = 시작 간격 고정 (첫 샘플 = 엣지 + sample_us)
+            g_tick_on = add_repeating_timer_us(-(int64_t)g_sample_us, tick_cb, NULL, &g_tick);
+            if (!g_tick_on) {
+                g_armed &= ~bit;
+                g_stat_drop++;
+            }
+        }
+    }
+    restore_interrupts(irq_state);
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(mnqdetect_edge_obj, mnqdetect_edge);
+
+// ------------ Python API ------------
+static void detect_stop(void) {
+    uint32_t irq_state = save_and_disable_interrupts();
+    g_ready = false;
+    if (g_tick_on) cancel_repeating_timer(&g_tick);
+    g_tick_on = false;
+    g_armed = 0;
+    restore_interrupts(irq_state);
+    hit_pulse_set_hook(NULL);
+    hit_pulse_clear();
+}
+
+static void stats_clear(void) {
+    g_stat_edges = 0;
+    g_stat_lockout = 0;
+    g_stat_hits = 0;
+    g_stat_drop = 0;
+    g_stat_lost = 0;
+}
+
+// init(channels, *, samples=5, sample_us=1000, pulse_us=10000, gap_us=5000, led=-1)
+// channels : ((detect 핀, hit 핀 또는 -1), ...) 최대 MNQDETECT_MAX_CH, hit 핀은 채널마다 달라야 함
+static mp_obj_t mnqdetect_init(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_channels, ARG_samples, ARG_sample_us, ARG_pulse_us, ARG_gap_us, ARG_led };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_channels,  MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_samples,   MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 5} },
+        { MP_QSTR_sample_us, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 1000} },
+        { MP_QSTR_pulse_us,  MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 10000} },
+        { MP_QSTR_gap_us,    MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 5000} },
+        { MP_QSTR_led,       MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = -1} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    if (args[ARG_samples].u_int < 1 || args[ARG_samples].u_int > (mp_int_t)VCOUNT_MAX) {
+        mp_raise_ValueError(MP_ERROR_TEXT("samples out of range"));
+    }
+    if (args[ARG_sample_us].u_int < 100 || args[ARG_pulse_us].u_int < 1 || args[ARG_gap_us].u_int < 0) {
+        mp_raise_ValueError(MP_ERROR_TEXT("bad timing"));
+    }
+
+    size_t n;
+    mp_obj_t *items;
+    mp_obj_get_array(args[ARG_channels].u_obj, &n, &items);
+    if (n < 1 || n > MNQDETECT_MAX_CH) mp_raise_ValueError(MP_ERROR_TEXT("1..4 channels"));
+
+    detect_stop();
+
+    g_ch_count = 0;
+    g_mask = 0;
+    uint32_t hit_mask = 0;
+    for (size_t i = 0; i < n; i++) {
+        size_t m;
+        mp_obj_t *pair;
+        mp_obj_get_array(items[i], &m, &pair);
+        if (m != 2) mp_raise_ValueError(MP_ERROR_TEXT("channel needs (detect, hit)"));
+        mp_int_t detect = mp_obj_get_int(pair[0]);
+        mp_int_t hit = mp_obj_get_int(pair[1]);
+        if (detect < 0 || detect >= 30 || ((g_mask >> detect) & 1u) || hit < -1 || hit >= 30 ||
+            (hit >= 0 && ((hit_mask >> hit) & 1u))) {
+            mp_raise_ValueError(MP_ERROR_TEXT("bad or duplicate pin"));
+        }
+        mnq_ch_t *c = &g_ch[g_ch_count];
+        c->detect_pin = (uint)detect;
+        c->hit_pin = (int)hit;
+        c->edge_us = 0;
+        c->pend_head = 0;
+        c->pend_tail = 0;
+        g_pin_ch[detect] = (uint8_t)g_ch_count;
+        g_mask |= 1u << detect;
+        if (hit >= 0) hit_mask |= 1u << hit;
+        g_ch_count++;
+    }
+
+    g_samples = (uint32_t)args[ARG_samples].u_int;
+    g_sample_us = (uint32_t)args[ARG_sample_us].u_int;
+
+    hit_pulse_init((uint32_t)args[ARG_pulse_us].u_int, (uint32_t)args[ARG_gap_us].u_int, (int)args[ARG_led].u_int);
+    if (args[ARG_led].u_int >= 0) {
+        gpio_init((uint)args[ARG_led].u_int);
+        gpio_set_dir((uint)args[ARG_led].u_int, GPIO_OUT);
+        gpio_put((uint)args[ARG_led].u_int, 0);
+    }
+    for (uint i = 0; i < g_ch_count; i++) {
+        if (g_ch[i].hit_pin >= 0) hit_pulse_add_line((uint)g_ch[i].hit_pin);
+    }
+    hit_pulse_set_hook(on_hit_raise);
+
+    g_ev_tail = g_ev_head;
+    stats_clear();
+    g_ready = true;
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(mnqdetect_init_obj, 1, mnqdetect_init);
+
+static mp_obj_t mnqdetect_deinit(void) {
+    detect_stop();
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_0(mnqdetect_deinit_obj, mnqdetect_deinit);
+
+// read(buf) : 이벤트를 buf(array('i'), 4 byte word)에 복사, 꺼낸 이벤트 수 (할당 없음)
+static mp_obj_t mnqdetect_read(mp_obj_t buf_in) {
+    mp_buffer_info_t bi;
+    mp_get_buffer_raise(buf_in, &bi, MP_BUFFER_WRITE);
+    uint32_t max = (uint32_t)(bi.len / sizeof(mnq_event_t));
+
+    uint32_t tail = g_ev_tail;
+    uint32_t n = g_ev_head - tail;
+    __mem_fence_acquire();
+    if (n > max) n = max;
+    for (uint32_t i = 0; i < n; i++) {
+        memcpy((uint8_t *)bi.buf + i * sizeof(mnq_event_t), &g_ev[(tail + i) & (EVENT_RING_SIZE - 1u)], sizeof(mnq_event_t));
+    }
+    __mem_fence_release();
+    g_ev_tail = tail + n;
+    return MP_OBJ_NEW_SMALL_INT(n);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(mnqdetect_read_obj, mnqdetect_read);
+
+// 꺼내지 않은 이벤트 수
+static mp_obj_t mnqdetect_pending(void) {
+    return MP_OBJ_NEW_SMALL_INT(g_ev_head - g_ev_tail);
+}
+static MP_DEFINE_CONST_FUN_OBJ_0(mnqdetect_pending_obj, mnqdetect_pending);
+
+// stats(clear=False) : (edges, lockout, hits, drop, lost)
+static mp_obj_t mnqdetect_stats(size_t n_args, const mp_obj_t *args) {
+    mp_obj_t t[5] = {
+        mp_obj_new_int_from_uint(g_stat_edges),
+        mp_obj_new_int_from_uint(g_stat_lockout),
+        mp_obj_new_int_from_uint(g_stat_hits),
+        mp_obj_new_int_from_uint(g_stat_drop),
+        mp_obj_new_int_from_uint(g_stat_lost),
+    };
+    if (n_args > 0 && mp_obj_is_true(args[0])) {
+        uint32_t irq_state = save_and_disable_interrupts();
+        stats_clear();
+        restore_interrupts(irq_state);
+    }
+    return mp_obj_new_tuple(5, t);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mnqdetect_stats_obj, 0, 1, mnqdetect_stats);
+
+static const mp_rom_map_elem_t mnqdetect_module_globals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_mnqdetect) },
+    { MP_ROM_QSTR(MP_QSTR_init), MP_ROM_PTR(&mnqdetect_init_obj) },
+    { MP_ROM_QSTR(MP_QSTR_deinit), MP_ROM_PTR(&mnqdetect_deinit_obj) },
+    { MP_ROM_QSTR(MP_QSTR_edge), MP_ROM_PTR(&mnqdetect_edge_obj) },
+    { MP_ROM_QSTR(MP_QSTR_read), MP_ROM_PTR(&mnqdetect_read_obj) },
+    { MP_ROM_QSTR(MP_QSTR_pending), MP_ROM_PTR(&mnqdetect_pending_obj) },
+    { MP_ROM_QSTR(MP_QSTR_stats), MP_ROM_PTR(&mnqdetect_stats_obj) },
+    { MP_ROM_QSTR(MP_QSTR_EVENT_WORDS), MP_ROM_INT(MNQDETECT_EVENT_WORDS) },
+};
+static MP_DEFINE_CONST_DICT(mnqdetect_module_globals, mnqdetect_module_globals_table);
+
+const mp_obj_module_t mnqdetect_user_cmodule = {
+    .base = { &mp_type_module },
+    .globals = (mp_obj_dict_t *)&mnqdetect_module_globals,
+};
+
+MP_REGISTER_MODULE(MP_QSTR_mnqdetect, mnqdetect_user_cmodule);
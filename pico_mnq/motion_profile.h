@@ -0,0 +1,38 @@
+#ifndef MOTION_PROFILE_H
+#define MOTION_PROFILE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+MNQ 모터 motion profile (테이블 방식)
+- 구간: accel(0 → peak) → full(peak 유지) → settle(peak → cruise) → cruise(엔드스탑까지) → brake(cruise → 0)
+- accel/settle/brake는 tools/gen_motion_profile.py가 만든 tick(1ms)별 레벨 테이블
+- 테이블 [k] = 구간 시작 후 k+1 tick 뒤 레벨, 구간 시작 tick(elapsed 0)은 직전 레벨 유지
+- 내려갈 때 / 올라갈 때 profile 따로 사용
+*/
+
+typedef struct {
+    const uint8_t *accel;       // 0 → peak, 마지막 값 = peak
+    uint16_t accel_len;
+    uint16_t full_ticks;        // peak 유지 tick 수
+    const uint8_t *settle;      // peak → cruise, 마지막 값 = cruise
+    uint16_t settle_len;
+    uint8_t cruise;             // 엔드스탑 감지까지 유지 레벨
+    const uint8_t *brake;       // cruise → 0, 마지막 값 = 0
+    uint16_t brake_len;
+} motion_profile_t;
+
+// 구간 테이블에서 elapsed tick의 레벨을 *level에 넣음, 구간이 끝났으면 true
+// elapsed 0 이면 *level은 그대로 (직전 구간의 마지막 레벨)
+static inline bool motion_profile_step(const uint8_t *tab, uint16_t len, uint32_t elapsed, uint16_t *level) {
+    if (elapsed == 0) return false;
+    if (elapsed >= len) {
+        *level = tab[len - 1u];
+        return true;
+    }
+    *level = tab[elapsed - 1u];
+    return false;
+}
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef MOTION_PROFILE_TABLE_H
+#define MOTION_PROFILE_TABLE_H
+
+// 자동 생성 파일: tools/gen_motion_profile.py 로 다시 만들 것 (직접 수정 금지)
+// [k] = 구간 시작 후 k+1 tick(ms) 뒤 PWM 레벨
+
+#include "motion_profile.h"
+
+// ------------ down : 0 → 255 (60 ms, jerk 1.00), 255 유지 800 ms, → 180 (75 ms, jerk 1.00), 브레이크 50 ms (jerk 1.00) ------------
+static const uint8_t mp_down_accel[60] = {
+      0,   1,   1,   2,   4,   5,   7,   9,  11,  14,  17,  20,  24,  28,  32,  36,
+     41,  46,  51,  57,  63,  69,  75,  82,  89,  96, 103, 111, 119, 128, 136, 144,
+    152, 159, 166, 173, 180, 186, 192, 198, 204, 209, 214, 219, 223, 227, 231, 235,
+    238, 241, 244, 246, 248, 250, 251, 253, 254, 254, 255, 255,
+};
+
+static const uint8_t mp_down_settle[75] = {
+    255, 255, 255, 255, 254, 254, 254, 253, 253, 252, 252, 251, 250, 250, 249, 248,
+    247, 246, 245, 244, 243, 242, 241, 240, 238, 237, 236, 234, 233, 231, 229, 228,
+    226, 224, 222, 220, 218, 217, 215, 213, 211, 209, 207, 206, 204, 202, 201, 199,
+    198, 197, 195, 194, 193, 192, 191, 190, 189, 188, 187, 186, 185, 185, 184, 183,
+    183, 182, 182, 181, 181, 181, 180, 180, 180, 180, 180,
+};
+
+static const uint8_t mp_down_brake[50] = {
+    180, 179, 179, 178, 176, 175, 173, 171, 168, 166, 163, 159, 156, 152, 148, 143,
+    138, 133, 128, 122, 117, 110, 104,  97,  90,  83,  76,  70,  63,  58,  52,  47,
+     42,  37,  32,  28,  24,  21,  17,  14,  12,   9,   7,   5,   4,   2,   1,   1,
+      0,   0,
+};
+
+static const motion_profile_t MOTION_PROFILE_DOWN = {
+    .accel = mp_down_accel,   .accel_len = 60,
+    .full_ticks = 800,
+    .settle = mp_down_settle, .settle_len = 75,
+    .cruise = 180,
+    .brake = mp_down_brake,   .brake_len = 50,
+};
+
+// ------------ up : 0 → 255 (60 ms, jerk 1.00), 255 유지 1200 ms, → 180 (75 ms, jerk 1.00), 브레이크 50 ms (jerk 1.00) ------------
+static const uint8_t mp_up_accel[60] = {
+      0,   1,   1,   2,   4,   5,   7,   9,  11,  14,  17,  20,  24,  28,  32,  36,
+     41,  46,  51,  57,  63,  69,  75,  82,  89,  96, 103, 111, 119, 128, 136, 144,
+    152, 159, 166, 173, 180, 186, 192, 198, 204, 209, 214, 219, 223, 227, 231, 235,
+    238, 241, 244, 246, 248, 250, 251, 253, 254, 254, 255, 255,
+};
+
+static const uint8_t mp_up_settle[75] = {
+    255, 255, 255, 255, 254, 254, 254, 253, 253, 252, 252, 251, 250, 250, 249, 248,
+    247, 246, 245, 244, 243, 242, 241, 240, 238, 237, 236, 234, 233, 231, 229, 228,
+    226, 224, 222, 220, 218, 217, 215, 213, 211, 209, 207, 206, 204, 202, 201, 199,
+    198, 197, 195, 194, 193, 192, 191, 190, 189, 188, 187, 186, 185, 185, 184, 183,
+    183, 182, 182, 181, 181, 181, 180, 180, 180, 180, 180,
+};
+
+static const uint8_t mp_up_brake[50] = {
+    180, 179, 179, 178, 176, 175, 173, 171, 168, 166, 163, 159, 156, 152, 148, 143,
+    138, 133, 128, 122, 117, 110, 104,  97,  90,  83,  76,  70,  63,  58,  52,  47,
+     42,  37,  32,  28,  24,  21,  17,  14,  12,   9,   7,   5,   4,   2,   1,   1,
+      0,   0,
+};
+
+static const motion_profile_t MOTION_PROFILE_UP = {
+    .accel = mp_up_accel,   .accel_len = 60,
+    .full_ticks = 1200,
+    .settle = mp_up_settle, .settle_len = 75,
+    .cruise = 180,
+    .brake = mp_up_brake,   .brake_len = 50,
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,278 @@
+#include "param_store.h"
+#include "pico/flash.h"
+#include "hardware/sync.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PARAM_STORE_MAGIC       0x504E514Du     // "MNQP"
+#define SLOT_COUNT              (FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE)
+#define AUX_PAD(n)              (((n) + 3u) & ~3u)
+
+// ------------ slot 형식 ------------
+typedef struct {
+    uint32_t magic;
+    uint32_t layout;
+    uint16_t count;
+    uint16_t aux_len;
+    uint32_t seq;
+} slot_hdr_t;
+
+#define SLOT_HDR_SIZE           ((uint32_t)sizeof(slot_hdr_t))
+#define SLOT_CRC_SIZE           4u
+
+// CRC-32 (0xEDB88320, reflected)
+static uint32_t crc32_update(uint32_t crc, const uint8_t *p, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        crc ^= p[i];
+        for (int k = 0; k < 8; k++) crc = (crc & 1u) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+    }
+    return crc;
+}
+
+// CRC 앞까지 길이
+static uint32_t slot_body_len(const param_store_t *s) {
+    return SLOT_HDR_SIZE + s->n * 4u + AUX_PAD(s->aux_len);
+}
+
+static const uint8_t *slot_ptr(const param_store_t *s, uint i) {
+    return (const uint8_t *)(XIP_BASE + s->flash_offs + i * FLASH_PAGE_SIZE);
+}
+
+static bool slot_valid(const param_store_t *s, uint i, slot_hdr_t *hdr) {
+    const uint8_t *p = slot_ptr(s, i);
+    memcpy(hdr, p, SLOT_HDR_SIZE);
+    if (hdr->magic != PARAM_STORE_MAGIC || hdr->layout != s->layout ||
+        hdr->count != s->n || hdr->aux_len != s->aux_len) return false;
+
+    uint32_t len = slot_body_len(s);
+    uint32_t crc;
+    memcpy(&crc, p + len, SLOT_CRC_SIZE);
+    return crc == ~crc32_update(0xffffffffu, p, len);
+}
+
+static bool slot_blank(const param_store_t *s, uint i) {
+    const uint8_t *p = slot_ptr(s, i);
+    for (uint32_t k = 0; k < FLASH_PAGE_SIZE; k++) {
+        if (p[k] != 0xffu) return false;
+    }
+    return true;
+}
+
+// 저장된 값 (없으면 기본값)
+static uint32_t stored_val(const param_store_t *s, uint k) {
+    if (s->slot < 0) return s->desc[k].def;
+    uint32_t v;
+    memcpy(&v, slot_ptr(s, (uint)s->slot) + SLOT_HDR_SIZE + k * 4u, 4);
+    return v;
+}
+
+void param_store_init(param_store_t *s, uint32_t flash_offs, const param_desc_t *desc, uint32_t *vals, uint n,
+                      void *aux, uint aux_len) {
+    s->flash_offs = flash_offs;
+    s->desc = desc;
+    s->vals = vals;
+    s->n = n;
+    s->aux = aux;
+    s->aux_len = aux ? aux_len : 0;
+    s->ok = slot_body_len(s) + SLOT_CRC_SIZE <= FLASH_PAGE_SIZE;
+    s->slot = -1;
+    s->seq = 0;
+    s->saves = 0;
+    s->erases = 0;
+    s->single_core = false;
+    s->save_req = false;
+    s->cli_active = false;
+    s->cli_len = 0;
+
+    // 이름 목록 (순서 포함)
+    uint32_t layout = 0xffffffffu;
+    for (uint k = 0; k < n; k++) layout = crc32_update(layout, (const uint8_t *)desc[k].name, (uint32_t)strlen(desc[k].name) + 1u);
+    s->layout = ~layout;
+
+    param_store_defaults(s);
+}
+
+void param_store_defaults(param_store_t *s) {
+    for (uint k = 0; k < s->n; k++) s->vals[k] = s->desc[k].def;
+}
+
+bool param_store_load(param_store_t *s) {
+    s->slot = -1;
+    if (!s->ok) return false;
+
+    slot_hdr_t hdr;
+    for (uint i = 0; i < SLOT_COUNT; i++) {
+        if (!slot_valid(s, i, &hdr)) continue;
+        if (s->slot < 0 || (int32_t)(hdr.seq - s->seq) > 0) {
+            s->slot = (int)i;
+            s->seq = hdr.seq;
+        }
+    }
+    if (s->slot < 0) return false;
+
+    for (uint k = 0; k < s->n; k++) {
+        uint32_t v = stored_val(s, k);
+        const param_desc_t *d = &s->desc[k];
+        s->vals[k] = (v >= d->min && v <= d->max) ? v : d->def;
+    }
+    if (s->aux_len) memcpy(s->aux, slot_ptr(s, (uint)s->slot) + SLOT_HDR_SIZE + s->n * 4u, s->aux_len);
+    return true;
+}
+
+// ------------ flash 기록 ------------
+typedef struct {
+    uint32_t sector;
+    uint32_t offs;
+    bool erase;
+    const uint8_t *page;
+} slot_write_t;
+
+// flash_safe_execute 안에서 실행 (다른 core 정지, 인터럽트 비활성), single_core면 인터럽트만 끄고
+static void slot_write(void *param) {
+    const slot_write_t *w = (const slot_write_t *)param;
+    if (w->erase) flash_range_erase(w->sector, FLASH_SECTOR_SIZE);
+    flash_range_program(w->offs, w->page, FLASH_PAGE_SIZE);
+}
+
+bool param_store_save(param_store_t *s, bool with_vals) {
+    if (!s->ok) return false;
+
+    static uint8_t page[FLASH_PAGE_SIZE];
+    memset(page, 0xff, sizeof(page));
+
+    slot_hdr_t hdr = {
+        .magic = PARAM_STORE_MAGIC,
+        .layout = s->layout,
+        .count = (uint16_t)s->n,
+        .aux_len = (uint16_t)s->aux_len,
+        .seq = s->slot >= 0 ? s->seq + 1u : 1u,
+    };
+    memcpy(page, &hdr, SLOT_HDR_SIZE);
+    for (uint k = 0; k < s->n; k++) {
+        uint32_t v = with_vals ? s->vals[k] : stored_val(s, k);
+        memcpy(&page[SLOT_HDR_SIZE + k * 4u], &v, 4);
+    }
+    if (s->aux_len) {
+        uint8_t *a = &page[SLOT_HDR_SIZE + s->n * 4u];
+        memcpy(a, s->aux, s->aux_len);
+        memset(a + s->aux_len, 0, AUX_PAD(s->aux_len) - s->aux_len);
+    }
+    uint32_t len = slot_body_len(s);
+    uint32_t crc = ~crc32_update(0xffffffffu, page, len);
+    memcpy(&page[len], &crc, SLOT_CRC_SIZE);
+
+    // 값/aux가 지금 슬롯과 같으면 (seq 빼고) 기록 안 함
+    if (s->slot >= 0 && memcmp(&page[SLOT_HDR_SIZE], slot_ptr(s, (uint)s->slot) + SLOT_HDR_SIZE, len - SLOT_HDR_SIZE) == 0) {
+        return true;
+    }
+
+    // 지금 슬롯 뒤의 빈 슬롯 (기록 중 끊긴 슬롯 / 다른 형식 record는 건너뜀), 없으면 sector erase
+    slot_write_t w = { .sector = s->flash_offs, .erase = true, .page = page };
+    uint next = 0;
+    for (uint i = (uint)(s->slot + 1); i < SLOT_COUNT; i++) {
+        if (slot_blank(s, i)) {
+            next = i;
+            w.erase = false;
+            break;
+        }
+    }
+    w.offs = s->flash_offs + next * FLASH_PAGE_SIZE;
+
+    if (s->single_core) {
+        uint32_t irq_state = save_and_disable_interrupts();
+        slot_write(&w);
+        restore_interrupts(irq_state);
+    } else if (flash_safe_execute(slot_write, &w, 100) != PICO_OK) {
+        return false;
+    }
+
+    slot_hdr_t check;
+    if (!slot_valid(s, next, &check) || check.seq != hdr.seq) {
+        if (w.erase) s->slot = -1;     // 앞 슬롯도 지워짐
+        return false;
+    }
+    s->slot = (int)next;
+    s->seq = hdr.seq;
+    s->saves++;
+    if (w.erase) s->erases++;
+    return true;
+}
+
+// ------------ stdio ------------
+void param_store_print(const param_store_t *s) {
+    if (s->slot >= 0) {
+        printf("param: flash slot %d seq %lu, saves %lu erases %lu (* = unsaved)\n", s->slot,
+               (unsigned long)s->seq, (unsigned long)s->saves, (unsigned long)s->erases);
+    } else {
+        printf("param: flash empty, defaults (* = unsaved)\n");
+    }
+    for (uint k = 0; k < s->n; k++) {
+        const param_desc_t *d = &s->desc[k];
+        printf("  %-18s = %lu%s [%lu..%lu] default %lu\n", d->name, (unsigned long)s->vals[k],
+               s->vals[k] != stored_val(s, k) ? "*" : "",
+               (unsigned long)d->min, (unsigned long)d->max, (unsigned long)d->def);
+    }
+}
+
+static void cli_exec(param_store_t *s, char *line) {
+    char *name = line;
+    while (*name == ' ') name++;
+    char *arg = name;
+    while (*arg && *arg != ' ') arg++;
+    if (*arg) *arg++ = '\0';
+    while (*arg == ' ') arg++;
+
+    if (*name == '\0') {
+        param_store_print(s);
+    } else if (!strcmp(name, "save")) {
+        s->save_req = true;
+    } else if (!strcmp(name, "default")) {
+        param_store_defaults(s);
+        printf("param: defaults (not saved)\n");
+    } else {
+        for (uint k = 0; k < s->n; k++) {
+            const param_desc_t *d = &s->desc[k];
+            if (strcmp(name, d->name)) continue;
+
+            char *end;
+            unsigned long v = strtoul(arg, &end, 0);
+            if (end == arg || v < d->min || v > d->max) {
+                printf("param: %s needs %lu..%lu\n", d->name, (unsigned long)d->min, (unsigned long)d->max);
+            } else {
+                s->vals[k] = (uint32_t)v;
+                printf("param: %s = %lu\n", d->name, v);
+            }
+            return;
+        }
+        printf("param: unknown '%s'\n", name);
+    }
+}
+
+bool param_store_cli(param_store_t *s, int c) {
+    if (c < 0) return false;
+    if (!s->cli_active) {
+        if (c != 'p') return false;
+        s->cli_active = true;
+        s->cli_len = 0;
+        return true;
+    }
+    if (c == '\r' || c == '\n' || c == ';') {
+        s->cli_line[s->cli_len] = '\0';
+        s->cli_active = false;
+        cli_exec(s, s->cli_line);
+    } else if (s->cli_len < sizeof(s->cli_line) - 1u) {
+        s->cli_line[s->cli_len++] = (char)c;
+    }
+    return true;
+}
+
+void param_store_service(param_store_t *s) {
+    if (!s->save_req) return;
+    s->save_req = false;
+    if (param_store_save(s, true)) {
+        printf("param: saved slot %d seq %lu, erases %lu\n", s->slot, (unsigned long)s->seq, (unsigned long)s->erases);
+    } else {
+        printf("param: save failed\n");
+    }
+}
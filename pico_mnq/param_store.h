@@ -0,0 +1,89 @@
+#ifndef PARAM_STORE_H
+#define PARAM_STORE_H
+
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+
+/*
+flash 파라미터 블록 (다시 빌드하지 않고 stdio로 조정하는 타이밍 값)
+- 값은 모두 uint32_t, 펌웨어가 X-macro 표 하나로 RAM struct(PARAM_FIELD)와 설명 표(PARAM_DESC)를 같은 순서로 만듦
+  hot path는 RAM struct를 바로 읽음 (부팅 시 1회 flash → RAM, 조회/분기 없음)
+- flash sector 1개를 page(256 byte) 슬롯 16개로 나눠 저장할 때마다 다음 빈 슬롯에 기록, 다 차면 sector erase 후 처음부터
+  → erase는 저장 16번에 1번, 읽을 때는 CRC 맞는 슬롯 중 seq가 가장 큰 것 (기록 중 전원이 꺼져도 앞 슬롯이 남음)
+- 슬롯 = {magic, layout, count, aux_len, seq} + 값 + aux + CRC-32
+  layout = 파라미터 이름 목록 CRC → 표가 바뀐 펌웨어는 예전 블록을 무시하고 기본값 (값 의미가 엇갈리지 않게)
+  aux = 같이 저장하는 비편집 데이터 (학습값 등), 불러온 값이 범위를 벗어나면 그 값만 기본값
+- stdio 명령 (param_store_cli) : 'p'로 시작하는 한 줄 (\r, \n, ; 로 끝)
+    p               전체 출력 (이름 = 값 [min..max] 기본값, * = 저장값과 다름)
+    p <이름> <값>   RAM 값 변경 (바로 적용, 저장은 따로)
+    p save          flash 저장 요청 (실제 기록은 펌웨어가 안전한 때 param_store_service)
+    p default       전부 기본값 (RAM)
+- flash 기록은 flash_safe_execute 안에서 (다른 core 정지, 인터럽트 비활성 : page 기록 ~1ms, erase 포함 ~50ms)
+  single_core = true면 save_and_disable_interrupts 안에서 flash_range_* 직접 (core1을 안 띄우는 펌웨어 :
+  다른 core가 lockout victim이 아니면 flash_safe_execute가 PICO_ERROR_NOT_PERMITTED)
+*/
+
+// 펌웨어 기본 위치 : flash 마지막 sector
+#define PARAM_STORE_FLASH_OFFSET    (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
+
+// X-macro 표 항목 X(name, default, min, max) 용
+#define PARAM_FIELD(name, def, min, max)    uint32_t name;
+#define PARAM_DESC(name, def, min, max)     { #name, (def), (min), (max) },
+#define PARAM_ONE(name, def, min, max)      + 1
+
+typedef struct {
+    const char *name;
+    uint32_t def;
+    uint32_t min;
+    uint32_t max;
+} param_desc_t;
+
+typedef struct {
+    // 설정 (param_store_init)
+    uint32_t flash_offs;            // sector 시작 (FLASH_SECTOR_SIZE 정렬)
+    const param_desc_t *desc;
+    uint32_t *vals;                 // RAM 값 (desc와 같은 순서)
+    uint n;
+    void *aux;                      // NULL이면 없음
+    uint aux_len;
+    uint32_t layout;
+    bool ok;                        // 슬롯 1개에 다 들어감
+    bool single_core;               // core1 안 씀 → flash_safe_execute 대신 인터럽트만 끄고 기록 (init 뒤 설정)
+
+    // flash 상태
+    int slot;                       // 마지막으로 읽은/쓴 슬롯, -1이면 저장된 블록 없음
+    uint32_t seq;
+    uint32_t saves;
+    uint32_t erases;
+    bool save_req;                  // p save
+
+    // stdio 한 줄
+    bool cli_active;
+    uint8_t cli_len;
+    char cli_line[40];
+} param_store_t;
+
+// RAM 값은 기본값으로, aux는 그대로 (호출 쪽 기본값)
+void param_store_init(param_store_t *s, uint32_t flash_offs, const param_desc_t *desc, uint32_t *vals, uint n,
+                      void *aux, uint aux_len);
+
+// 가장 최근 슬롯을 RAM 값/aux로 읽음, 없으면 false (RAM 값은 기본값 그대로)
+bool param_store_load(param_store_t *s);
+
+// 다음 빈 슬롯에 기록 (모두 찼으면 erase 후 0번), 지금 슬롯과 내용이 같으면 기록 안 함
+// with_vals : false면 값은 저장된 값(없으면 기본값) 그대로 두고 aux만 갱신 (p save 전 RAM 변경은 저장 안 함)
+bool param_store_save(param_store_t *s, bool with_vals);
+
+void param_store_defaults(param_store_t *s);
+void param_store_print(const param_store_t *s);
+
+// stdio 문자 1개, 'p' 줄에 쓰였으면 true (다른 명령으로 처리하지 말 것), c < 0 은 무시
+bool param_store_cli(param_store_t *s, int c);
+
+// p save 요청이 있으면 저장 후 결과 출력 (펌웨어가 flash 기록해도 되는 때 호출)
+static inline bool param_store_save_pending(const param_store_t *s) {
+    return s->save_req;
+}
+void param_store_service(param_store_t *s);
+
+#endif
@@ -0,0 +1,155 @@
+#include "pwm_ramp.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/pwm.h"
+#include "hardware/structs/pwm.h"
+#include <stdio.h>
+
+// 버퍼 : 앞에 지금 레벨 (sub - 1)개 + 테이블 값마다 sub개
+#define PWM_RAMP_BUF_WORDS      (PWM_RAMP_SUB_MAX - 1u + PWM_RAMP_MAX_STEPS * PWM_RAMP_SUB_MAX)
+
+// ------------ output state ------------
+typedef struct {
+    uint gpio;
+    uint ch;                            // DMA 채널
+    uint shift;                         // CC 안 채널 위치 (A = 0, B = 16)
+    void *arg;
+    volatile uint32_t *cc;
+    uint32_t buf[PWM_RAMP_BUF_WORDS];
+
+    volatile uint32_t play;             // 통계 : 재생 시작
+    volatile uint32_t done;             // 통계 : 끝까지 재생
+    volatile uint32_t stopped;          // 통계 : 재생 중 중지
+} ramp_out_t;
+
+static ramp_out_t g_out[PWM_RAMP_MAX_OUTPUTS];
+static uint g_out_count = 0;
+static int g_timer = -1;
+static uint32_t g_step_us = 0;
+static uint32_t g_sub = 1;
+static pwm_ramp_done_t g_done = NULL;
+
+// 완료 IRQ (DMA_IRQ_1) : 끝난 채널마다 bit 지우고 콜백
+static void pwm_ramp_irq(void) {
+    for (uint i = 0; i < g_out_count; i++) {
+        ramp_out_t *o = &g_out[i];
+        if (!dma_channel_get_irq1_status(o->ch)) continue;
+        dma_channel_acknowledge_irq1(o->ch);
+        o->done++;
+        if (g_done) g_done(i, o->arg);
+    }
+}
+
+bool pwm_ramp_init(uint32_t step_us, pwm_ramp_done_t done) {
+    uint32_t clk_hz = clock_get_hz(clk_sys);
+    if (step_us == 0) return false;
+
+    // step 주기 (clk_sys 클럭 수) = sub × div, div는 16bit
+    uint64_t step_clk = (uint64_t)clk_hz * step_us / 1000000u;
+    uint32_t sub = 1;
+    while (sub <= PWM_RAMP_SUB_MAX && step_clk / sub > 0xffffu) sub++;
+    if (sub > PWM_RAMP_SUB_MAX) return false;
+    uint32_t div = (uint32_t)((step_clk + sub / 2u) / sub);
+    if (div < 1u) return false;
+
+    g_timer = dma_claim_unused_timer(false);
+    if (g_timer < 0) return false;
+    dma_timer_set_fraction((uint)g_timer, 1u, (uint16_t)div);
+
+    g_step_us = step_us;
+    g_sub = sub;
+    g_done = done;
+    g_out_count = 0;
+
+    irq_set_exclusive_handler(DMA_IRQ_1, pwm_ramp_irq);
+    irq_set_enabled(DMA_IRQ_1, true);
+    return true;
+}
+
+int pwm_ramp_add(uint gpio, void *arg) {
+    if (g_timer < 0 || g_out_count >= PWM_RAMP_MAX_OUTPUTS) return -1;
+    int ch = dma_claim_unused_channel(false);
+    if (ch < 0) return -1;
+
+    ramp_out_t *o = &g_out[g_out_count];
+    o->gpio = gpio;
+    o->ch = (uint)ch;
+    o->shift = pwm_gpio_to_channel(gpio) == PWM_CHAN_B ? PWM_CH0_CC_B_LSB : 0u;
+    o->arg = arg;
+    o->cc = &pwm_hw->slice[pwm_gpio_to_slice_num(gpio)].cc;
+    o->play = o->done = o->stopped = 0;
+
+    // 버퍼 → CC 고정 주소, timer tick마다 1 word
+    dma_channel_config c = dma_channel_get_default_config(o->ch);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, dma_get_timer_dreq((uint)g_timer));
+    dma_channel_configure(o->ch, &c, o->cc, o->buf, 0, false);
+    dma_channel_set_irq1_enabled(o->ch, true);
+
+    return (int)g_out_count++;
+}
+
+bool pwm_ramp_play(uint out, const uint8_t *tab, uint16_t len) {
+    if (out >= g_out_count || len == 0 || len > PWM_RAMP_MAX_STEPS) return false;
+    ramp_out_t *o = &g_out[out];
+
+    pwm_ramp_stop(out);
+
+    // 첫 전송은 시작 후 첫 timer tick (0 ~ 1 sub 뒤) → 지금 레벨로 (sub - 1)칸 채워서 tab[0]이 1 step 째에 나가게
+    uint32_t n = 0;
+    uint32_t now = (*o->cc >> o->shift) & 0xffffu;
+    for (uint32_t s = 1; s < g_sub; s++) o->buf[n++] = now << o->shift;
+    for (uint32_t k = 0; k < len; k++) {
+        uint32_t w = (uint32_t)tab[k] << o->shift;
+        for (uint32_t s = 0; s < g_sub; s++) o->buf[n++] = w;
+    }
+
+    o->play++;
+    dma_channel_transfer_from_buffer_now(o->ch, o->buf, n);
+    return true;
+}
+
+// abort 도중 완료 IRQ가 뜰 수 있음 → 채널 IRQ를 잠깐 끄고 abort, 남은 bit 지움
+void pwm_ramp_stop(uint out) {
+    if (out >= g_out_count) return;
+    ramp_out_t *o = &g_out[out];
+
+    if (dma_channel_is_busy(o->ch)) o->stopped++;
+    dma_channel_set_irq1_enabled(o->ch, false);
+    dma_channel_abort(o->ch);
+    dma_channel_acknowledge_irq1(o->ch);
+    dma_channel_set_irq1_enabled(o->ch, true);
+}
+
+bool pwm_ramp_busy(uint out) {
+    return out < g_out_count && dma_channel_is_busy(g_out[out].ch);
+}
+
+uint16_t pwm_ramp_level(uint out) {
+    if (out >= g_out_count) return 0;
+    return (uint16_t)(*g_out[out].cc >> g_out[out].shift);
+}
+
+void pwm_ramp_reset(void) {
+    for (uint i = 0; i < g_out_count; i++) {
+        g_out[i].play = 0;
+        g_out[i].done = 0;
+        g_out[i].stopped = 0;
+    }
+}
+
+void pwm_ramp_dump(void) {
+    if (g_timer < 0) {
+        printf("pwm ramp: off\n");
+        return;
+    }
+    printf("pwm ramp: step=%luus sub=%lu\n", (unsigned long)g_step_us, (unsigned long)g_sub);
+    for (uint i = 0; i < g_out_count; i++) {
+        const ramp_out_t *o = &g_out[i];
+        printf("  gpio %u: play=%lu done=%lu stopped=%lu\n", o->gpio,
+               (unsigned long)o->play, (unsigned long)o->done, (unsigned long)o->stopped);
+    }
+}
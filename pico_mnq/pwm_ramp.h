@@ -0,0 +1,50 @@
+#ifndef PWM_RAMP_H
+#define PWM_RAMP_H
+
+#include "pico/stdlib.h"
+
+/*
+PWM 레벨 테이블 DMA 재생 (모터 ramp : motion profile accel / settle / brake 테이블)
+- 출력(PWM 핀)마다 DMA 채널 1개가 RAM 버퍼를 slice CC 레지스터로 씀, 모든 출력이 DMA timer 1개를 같이 사용
+- step 간격은 clk_sys 분주라 정확 : 재생 중에는 CPU가 아무것도 안 하므로 tick IRQ 지연/overrun과 무관하게 ramp 모양 일정
+- DMA timer 분주(Y)는 16bit → 125 MHz에서 1 kHz를 바로 못 만듦, step을 sub개로 나눠 같은 레벨을 sub번 씀
+- 재생이 끝나면 DMA_IRQ_1 → 완료 콜백 (pwm_ramp_init을 부른 core에서 실행)
+- CC 레지스터를 32bit로 씀 → 같은 slice의 다른 채널 레벨은 0 (그 채널 핀은 PWM 출력으로 쓰지 말 것)
+*/
+
+#define PWM_RAMP_MAX_OUTPUTS    3u
+
+// 테이블 최대 길이 (step), 넘으면 pwm_ramp_play가 false → 호출 쪽에서 직접 재생
+#ifndef PWM_RAMP_MAX_STEPS
+#define PWM_RAMP_MAX_STEPS      128u
+#endif
+
+// step 분할 최대 : clk_sys / (step Hz × sub) <= 65535 인 가장 작은 sub (125 MHz, 1 ms → 2)
+#define PWM_RAMP_SUB_MAX        4u
+
+typedef void (*pwm_ramp_done_t)(uint out, void *arg);
+
+// step_us 간격으로 준비, done = 재생 완료 콜백 (DMA IRQ context)
+// DMA timer가 없거나 SUB_MAX로도 분주가 16bit를 넘으면 false
+bool pwm_ramp_init(uint32_t step_us, pwm_ramp_done_t done);
+
+// PWM 핀 등록 (핀 function / slice 설정은 호출 쪽), 반환 = 출력 번호, DMA 채널이 없으면 -1
+int pwm_ramp_add(uint gpio, void *arg);
+
+// tab[0..len) 재생 : tab[k]는 시작 후 k+1 step 째 (마지막 1/sub step 안에서 바뀜, motion_profile_step과 같은 시간 기준)
+// 마지막 값을 쓰면 완료 콜백. 재생 중이면 멈추고 새로 시작
+// len이 0이거나 PWM_RAMP_MAX_STEPS를 넘으면 false (출력은 그대로)
+bool pwm_ramp_play(uint out, const uint8_t *tab, uint16_t len);
+
+// 재생 중지 (완료 콜백 없음, 이미 떠 있던 완료 IRQ도 지움), 출력은 지금 레벨 유지
+void pwm_ramp_stop(uint out);
+
+bool pwm_ramp_busy(uint out);
+
+// 지금 출력 레벨 (CC 레지스터)
+uint16_t pwm_ramp_level(uint out);
+
+void pwm_ramp_reset(void);
+void pwm_ramp_dump(void);
+
+#endif
@@ -0,0 +1,242 @@
+#ifndef SAMPLE_DECODE_H
+#define SAMPLE_DECODE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+P1/P2 판정 block decoder : 일정 간격으로 찍은 GPIO 입력 word(SIO gpio_in) 배열을 한 번에 판정
+- detect_engine.h의 P1P2 판정(IRQ + alarm)과 같은 순서, 시각 대신 샘플 번호 (시작부터 0, 1, ...)
+  P1 엣지 = P1 bit가 직전 샘플과 달라진 첫 샘플, 확인/P2 샘플은 예약 번호의 샘플을 바로 읽음
+- 엣지 대기(P1 상승/하강, 락아웃)만 샘플을 하나씩 보고, 확인/P2 단계는 예약 번호로 건너뜀
+- block 경계와 무관 : 같은 샘플열이면 어떻게 나눠 넣어도 같은 결과 (상태는 모두 sdec_t 안)
+- pico-sdk 의존 없음 → host 도구에서 합성/캡처 버퍼로 그대로 검증 (host/bench_sample_decode.c)
+(header only)
+*/
+
+typedef struct {
+    uint32_t p1_mask;           // P1 입력 bit (1 << DETECT_1)
+    uint32_t p2_mask;
+    bool     edge;              // true = P1 상승엣지에서 시작 (P1P2_EDGE), false = P1 HIGH면 시작 (P1P2_LEVEL)
+    uint32_t confirm_n;         // P1 확인 샘플 수 (1 이상)
+    uint32_t confirm_step;      // P1 확인 간격 (샘플, 1 이상)
+    uint32_t p2_n;              // P2 확인 샘플 수 (1 이상)
+    uint32_t p2_step;           // P2 확인 간격 (샘플, 1 이상)
+    uint32_t delay;             // P1 하강 → 첫 P2 샘플 (샘플, 0 = 하강 샘플에서 바로)
+    uint32_t lockout;           // 첫 P2 샘플부터 락아웃 (샘플, 0 = 없음)
+} sdec_cfg_t;
+
+typedef struct {
+    uint64_t edge_idx;          // 판정을 시작한 P1 샘플
+    uint64_t idx;               // 판정이 정해진 샘플 (몸통 = P2 첫 LOW, 헤드 = 마지막 HIGH)
+    bool     head;
+} sdec_hit_t;
+
+typedef enum {
+    SDEC_WAIT_P1_RISE = 0,
+    SDEC_CONFIRM_P1,
+    SDEC_WAIT_P1_FALL,
+    SDEC_DELAY_BEFORE_P2,
+    SDEC_CHECK_P2,
+    SDEC_LOCKOUT
+} sdec_state_t;
+
+typedef struct {
+    sdec_cfg_t   cfg;           // 판정 사이에 바꿔도 됨 (다음 예약부터 적용)
+    sdec_state_t state;
+    uint64_t     pos;           // 다음에 들어올 샘플 번호
+    uint64_t     next;          // 예약 샘플 번호 (확인 / P2 / 락아웃 끝)
+    uint64_t     edge_idx;
+    uint64_t     p2_start;      // 첫 P2 샘플 (락아웃 기준)
+    uint32_t     n;             // 지금 단계의 샘플 수
+    bool         p1_prev;       // 직전 샘플의 P1 (엣지 대기용)
+    bool         lockout_head;  // 락아웃을 건 판정
+    uint32_t     lockout_rises; // 락아웃 중 버린 P1 상승 (누적)
+} sdec_t;
+
+static inline bool sdec_p1(const sdec_t *d, uint32_t v) {
+    return (v & d->cfg.p1_mask) != 0;
+}
+
+// 엣지 대기 시작 : LEVEL은 LOW였던 것으로 (첫 샘플이 HIGH면 바로 시작), EDGE는 HIGH였던 것으로 (새 상승엣지 필요)
+static inline void sdec_reset(sdec_t *d, uint64_t pos) {
+    d->state = SDEC_WAIT_P1_RISE;
+    d->pos = pos;
+    d->p1_prev = d->cfg.edge;
+}
+
+static inline void sdec_init(sdec_t *d, const sdec_cfg_t *cfg, uint64_t pos) {
+    d->cfg = *cfg;
+    d->lockout_rises = 0;
+    d->lockout_head = false;
+    sdec_reset(d, pos);
+}
+
+// 예약 샘플 번호, 엣지 대기 중이면 UINT64_MAX (main이 판정 샘플 직후 깨어나는 데 씀)
+static inline uint64_t sdec_next(const sdec_t *d) {
+    switch (d->state) {
+    case SDEC_CONFIRM_P1:
+    case SDEC_DELAY_BEFORE_P2:
+    case SDEC_CHECK_P2:
+    case SDEC_LOCKOUT:
+        return d->next;
+    default:
+        return UINT64_MAX;
+    }
+}
+
+// ------------ 단계 (x = 지금 샘플 번호, v = 그 샘플) ------------
+// 판정이 나오면 *hit에 쓰고 true
+static inline bool sdec_confirm_start(sdec_t *d, uint64_t x, uint32_t v, sdec_hit_t *hit);
+
+// P1 상승 대기 (LEVEL은 P1이 이미 HIGH면 바로 확인 시작)
+static inline bool sdec_wait_rise(sdec_t *d, uint64_t x, uint32_t v, sdec_hit_t *hit) {
+    d->state = SDEC_WAIT_P1_RISE;
+    d->p1_prev = sdec_p1(d, v);
+    if (!d->cfg.edge && d->p1_prev) return sdec_confirm_start(d, x, v, hit);
+    return false;
+}
+
+// 판정 확정 : 결과, 락아웃
+static inline bool sdec_decide(sdec_t *d, bool head, uint64_t x, uint32_t v, sdec_hit_t *hit) {
+    hit->edge_idx = d->edge_idx;
+    hit->idx = x;
+    hit->head = head;
+
+    if (d->cfg.lockout > 0) {
+        uint64_t until = d->p2_start + d->cfg.lockout;
+        d->lockout_head = head;
+        if (until > x) {
+            d->state = SDEC_LOCKOUT;
+            d->next = until;
+            d->p1_prev = sdec_p1(d, v);
+            return true;
+        }
+    }
+    sdec_wait_rise(d, x, v, hit);       // confirm_n >= 1 이라 여기서 다시 판정이 나오지 않음
+    return true;
+}
+
+// P2 확인 : p2_n회 모두 HIGH면 헤드샷, LOW가 나오면 바로 몸통샷
+static inline bool sdec_p2_sample(sdec_t *d, uint64_t x, uint32_t v, sdec_hit_t *hit) {
+    if (d->n == 0) d->p2_start = x;
+    bool p2 = (v & d->cfg.p2_mask) != 0;
+    if (p2 && ++d->n < d->cfg.p2_n) {
+        d->next = x + d->cfg.p2_step;
+        return false;
+    }
+    return sdec_decide(d, p2, x, v, hit);
+}
+
+// P1 하강 (확정 뒤) → delay 샘플 뒤 P2 확인
+static inline bool sdec_p1_fall(sdec_t *d, uint64_t x, uint32_t v, sdec_hit_t *hit) {
+    d->n = 0;
+    if (d->cfg.delay == 0) {
+        d->state = SDEC_CHECK_P2;
+        return sdec_p2_sample(d, x, v, hit);
+    }
+    d->state = SDEC_DELAY_BEFORE_P2;
+    d->next = x + d->cfg.delay;
+    return false;
+}
+
+// P1 확인 샘플 : confirm_step 간격 confirm_n회 연속 HIGH면 확정
+static inline bool sdec_confirm_sample(sdec_t *d, uint64_t x, uint32_t v, sdec_hit_t *hit) {
+    bool p1 = sdec_p1(d, v);
+    if (d->n >= d->cfg.confirm_n) {
+        // 확정 → P1 LOW 기다림 (이미 LOW면 바로)
+        d->state = SDEC_WAIT_P1_FALL;
+        d->p1_prev = p1;
+        return p1 ? false : sdec_p1_fall(d, x, v, hit);
+    }
+    if (!p1) return sdec_wait_rise(d, x, v, hit);
+    d->n++;
+    d->next = x + d->cfg.confirm_step;
+    return false;
+}
+
+static inline bool sdec_confirm_start(sdec_t *d, uint64_t x, uint32_t v, sdec_hit_t *hit) {
+    d->edge_idx = x;
+    d->n = 0;
+    d->state = SDEC_CONFIRM_P1;
+    return sdec_confirm_sample(d, x, v, hit);
+}
+
+// ------------ block 입력 ------------
+// 샘플 s[0..n) (번호 d->pos부터 연속)을 판정, 결과를 out에 최대 max개 쓰고 개수 반환
+// out이 차면 거기서 멈춤 → 소비한 샘플 수 = d->pos 증가분, 나머지는 다시 넣을 것
+static inline uint32_t sdec_feed(sdec_t *d, const uint32_t *s, uint32_t n, sdec_hit_t *out, uint32_t max) {
+    const uint64_t base = d->pos;
+    uint32_t i = 0;
+    uint32_t hits = 0;
+
+    while (i < n && hits < max) {
+        sdec_hit_t *hit = &out[hits];
+        bool prev = d->p1_prev;
+
+        switch (d->state) {
+        case SDEC_WAIT_P1_RISE:
+            // P1 LOW → HIGH 첫 샘플
+            for (; i < n; i++) {
+                bool p1 = sdec_p1(d, s[i]);
+                if (p1 && !prev) break;
+                prev = p1;
+            }
+            d->p1_prev = prev;
+            if (i == n) break;
+            if (sdec_confirm_start(d, base + i, s[i], hit)) hits++;
+            i++;
+            break;
+
+        case SDEC_WAIT_P1_FALL:
+            while (i < n && sdec_p1(d, s[i])) i++;
+            if (i == n) {
+                d->p1_prev = true;
+                break;
+            }
+            if (sdec_p1_fall(d, base + i, s[i], hit)) hits++;
+            i++;
+            break;
+
+        case SDEC_LOCKOUT: {
+            // 끝 샘플까지 P1 상승은 버린 것으로 셈, 끝 샘플에서 다시 대기
+            uint64_t end = d->next - base;
+            uint32_t stop = end < n ? (uint32_t)end + 1u : n;
+            for (; i < stop; i++) {
+                bool p1 = sdec_p1(d, s[i]);
+                if (p1 && !prev) d->lockout_rises++;
+                prev = p1;
+            }
+            d->p1_prev = prev;
+            if (end >= n) break;
+            if (sdec_wait_rise(d, d->next, s[end], hit)) hits++;
+            break;
+        }
+
+        default: {
+            // 예약 샘플로 건너뜀
+            uint64_t at = d->next - base;
+            if (at >= n) {
+                i = n;
+                break;
+            }
+            i = (uint32_t)at;
+            bool hit_now;
+            if (d->state == SDEC_CONFIRM_P1) {
+                hit_now = sdec_confirm_sample(d, d->next, s[i], hit);
+            } else {
+                d->state = SDEC_CHECK_P2;
+                hit_now = sdec_p2_sample(d, d->next, s[i], hit);
+            }
+            if (hit_now) hits++;
+            i++;
+            break;
+        }
+        }
+    }
+
+    d->pos = base + i;
+    return hits;
+}
+
+#endif
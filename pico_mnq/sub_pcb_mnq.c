@@ -2,12 +2,27 @@
 #include "hardware/clocks.h"
 #include "hardware/pwm.h"
 #include "hardware/gpio.h"
+#include "pico/multicore.h"
+#include "pico/util/queue.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
 #include <stdio.h>
 #define _USE_MATH_DEFINES
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "adc_sampler.h"
+#include "current_sense.h"
+#include "edge_ring.h"
+#include "gpio_trace.h"
+#include "irq_guard.h"
+#include "param_store.h"
+#include "pwm_ramp.h"
+#include "vcount.h"
+#include "motion_profile_table.h"
+
 // ------------ pin set ------------
+// 아래 DETECT/MNQ/LIMIT 핀은 target 0, 나머지 target은 g_mnq_pins 표
 
 // input
 #define DETECT_1        3   // body
@@ -36,34 +51,176 @@
 #define MNQ_PWM_FREQ_HZ     16000u  // PWM 16kHz
 #define PWM_MAX_LEVEL      255u
 
-// 0→255 : 1ms에 5씩 증가 → 약 51ms
-#define PWM_RAMP_UP_STEP    5u          // per 1 ms
-
-// 255→150 : 1ms에 1씩 감소 → 105ms
-#define PWM_RAMP_DOWN_STEP  1u          // per 1 ms (toward 150)
-
-// 150→0 : 1ms에 3씩 감소 → 약 50ms
-#define PWM_BRAKE_STEP      3u          // per 1 ms
-
-#define PWM_LOW_LEVEL    150u        // 150/255 move
-
-// 풀파워 유지 시간 (1000ms = 1s)
-#define FULL_POWER_MS_DOWN  800u    // 내려가기 까지 약 1.2초 소요
-#define FULL_POWER_MS_UP    1200u    // 올라가기 까지 약 1.7초 소요
+// ramp / 풀파워 유지 / cruise 레벨 / 브레이크는 motion profile 테이블로 (내려갈 때, 올라갈 때 따로)
+// 값 변경은 tools/gen_motion_profile.py 수정 후 motion_profile_table.h 재생성
 
-// 내려갔을 때 3초 대기, 올라온 뒤 1초 대기
+// 내려갔을 때 3초 대기, 올라온 뒤 1초 대기 (기본값, 실제 값은 파라미터 hold_down_ms / hold_up_ms)
 #define HOLD_DOWN_MS        3000u
 #define HOLD_UP_MS          1000u
 
-// ------------ interrupt flag ------------
-static volatile bool detect1_rise = false;
-static volatile bool detect2_rise = false;
-static volatile bool detect3_rise = false;
-
-// ------------ body counut (DETECT_1 or DETECT_3) ------------
-static int body_shot_count = 0;
-
-// ------------ MNQ state / motor state ------------
+// 탄 감지 상승엣지 IRQ 뒤 그 핀 IRQ를 끄는 시간 (모터 EMI / 센서 채터링 폭주 방지, 0이면 guard 없음)
+// 같은 핀의 실제 탄 간격(몸통샷 2회 등)보다 충분히 짧게
+#ifndef DETECT_IRQ_HOLDOFF_US
+#define DETECT_IRQ_HOLDOFF_US   2000u
+#endif
+
+// ------------ motor control tick (core1, hardware alarm) ------------
+// 명령 / 엔드스탑 / watchdog / 풀파워·cruise 구간은 tick(1ms) 단위
+// ramp 구간(accel/settle/brake) 레벨은 DMA가 1 step = 1 tick 간격으로 재생 (pwm_ramp.c) → tick이 늦어도 ramp 모양 일정
+// (DMA 채널/timer가 없으면 예전처럼 tick마다 테이블 값 하나)
+#define MOTOR_TICK_US           1000u
+#define MOTOR_TICK_LATE_US      100u    // 예정 시각보다 이만큼 늦게 시작하면 deadline overrun
+
+// ------------ 엔드스탑 IRQ (core1) ------------
+// 리밋 스위치 하강엣지(눌림) IRQ → 그 핀 IRQ를 끄고 CONFIRM_US 뒤 alarm에서 아직 LOW면 눌림 확정
+// → 디바운스 상태를 바로 눌림으로 바꾸고 가는 방향 엔드스탑이면 바로 브레이크 (tick 2회 디바운스를 기다리지 않음)
+// 확인 때 HIGH면 잡음/채터링으로 버림 (glitch), 어느 쪽이든 IRQ 다시 켬. 놓임은 tick 디바운스가 처리
+// IRQ를 놓쳐도 (trace 기록 중 core0가 같은 엣지 latch를 먼저 지우는 경우 등) tick 디바운스가 예전처럼 브레이크
+#ifndef LIMIT_IRQ_CONFIRM_US
+#define LIMIT_IRQ_CONFIRM_US    200u    // 0이면 엔드스탑 IRQ 없음 (tick 디바운스만)
+#endif
+
+// ------------ travel calibration (풀파워 유지 시간 자동 조정) ------------
+// 매 스트로크마다 cruise(엔드스탑 직전 저속) 구간 길이를 재서 풀파워 유지 시간을 조정
+// - cruise가 목표보다 길면 풀파워를 늘리고, 짧으면 줄임 (오차의 1/2^GAIN_SHIFT, 1회 최대 STEP_MAX)
+// - cruise 전에 엔드스탑이 눌리면 (풀파워 과다) 바로 브레이크 + EARLY_BACKOFF 만큼 줄임
+// - 학습값은 파라미터 블록(param_store.c, flash 마지막 sector)에 같이 저장, 부팅 시 복원 (없으면 profile 기본값)
+#define CAL_CRUISE_TARGET_MS    60      // 엔드스탑 전 최소 cruise 구간 (기본값, 파라미터 cal_cruise_ms)
+#define CAL_GAIN_SHIFT          2       // 오차의 1/4씩 반영
+#define CAL_STEP_MAX_MS         40      // 1회 최대 변경
+#define CAL_EARLY_BACKOFF_MS    80      // cruise 전에 엔드스탑 감지 시 감소량
+#define CAL_FULL_MIN_MS         200u
+#define CAL_FULL_MAX_MS         2500u
+
+// flash 기록은 저장값과 이만큼 이상 달라졌을 때만 (마모 방지), HOLD_DOWN 진입 시 (모터 정지 중)
+#define CAL_SAVE_DELTA_MS       20u
+
+// ------------ travel watchdog (엔드스탑이 안 눌릴 때 복구) ------------
+// 스트로크 시작부터 예상 이동 시간 × PCT/100 + MARGIN 안에 가는 방향 엔드스탑이 안 눌리면 timeout
+// - 예상 이동 시간 = max(profile 기준 accel + 학습 full + settle + 목표 cruise, 마지막 정상 스트로크 이동 시간)
+// - 복구 : 브레이크(brake 테이블) → 반대 방향 cruise로 PROBE_MS (걸림 풀기, 반대쪽 엔드스탑이면 바로 끝)
+//          → PAUSE_MS 정지 후 원래 방향 cruise로 re-home
+//          → 엔드스탑이 눌리면 정상 정지 (recovered), REHOME_MS 안에 안 눌리면 도착한 것으로 보고 정지 (blind, 스위치 고장 의심)
+// - 어느 쪽이든 core0에는 평소처럼 도착 이벤트 → 그 target은 몇 초 안에 다음 사이클로 (학습값은 갱신 안 함)
+#define TRAVEL_TIMEOUT_PCT      150u    // 기본값, 파라미터 timeout_pct
+#define TRAVEL_TIMEOUT_MARGIN_MS 100u
+#define TRAVEL_TIMEOUT_MAX_MS   6000u
+#define FAULT_PROBE_MS          150u
+#define FAULT_PAUSE_MS          20u
+#define FAULT_REHOME_MS         450u
+
+// ------------ 조정 파라미터 (param_store.c, stdio 'p' 명령으로 변경 → p save로 flash 저장) ------------
+// X(이름, 기본값, min, max), hot path(core0 phase / core1 tick)는 g_param을 바로 읽음, 바꾸면 다음 phase/tick부터 적용
+// cruise_down/up : cruise 구간 PWM 레벨, 0이면 profile 값(settle 테이블 끝 레벨)
+//                  settle/brake 테이블은 그대로라 profile 값과 많이 다르면 cruise 시작/끝에 계단
+// ramp/풀파워 모양은 motion profile 테이블 (tools/gen_motion_profile.py), 풀파워 유지 시간은 학습값
+#define MNQ_PARAMS(X) \
+    X(hold_down_ms,     HOLD_DOWN_MS,           0,      60000) \
+    X(hold_up_ms,       HOLD_UP_MS,             0,      60000) \
+    X(cruise_down,      0,                      0,      PWM_MAX_LEVEL) \
+    X(cruise_up,        0,                      0,      PWM_MAX_LEVEL) \
+    X(cal_cruise_ms,    CAL_CRUISE_TARGET_MS,   10,     500) \
+    X(timeout_pct,      TRAVEL_TIMEOUT_PCT,     110,    400)
+
+typedef union {
+    struct { MNQ_PARAMS(PARAM_FIELD) };
+    uint32_t v[0 MNQ_PARAMS(PARAM_ONE)];
+} mnq_param_t;
+
+// ------------ targets (보드 1개로 MNQ 여러 대) ------------
+// target마다 탄 감지 입력 3개 + DIR/PWM + 리밋 스위치 2개 = GPIO 7개
+// Pico 사용 가능 GPIO(0~22, 26~28) 중 UART(0, 1)와 HIT_1~3을 빼면 최대 3대
+#ifndef MNQ_TARGET_COUNT
+#define MNQ_TARGET_COUNT        1
+#endif
+
+#if MNQ_TARGET_COUNT < 1 || MNQ_TARGET_COUNT > 3
+#error "MNQ_TARGET_COUNT: 1 ~ 3 (g_mnq_pins 표 참고)"
+#endif
+
+typedef struct {
+    uint8_t detect_head;        // head (DETECT_2)
+    uint8_t detect_body[2];     // body (DETECT_1, DETECT_3)
+    uint8_t dir;                // HIGH=down, LOW=up
+    uint8_t pwm;                // target마다 다른 PWM slice
+    uint8_t limit_top;          // 내려갈 때 눌리면 정지
+    uint8_t limit_under;        // 올라갈 때 눌리면 정지
+} mnq_pins_t;
+
+static const mnq_pins_t g_mnq_pins[MNQ_TARGET_COUNT] = {
+    { DETECT_2, { DETECT_1, DETECT_3 }, MNQ_DIR, MNQ_PWM_PIN, LIMIT_SW_TOP, LIMIT_SW_UNDER },   // PWM slice 4B
+#if MNQ_TARGET_COUNT > 1
+    { 18,       { 17, 19 },             6,       7,           10,           11 },               // PWM slice 3B
+#endif
+#if MNQ_TARGET_COUNT > 2
+    { 21,       { 20, 22 },             2,       26,          27,           28 },               // PWM slice 5A
+#endif
+};
+
+// ------------ 모터 전류 감지 (선택, core1) ------------
+// 모터 드라이버 전류 출력(shunt 앰프) → ADC 입력 (target t = ADC CURRENT_ADC_FIRST + t = GPIO 26 + t)
+// DMA가 입력마다 CURRENT_SAMPLE_HZ로 ring에 기록 (adc_sampler.c), tick마다 새 샘플을 target별 검출기(current_sense.h)에 넣음
+// - 판정은 스트로크 중(accel ~ cruise, re-home)만, 시작 뒤 CURRENT_BLANK_MS는 돌입 전류라 안 봄
+// - stall = CURRENT_STALL_LEVEL 이상 또는 구간 평균 + CURRENT_RISE 이상이 CURRENT_CONFIRM_N 샘플 연속
+// - 예상 이동 시간의 CURRENT_END_PCT% 뒤(또는 re-home 중) stall → 끝 도착 : 엔드스탑과 같이 브레이크 (스위치가 늦거나 고장이어도 정지)
+//   그 전 stall → 걸림(jam) : 브레이크 → 반대 방향 probe → 스트로크 처음부터 다시 (CURRENT_JAM_RETRY회, 다 쓰면 그 자리에서 정지)
+// - 스트로크마다 최대 전류(돌입 뒤) 기록, s로 출력
+// 기준값(count)은 보드 shunt/앰프 이득에 맞출 것 (기본값은 host plant 기준)
+#ifndef MOTOR_CURRENT_SENSE
+#define MOTOR_CURRENT_SENSE     0       // 1이면 ADC 전류 감지 사용
+#endif
+#define CURRENT_ADC_FIRST       0u
+#define CURRENT_SAMPLE_HZ       5000u   // target마다
+#define CURRENT_BLANK_MS        20u
+#define CURRENT_STALL_LEVEL     3200u   // 12 bit count
+#define CURRENT_RISE            800u
+#define CURRENT_CONFIRM_N       5u      // 1 ms
+#define CURRENT_AVG_SHIFT       5u      // 평균 시정수 32 샘플 (6.4 ms)
+#define CURRENT_END_PCT         80u
+#define CURRENT_JAM_RETRY       2u
+
+#define CURRENT_SAMPLES(ms)     ((uint64_t)(ms) * CURRENT_SAMPLE_HZ / 1000u)
+
+#if MOTOR_CURRENT_SENSE && CURRENT_ADC_FIRST + MNQ_TARGET_COUNT > 3
+#error "MOTOR_CURRENT_SENSE: target마다 ADC 입력 1개 (GPIO 26~28), target 2가 그 핀을 씀 → MNQ_TARGET_COUNT 2 이하"
+#endif
+
+// ------------ inter-core message ------------
+// core0 (탄 감지 / MNQ 상태) ↔ core1 (모터 ramp / 엔드스탑), pico/util/queue 2개 (SRAM + spin lock)
+// SIO FIFO는 flash_safe_execute lockout 전용 : core1 lockout handler가 FIFO의 다른 word를 버리고,
+// core0 handshake도 자기 FIFO를 비움 → 명령/이벤트를 FIFO로 보내면 사라짐
+// message = target << 8 | code
+#define MNQ_QUEUE_DEPTH         8u
+#define MNQ_MSG(t, code)        (((uint32_t)(t) << 8) | (code))
+#define MNQ_MSG_TARGET(m)       ((m) >> 8)
+#define MNQ_MSG_CODE(m)         ((m) & 0xffu)
+
+// core0 → core1 : 모터 명령
+#define MOTOR_CMD_DOWN          0x01u   // 내려가기 시작
+#define MOTOR_CMD_UP            0x02u   // 올라가기 시작
+
+// core1 → core0 : 모터 상태
+#define MOTOR_EVT_AT_BOTTOM     0x11u   // 다 내려가서 정지
+#define MOTOR_EVT_AT_TOP        0x12u   // 다 올라와서 정지
+
+static queue_t g_motor_cmd_q;           // core0 → core1
+static queue_t g_motor_evt_q;           // core1 → core0
+
+// ------------ interrupt edge event ------------
+// ISR → main : DETECT_x 엣지를 시각과 함께 링 버퍼로 전달 (엣지 2개가 하나로 합쳐지지 않음)
+static edge_ring_t g_edge_ring;
+
+// main loop 1회에 꺼내는 최대 이벤트 수
+#define EDGE_DRAIN_BATCH    8u
+
+// GPIO → target / 역할 (탄 감지 입력만)
+#define PIN_NONE            0xffu
+#define PIN_ROLE_HEAD       0u
+#define PIN_ROLE_BODY       1u
+static uint8_t g_pin_target[32];
+static uint8_t g_pin_role[32];
+
+// ------------ MNQ state (core0) / motor state (core1) ------------
 
 typedef enum {
     PHASE_READY_UP = 0,   // 위에서 대기(탄 감지 받는 상태)
@@ -73,43 +230,156 @@ typedef enum {
     PHASE_HOLD_UP         // 올라간 후 1초 대기
 } mnq_phase_t;
 
-static mnq_phase_t g_phase = PHASE_READY_UP;
-static uint32_t g_phase_deadline_ms = 0;    // HOLD_DOWN/HOLD_UP 끝나는 시간(ms)
-
 typedef enum {
     MOTOR_IDLE = 0,
-    MOTOR_RAMP_UP,        // 0 → 255, 1ms에 5씩
-    MOTOR_FULL,           // 255 유지 (FULL_POWER_MS_xx)
-    MOTOR_RAMP_CRUISE,    // 255 → 150, 1ms에 1씩
-    MOTOR_CRUISE,         // 150 유지 (엔드스탑까지)
-    MOTOR_RAMP_STOP       // 150 → 0, 1ms에 3씩 (엔드스탑 감지 후)
+    MOTOR_RAMP_UP,        // 0 → peak (profile accel 테이블)
+    MOTOR_FULL,           // peak 유지 (profile full_ticks)
+    MOTOR_RAMP_CRUISE,    // peak → cruise (profile settle 테이블)
+    MOTOR_CRUISE,         // cruise 유지 (엔드스탑까지)
+    MOTOR_RAMP_STOP,      // cruise → 0 (profile brake 테이블, 엔드스탑 감지 후)
+    MOTOR_FAULT_BRAKE,    // travel timeout → 0 (brake 테이블)
+    MOTOR_FAULT_PROBE,    // 반대 방향 cruise (FAULT_PROBE_MS 또는 반대쪽 엔드스탑까지)
+    MOTOR_FAULT_REHOME    // 원래 방향 cruise로 엔드스탑까지 (FAULT_REHOME_MS 제한)
 } motor_state_t;
 
-static motor_state_t g_motor_state = MOTOR_IDLE;
-static bool g_motor_dir_down = false;           // true=내려가는 중, false=올라가는 중
-static uint32_t g_motor_state_start_ms = 0;
-static uint16_t g_motor_level = 0;
-static bool g_motor_just_stopped = false;       // IDLE로 막 진입했을 때 1회 true
-
-// ------------ limit sw set ------------
-static bool up_stop = true;
-static bool down_stop = false;
-static bool up_status = true;   // 올라가 있으면 true, 내려가 있으면 false
-
-// ------------ PWM set ------------
-static uint slice_num;
-static uint pwm_wrap = 255;
-
-// ------------ HIT out state (not use) ------------
-static bool hit1_on = false;
-static bool hit2_on = false;
-static bool hit3_on = false;
+// ------------ target 1대 상태 ------------
+// core0 : phase ~ down_trigger_us, core1 : motor_* / cal_* (학습값은 core0가 읽어서 flash 저장)
+typedef struct {
+    const mnq_pins_t *pins;
+
+    // MNQ 상태 (core0)
+    mnq_phase_t phase;
+    uint32_t phase_deadline_ms;     // HOLD_DOWN/HOLD_UP 끝나는 시간(ms)
+    int body_shot_count;            // body shot 수 (DETECT_1 or DETECT_3)
+    uint64_t down_trigger_us;       // 마지막으로 MNQ를 내리게 한 탄의 엣지 시각(us), 지연 분석용
+
+    // 모터 (core1)
+    motor_state_t motor_state;
+    bool motor_dir_down;            // true=내려가는 중, false=올라가는 중
+    bool motor_just_stopped;        // IDLE로 막 진입했을 때 1회 true
+    uint16_t motor_level;
+    const motion_profile_t *profile;
+    uint32_t motor_state_start_ms;
+    volatile uint32_t motor_cmd;    // core1 명령 queue → tick으로 넘기는 명령, 0이면 없음
+    uint slice_num;
+    int ramp_out;                   // pwm_ramp 출력 번호, -1이면 ramp도 tick마다
+    bool ramp_dma;                  // 지금 ramp 구간을 DMA로 재생 중 (끝나면 DMA 완료 IRQ에서 다음 상태로)
+
+    // limit sw (core1)
+    bool up_stop;
+    bool down_stop;
+    bool up_status;                 // 올라가 있으면 true, 내려가 있으면 false
+
+    // travel calibration (core1 tick에서 학습)
+    volatile uint16_t cal_full_ms[2];
+    volatile uint16_t cal_last_cruise_ms[2];    // 마지막 스트로크의 cruise 구간
+    volatile uint16_t cal_last_travel_ms[2];    // 마지막 스트로크 시작 → 엔드스탑
+    volatile uint32_t cal_early[2];             // cruise 전에 엔드스탑 눌린 횟수
+    uint32_t cal_stroke_start;                  // tick
+    uint32_t cal_cruise_start;                  // tick
+
+    // travel watchdog (core1, [0] = 올라갈 때, [1] = 내려갈 때)
+    uint32_t travel_timeout_ms;                 // 이번 스트로크 제한
+    volatile uint32_t fault_timeout[2];         // timeout 횟수
+    volatile uint32_t fault_recovered[2];       // re-home 중 엔드스탑 눌림
+    volatile uint32_t fault_blind[2];           // re-home 중에도 안 눌림 → 시간으로 도착 처리
+
+    // 엔드스탑 IRQ (core1, [0] = limit_under, [1] = limit_top → 가는 방향 끝은 [motor_dir_down])
+    uint64_t limit_edge_us[2];                  // 이번 눌림의 하강엣지 시각, 0 = 없음
+    alarm_id_t limit_alarm[2];                  // 눌림 확인 대기, 0이면 IRQ 켜짐
+
+    // 전류 감지 (core1, MOTOR_CURRENT_SENSE, [0] = 올라갈 때, [1] = 내려갈 때)
+    csense_t cur;
+    bool cur_jam;                               // 이번 FAULT_BRAKE는 걸림 → probe 뒤 스트로크 다시
+    uint8_t cur_retry;                          // 이번 스트로크를 다시 시작한 횟수
+    volatile uint16_t cur_peak_last[2];         // 마지막 스트로크 최대 전류 (돌입 뒤, count)
+    volatile uint16_t cur_peak_max[2];
+    volatile uint32_t cur_end[2];               // stall로 끝 도착 판정
+    volatile uint32_t cur_jam_n[2];             // 걸림 판정
+    volatile uint32_t cur_jam_abort[2];         // 다시 시작을 다 쓰고 그 자리에서 정지
+} mnq_target_t;
+
+static mnq_target_t g_mnq[MNQ_TARGET_COUNT];
+
+// 리밋 스위치 디바운스 (bit = GPIO, 1 = HIGH/놓임), tick마다 gpio_get_all 1회로 전 target 동시
+#define LIMIT_DEBOUNCE_TICKS    2       // 2 tick(2ms) 연속 같은 값이면 확정, 1이면 디바운스 없음
+static uint32_t g_limit_mask = 0;
+static vdebounce_t g_limit_db;
+
+// core1 alarm IRQ로 1ms마다 전 target motor_update 실행, ramp 시간 기준은 tick 수 (1 tick = 1 ms)
+static repeating_timer_t g_motor_timer;
+static volatile uint32_t g_motor_tick = 0;
+static alarm_pool_t *g_core1_pool = NULL;      // tick + 엔드스탑 확인 alarm (core1 IRQ)
+static bool g_current_on = false;               // ADC 샘플러 시작됨 (MOTOR_CURRENT_SENSE)
+
+// 엔드스탑 → 브레이크 지연 : 하강엣지 시각 → RAMP_STOP 시작 (엔드스탑 IRQ에서 기록, core0에서 stdio로 출력)
+// [0] = tick 디바운스로 시작 (IRQ를 놓친 경우), [1] = IRQ 확인으로 시작
+#define BRAKE_BY_TICK           0u
+#define BRAKE_BY_IRQ            1u
+
+typedef struct {
+    uint32_t n;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+} brake_lat_t;
+
+static brake_lat_t g_brake_lat[2];
+static volatile uint32_t g_limit_glitch = 0;        // 확인 때 이미 HIGH (잡음/채터링)
+static volatile bool g_brake_lat_reset = true;
+
+// GPIO trace 리밋 핀 : IRQ는 core1만 켬 (IO_BANK0 INTR latch를 두 core가 ack하면 엔드스탑 엣지가 지워짐)
+// core0 't' → g_trace_req → core1 tick이 양 엣지 IRQ를 켜고 g_trace_ready → core0가 gpio_trace_start (시작 레벨 저장)
+static volatile bool g_trace_req = false;           // core0 → core1
+static volatile bool g_trace_ready = false;         // core1 → core0
+
+// tick 주기 통계 (tick IRQ에서 기록, core0에서 stdio로 출력)
+// seq가 홀수면 갱신 중 → 읽는 쪽은 seq가 짝수이고 앞뒤로 같을 때까지 다시 읽음
+typedef struct {
+    volatile uint32_t seq;
+    uint32_t count;             // 측정된 주기 수
+    uint32_t period_min_us;
+    uint32_t period_max_us;
+    uint64_t period_sum_us;
+    uint32_t late_max_us;       // 예정 시각 대비 최대 지연
+    uint32_t overrun;           // MOTOR_TICK_LATE_US 넘게 늦은 tick 수
+} tick_stats_t;
+
+static tick_stats_t g_tick_stats;
+static volatile bool g_tick_stats_reset = true;
+static uint64_t g_tick_last_us = 0;
+static uint64_t g_tick_due_us = 0;              // 이번 tick 예정 시각
+
+// ------------ 파라미터 / travel calibration state ------------
+static mnq_param_t g_param;
+static const param_desc_t g_param_desc[] = { MNQ_PARAMS(PARAM_DESC) };
+static param_store_t g_param_store;                 // g_param + g_cal_saved (aux)
+
+static volatile bool g_cal_reset = false;           // core0 → core1 : 기본값으로 되돌림
+static bool g_cal_pending = false;                  // HOLD_DOWN 진입 후 저장 검사 대기 (core0)
+static uint16_t g_cal_saved[MNQ_TARGET_COUNT][2];   // flash에 있는 학습값 (core0)
+static uint32_t g_cal_save_count = 0;
 
 static void gpio_setup(void);
 static void StartSignal(void);
 static inline uint32_t now_ms(void);
-static void motor_update(uint32_t now);
+static void mnq_init(void);
+static void motor_start_move(mnq_target_t *m, bool down, uint32_t now);
+static void motor_update(mnq_target_t *m, uint32_t now);
+static void motor_ramp_done(uint out, void *arg);
+static void motor_notify_stop(mnq_target_t *m);
+static void limit_irq_callback(uint gpio, uint32_t events);
+static void limit_trace_enable(void);
 static void mnq_state_update(uint32_t now);
+static void core1_main(void);
+static void tick_stats_print(void);
+static void param_load(void);
+static void cal_save_if_changed(void);
+static void cal_print(void);
+static void fault_print(void);
+static void endstop_print(void);
+static void current_print(void);
+static void motor_current_poll(uint32_t now);
 
 // ------------ main ------------
 int main() {
@@ -119,26 +389,73 @@ int main() {
     set_sys_clock_khz(PICO_SYS_CLK_kHz, true);
     busy_wait_ms(100);
 
+    mnq_init();
     gpio_setup();
     sleep_ms(10);
 
+    // 조정 파라미터 + 학습된 풀파워 유지 시간 복원 (core1 시작 전)
+    param_load();
+
+    // 모터 제어는 core1에서 (탄 감지/상태머신과 서로 타이밍 간섭 없음)
+    queue_init(&g_motor_cmd_q, sizeof(uint32_t), MNQ_QUEUE_DEPTH);
+    queue_init(&g_motor_evt_q, sizeof(uint32_t), MNQ_QUEUE_DEPTH);
+    multicore_launch_core1(core1_main);
+
     StartSignal();
     sleep_ms(10);
 
     // 초기 상태: MNQ 위에 있다고 가정
-    g_phase = PHASE_MOVING_DOWN;
-    body_shot_count = 0;
-    // hits_clear();
+    // (MOVING_DOWN으로 시작하면 모터가 IDLE이라 정지 이벤트가 오지 않아 상태머신이 멈춤)
+    for (uint t = 0; t < MNQ_TARGET_COUNT; t++) {
+        g_mnq[t].phase = PHASE_READY_UP;
+        g_mnq[t].body_shot_count = 0;
+    }
 
     while (true) {
         uint32_t now = now_ms();
 
-        // 모터 제어 (ramp up/down, cruise, endstop 처리)
-        motor_update(now);
-
         // MNQ 상태 / 탄 감지 상태머신
         mnq_state_update(now);
 
+        // stdio 명령 : s = tick 통계/학습값/travel fault/IRQ guard 출력, r = 통계 초기화, c = 학습값 초기화
+        //             t = GPIO trace 기록 시작, d = trace 정지 + hex 덤프
+        //             p ... = 조정 파라미터 한 줄 (param_store.h, 저장은 모든 모터가 멈췄을 때)
+        int c = getchar_timeout_us(0);
+        if (param_store_cli(&g_param_store, c)) {
+            // p 명령 줄 입력 중
+        } else if (c == 's') {
+            tick_stats_print();
+            cal_print();
+            fault_print();
+            endstop_print();
+            current_print();
+            irq_guard_dump();
+            pwm_ramp_dump();
+        } else if (c == 'r') {
+            g_tick_stats_reset = true;
+            g_brake_lat_reset = true;
+            irq_guard_reset();
+            pwm_ramp_reset();
+            if (g_current_on) adc_sampler_reset();
+        } else if (c == 'c') {
+            g_cal_reset = true;
+        } else if (c == 't') {
+            g_trace_ready = false;
+            g_trace_req = true;
+        } else if (c == 'd') {
+            // 덤프 동안 상태머신 멈춤 (진단용, 엣지는 링 버퍼에 남아 있음)
+            gpio_trace_dump();
+        }
+        if (g_trace_ready) {
+            // core1이 리밋 핀 IRQ를 켠 뒤 시작 (그 사이 엣지가 시작 레벨에 반영되게)
+            // holdoff 중인 DETECT 핀은 먼저 IRQ를 되돌림 (꺼진 상태가 trace 전 IRQ로 저장되면 stop 때 감지가 꺼짐)
+            g_trace_ready = false;
+            uint32_t irq_state = save_and_disable_interrupts();
+            irq_guard_release_all();
+            gpio_trace_start();
+            restore_interrupts(irq_state);
+        }
+
         tight_loop_contents();
         sleep_ms(1);  // 1ms 단위로 갱신
     }
@@ -146,6 +463,188 @@ int main() {
     return 0;
 }
 
+// ------------ core1 : 모터 제어 (ramp up/down, cruise, endstop 처리) ------------
+
+// tick 주기/지연 기록 (tick IRQ 안에서 호출)
+static void tick_stats_update(uint64_t t_us) {
+    tick_stats_t *st = &g_tick_stats;
+    st->seq++;
+    __mem_fence_release();
+
+    if (g_tick_stats_reset) {
+        // 초기화 요청 : 이번 tick부터 다시 측정
+        g_tick_stats_reset = false;
+        st->count = 0;
+        st->period_min_us = UINT32_MAX;
+        st->period_max_us = 0;
+        st->period_sum_us = 0;
+        st->late_max_us = 0;
+        st->overrun = 0;
+    } else {
+        uint32_t period = (uint32_t)(t_us - g_tick_last_us);
+        uint32_t late = t_us > g_tick_due_us ? (uint32_t)(t_us - g_tick_due_us) : 0;
+
+        st->count++;
+        st->period_sum_us += period;
+        if (period < st->period_min_us) st->period_min_us = period;
+        if (period > st->period_max_us) st->period_max_us = period;
+        if (late > st->late_max_us) st->late_max_us = late;
+        if (late > MOTOR_TICK_LATE_US) st->overrun++;
+    }
+    g_tick_last_us = t_us;
+
+    __mem_fence_release();
+    st->seq++;
+}
+
+// 정지 위치를 core0로 알림 (IRQ 안이므로 queue 자리가 있을 때만, 없으면 다음 tick에 다시)
+static void motor_notify_stop(mnq_target_t *m) {
+    if (!m->motor_just_stopped) return;
+    uint32_t msg = MNQ_MSG(m - g_mnq, m->motor_dir_down ? MOTOR_EVT_AT_BOTTOM : MOTOR_EVT_AT_TOP);
+    if (queue_try_add(&g_motor_evt_q, &msg)) m->motor_just_stopped = false;
+}
+
+// 1 kHz motor tick (core1 alarm IRQ)
+static bool motor_tick_cb(repeating_timer_t *rt) {
+    (void)rt;
+    uint64_t t_us = time_us_64();
+
+    // 고정 주기(delay<0) → 다음 예정 시각은 지난 예정 시각 + 1ms
+    if (g_tick_due_us == 0) g_tick_due_us = t_us;
+    tick_stats_update(t_us);
+    g_tick_due_us += MOTOR_TICK_US;
+
+    uint32_t tick = ++g_motor_tick;
+
+    bool cal_reset = g_cal_reset;
+    g_cal_reset = false;
+
+    if (g_trace_req) {
+        g_trace_req = false;
+        limit_trace_enable();
+        g_trace_ready = true;
+    }
+
+    // 리밋 스위치 : 전 target 한 번에 읽고 디바운스, 놓인 스위치는 다음 눌림 엣지를 새로 기록
+    uint32_t flip = vdebounce_update(&g_limit_db, gpio_get_all() & g_limit_mask, LIMIT_DEBOUNCE_TICKS);
+    uint32_t released = flip & g_limit_db.state;
+
+    if (g_brake_lat_reset) {
+        g_brake_lat_reset = false;
+        g_brake_lat[BRAKE_BY_TICK] = (brake_lat_t){ 0 };
+        g_brake_lat[BRAKE_BY_IRQ] = (brake_lat_t){ 0 };
+        g_limit_glitch = 0;
+    }
+
+    // 모터 전류 : 지난 tick 뒤 샘플 판정 (stall → 끝 도착 / 걸림)
+    if (g_current_on) motor_current_poll(tick);
+
+    for (uint t = 0; t < MNQ_TARGET_COUNT; t++) {
+        mnq_target_t *m = &g_mnq[t];
+
+        if (cal_reset) {
+            m->cal_full_ms[0] = MOTION_PROFILE_UP.full_ticks;
+            m->cal_full_ms[1] = MOTION_PROFILE_DOWN.full_ticks;
+        }
+        if (released & (1u << m->pins->limit_under)) m->limit_edge_us[0] = 0;
+        if (released & (1u << m->pins->limit_top))   m->limit_edge_us[1] = 0;
+
+        // core0 명령
+        uint32_t cmd = m->motor_cmd;
+        if (cmd != 0) {
+            m->motor_cmd = 0;
+            if (cmd == MOTOR_CMD_DOWN) {
+                motor_start_move(m, true, tick);
+            } else if (cmd == MOTOR_CMD_UP) {
+                motor_start_move(m, false, tick);
+            }
+        }
+
+        motor_update(m, tick);
+        motor_notify_stop(m);
+    }
+    return true;
+}
+
+static void core1_main(void) {
+    // core0가 flash 기록할 때 core1을 잠시 RAM에서 멈출 수 있게 (flash_safe_execute)
+    multicore_lockout_victim_init();
+
+    // 리밋 스위치 초기 상태 (부팅 직후 가짜 눌림/놓임 없음)
+    vdebounce_init(&g_limit_db, gpio_get_all() & g_limit_mask);
+
+    // ramp 테이블 DMA 재생 : 완료 IRQ도 core1 (tick과 같은 우선순위라 서로 끼어들지 않음)
+    bool ramp = pwm_ramp_init(MOTOR_TICK_US, motor_ramp_done);
+    for (uint t = 0; t < MNQ_TARGET_COUNT; t++) {
+        g_mnq[t].ramp_out = ramp ? pwm_ramp_add(g_mnq[t].pins->pwm, &g_mnq[t]) : -1;
+    }
+
+    // 모터 전류 : ADC round robin (target마다 입력 1개) → DMA ring, 판정은 tick에서
+    if (MOTOR_CURRENT_SENSE) {
+        const csense_cfg_t cfg = {
+            .blank_n = (uint16_t)CURRENT_SAMPLES(CURRENT_BLANK_MS),
+            .stall_level = CURRENT_STALL_LEVEL,
+            .rise = CURRENT_RISE,
+            .confirm_n = CURRENT_CONFIRM_N,
+            .avg_shift = CURRENT_AVG_SHIFT,
+        };
+        for (uint t = 0; t < MNQ_TARGET_COUNT; t++) csense_init(&g_mnq[t].cur, &cfg);
+        g_current_on = adc_sampler_start(CURRENT_ADC_FIRST, MNQ_TARGET_COUNT, CURRENT_SAMPLE_HZ);
+    }
+
+    // core1 전용 alarm pool → tick / 엔드스탑 확인 IRQ가 core1에서 실행 (core0 GPIO IRQ와 간섭 없음)
+    g_core1_pool = alarm_pool_create_with_unused_hardware_alarm(2u + 2u * MNQ_TARGET_COUNT);
+
+    // 엔드스탑 하강엣지 IRQ (GPIO 콜백은 core마다 따로 → core1 콜백)
+    if (LIMIT_IRQ_CONFIRM_US > 0) {
+        for (uint t = 0; t < MNQ_TARGET_COUNT; t++) {
+            gpio_set_irq_enabled_with_callback(g_mnq[t].pins->limit_under, GPIO_IRQ_EDGE_FALL, true, &limit_irq_callback);
+            gpio_set_irq_enabled_with_callback(g_mnq[t].pins->limit_top, GPIO_IRQ_EDGE_FALL, true, &limit_irq_callback);
+        }
+    }
+
+    alarm_pool_add_repeating_timer_us(g_core1_pool, -(int64_t)MOTOR_TICK_US, motor_tick_cb, NULL, &g_motor_timer);
+
+    // core0 명령 대기 (queue가 빈 동안 WFE로 잠듦), 실제 처리는 다음 tick에서
+    while (true) {
+        uint32_t msg;
+        queue_remove_blocking(&g_motor_cmd_q, &msg);
+        uint32_t t = MNQ_MSG_TARGET(msg);
+        if (t < MNQ_TARGET_COUNT) g_mnq[t].motor_cmd = MNQ_MSG_CODE(msg);
+    }
+}
+
+// ------------ tick stats : stdio 출력 (core0) ------------
+static void tick_stats_print(void) {
+    tick_stats_t snap;
+    uint32_t seq;
+
+    do {
+        seq = g_tick_stats.seq;
+        __mem_fence_acquire();
+        snap.count = g_tick_stats.count;
+        snap.period_min_us = g_tick_stats.period_min_us;
+        snap.period_max_us = g_tick_stats.period_max_us;
+        snap.period_sum_us = g_tick_stats.period_sum_us;
+        snap.late_max_us = g_tick_stats.late_max_us;
+        snap.overrun = g_tick_stats.overrun;
+        __mem_fence_acquire();
+    } while ((seq & 1u) || seq != g_tick_stats.seq);
+
+    if (snap.count == 0) {
+        printf("tick: no data\n");
+        return;
+    }
+    printf("tick: n=%lu period min=%lu max=%lu mean=%lu.%03lu us, late max=%lu us, overrun=%lu\n",
+           (unsigned long)snap.count,
+           (unsigned long)snap.period_min_us,
+           (unsigned long)snap.period_max_us,
+           (unsigned long)(snap.period_sum_us / snap.count),
+           (unsigned long)((snap.period_sum_us % snap.count) * 1000u / snap.count),
+           (unsigned long)snap.late_max_us,
+           (unsigned long)snap.overrun);
+}
+
 // ------------ util : now time(ms) ------------
 static inline uint32_t now_ms(void) {
     return to_ms_since_boot(get_absolute_time());
@@ -162,153 +661,482 @@ void StartSignal(void)
 
 // ------------ GPIO IRQ callback : DETECT_1/2/3 상승엣지 감지 ------------
 static void gpio_irq_callback(uint gpio, uint32_t events) {
+    uint64_t t_us = time_us_64();
+
+    // trace 기록 중이면 DETECT 양 엣지 모두 기록 (LIMIT은 core1 limit_irq_callback)
+    gpio_trace_irq(gpio, events, t_us);
+
     if (events & GPIO_IRQ_EDGE_RISE) {
-        if (gpio == DETECT_1) {
-            detect1_rise = true;
-        } else if (gpio == DETECT_2) {
-            detect2_rise = true;
-        } else if (gpio == DETECT_3) {
-            detect3_rise = true;
+        if (gpio < 32 && g_pin_target[gpio] != PIN_NONE) {
+            edge_ring_push(&g_edge_ring, gpio, GPIO_IRQ_EDGE_RISE, t_us);
+            // holdoff 동안 이 핀 IRQ 끔, trace 중에는 채터링도 기록해야 하므로 guard 안 함
+            if (!gpio_trace_active()) irq_guard_hold(gpio);
         }
     }
 }
 
 // ------------ PWM Duty set (0~255) ------------
-static void motor_set_level(uint16_t level) {
+static void motor_set_level(mnq_target_t *m, uint16_t level) {
     if (level > PWM_MAX_LEVEL) level = PWM_MAX_LEVEL;
-    g_motor_level = level;
+    m->motor_level = level;
+
+    pwm_set_gpio_level(m->pins->pwm, level);
+}
+
+// cruise 레벨 : 파라미터가 0이면 profile 값
+static inline uint16_t motor_cruise_level(const mnq_target_t *m) {
+    uint32_t level = m->motor_dir_down ? g_param.cruise_down : g_param.cruise_up;
+    return level ? (uint16_t)level : m->profile->cruise;
+}
 
-    pwm_set_gpio_level(MNQ_PWM_PIN, level);
+// ------------ travel watchdog : 이번 스트로크 제한 시간 (core1) ------------
+// 예상 이동 시간 (전류 감지의 끝 도착 / 걸림 구분에도 씀)
+static uint32_t travel_expect_ms(const mnq_target_t *m, bool down) {
+    const motion_profile_t *p = down ? &MOTION_PROFILE_DOWN : &MOTION_PROFILE_UP;
+    uint d = down ? 1u : 0u;
+    uint32_t expect = (uint32_t)p->accel_len + m->cal_full_ms[d] + p->settle_len + g_param.cal_cruise_ms;
+    return m->cal_last_travel_ms[d] > expect ? m->cal_last_travel_ms[d] : expect;
+}
+
+static uint32_t travel_timeout_ms(const mnq_target_t *m, bool down) {
+    uint32_t limit = travel_expect_ms(m, down) * g_param.timeout_pct / 100u + TRAVEL_TIMEOUT_MARGIN_MS;
+    return limit < TRAVEL_TIMEOUT_MAX_MS ? limit : TRAVEL_TIMEOUT_MAX_MS;
+}
+
+// ------------ ramp 구간 (accel / settle / brake) ------------
+// DMA 재생 중에는 tick이 레벨을 안 건드림, 마지막 값을 쓰면 DMA 완료 IRQ(core1)에서 바로 다음 상태로
+// DMA가 없거나 테이블이 PWM_RAMP_MAX_STEPS보다 길면 tick마다 테이블 값 하나 (motor_ramp_tick)
+static const uint8_t *motor_ramp_table(const mnq_target_t *m, motor_state_t state, uint16_t *len) {
+    const motion_profile_t *p = m->profile;
+    switch (state) {
+        case MOTOR_RAMP_UP:     *len = p->accel_len;  return p->accel;
+        case MOTOR_RAMP_CRUISE: *len = p->settle_len; return p->settle;
+        case MOTOR_RAMP_STOP:
+        case MOTOR_FAULT_BRAKE: *len = p->brake_len;  return p->brake;
+        default:                *len = 0;             return NULL;
+    }
+}
+
+// 재생 중이던 ramp는 지금 레벨에서 멈춤
+static void motor_ramp_cancel(mnq_target_t *m) {
+    if (!m->ramp_dma) return;
+    pwm_ramp_stop((uint)m->ramp_out);
+    m->motor_level = pwm_ramp_level((uint)m->ramp_out);
+    m->ramp_dma = false;
+}
+
+// ------------ 전류 감지 : 스트로크 구간 arm / disarm (core1) ------------
+// 구동 중(accel ~ cruise)과 re-home만 판정, 스트로크 시작(RAMP_UP)마다 다시 arm
+static bool motor_current_watched(motor_state_t state) {
+    return state == MOTOR_RAMP_UP || state == MOTOR_FULL || state == MOTOR_RAMP_CRUISE ||
+           state == MOTOR_CRUISE || state == MOTOR_FAULT_REHOME;
+}
+
+// 지금 시각까지 끝난 이 target 입력의 샘플 수 (다음 샘플 번호, 입력별)
+static uint64_t motor_current_index(const mnq_target_t *m) {
+    uint n = adc_sampler_inputs();
+    uint t = (uint)(m - g_mnq);
+    uint64_t k = adc_sampler_index_at(time_us_64());
+    return (k + n - 1u - t) / n;
+}
+
+static void motor_current_track(mnq_target_t *m, motor_state_t next) {
+    if (!g_current_on) return;
+    bool was = motor_current_watched(m->motor_state);
+    bool will = motor_current_watched(next);
+
+    if (was && (!will || next == MOTOR_RAMP_UP)) {
+        // 구간 끝 : 최대 전류 기록 (판정으로 이미 disarm 되었어도)
+        uint d = m->motor_dir_down ? 1u : 0u;
+        uint16_t peak = m->cur.run_peak;
+        m->cur_peak_last[d] = peak;
+        if (peak > m->cur_peak_max[d]) m->cur_peak_max[d] = peak;
+        csense_disarm(&m->cur);
+    }
+    if (will && (!was || next == MOTOR_RAMP_UP)) {
+        // re-home은 FAULT_PAUSE_MS 정지 뒤 출발 → 그때부터 blank
+        uint64_t idx = motor_current_index(m);
+        if (next == MOTOR_FAULT_REHOME) idx += CURRENT_SAMPLES(FAULT_PAUSE_MS);
+        csense_arm(&m->cur, idx);
+    }
+}
+
+// 상태 전환 (ramp 구간이면 지금 레벨에서 DMA 재생 시작)
+static void motor_enter(mnq_target_t *m, motor_state_t state, uint32_t now) {
+    motor_ramp_cancel(m);
+    motor_current_track(m, state);
+    m->motor_state = state;
+    m->motor_state_start_ms = now;
+
+    uint16_t len;
+    const uint8_t *tab = motor_ramp_table(m, state, &len);
+    if (tab && m->ramp_out >= 0) m->ramp_dma = pwm_ramp_play((uint)m->ramp_out, tab, len);
+}
+
+// ramp 구간 끝 → 다음 상태
+static void motor_ramp_end(mnq_target_t *m, uint32_t now) {
+    switch (m->motor_state) {
+        case MOTOR_RAMP_UP:
+            motor_enter(m, MOTOR_FULL, now);
+            break;
+
+        case MOTOR_RAMP_CRUISE:
+            motor_enter(m, MOTOR_CRUISE, now);
+            m->cal_cruise_start = now;
+            break;
+
+        case MOTOR_RAMP_STOP:
+            motor_enter(m, MOTOR_IDLE, now);
+            motor_set_level(m, 0);
+            m->motor_just_stopped = true;
+            break;
+
+        case MOTOR_FAULT_BRAKE:
+            // 멈춘 뒤 반대 방향으로
+            motor_enter(m, MOTOR_FAULT_PROBE, now);
+            motor_set_level(m, 0);
+            gpio_put(m->pins->dir, m->motor_dir_down ? 0 : 1);
+            break;
+
+        default:
+            break;
+    }
+}
+
+// DMA 재생 끝 (DMA_IRQ_1, core1) : 시각 기준은 마지막 tick, 브레이크 끝이면 다음 tick을 기다리지 않고 core0에 알림
+static void motor_ramp_done(uint out, void *arg) {
+    mnq_target_t *m = (mnq_target_t *)arg;
+    if (!m->ramp_dma) return;
+    m->ramp_dma = false;
+    m->motor_level = pwm_ramp_level(out);
+    motor_ramp_end(m, g_motor_tick);
+    motor_notify_stop(m);
+}
+
+// DMA 없이 재생 : tick마다 테이블 값 하나
+static void motor_ramp_tick(mnq_target_t *m, uint32_t now) {
+    if (m->ramp_dma) return;
+
+    uint16_t len;
+    const uint8_t *tab = motor_ramp_table(m, m->motor_state, &len);
+    uint16_t level = m->motor_level;
+    bool end = motion_profile_step(tab, len, now - m->motor_state_start_ms, &level);
+    motor_set_level(m, level);
+    if (end) motor_ramp_end(m, now);
 }
 
 // ------------ motor start : down or up ------------
-static void motor_start_move(bool down, uint32_t now) {
-    g_motor_dir_down = down;
-    g_motor_state = MOTOR_RAMP_UP;
-    g_motor_state_start_ms = now;
-    g_motor_just_stopped = false;
-    motor_set_level(0);
+static void motor_start_move(mnq_target_t *m, bool down, uint32_t now) {
+    motor_ramp_cancel(m);
+    m->motor_dir_down = down;
+    m->profile = down ? &MOTION_PROFILE_DOWN : &MOTION_PROFILE_UP;
+    m->motor_just_stopped = false;
+    m->cal_stroke_start = now;
+    m->cal_cruise_start = now;
+    m->travel_timeout_ms = travel_timeout_ms(m, down);
+    m->cur_jam = false;
+    m->cur_retry = 0;
+    motor_set_level(m, 0);
 
     // dir set
-    gpio_put(MNQ_DIR, down ? 1 : 0);
+    gpio_put(m->pins->dir, down ? 1 : 0);
+
+    motor_enter(m, MOTOR_RAMP_UP, now);
 }
 
-// ------------ motor update (비차단, 주기적으로 호출) ------------
-static void motor_update(uint32_t now) {
-    // read limit sw state
-    int top_sw   = gpio_get(LIMIT_SW_TOP);   // 눌리면 low
-    int under_sw = gpio_get(LIMIT_SW_UNDER); // 눌리면 low
+// ------------ travel calibration : 스트로크 끝(엔드스탑 감지)마다 풀파워 유지 시간 조정 (core1) ------------
+static void cal_stroke_done(mnq_target_t *m, uint32_t now, bool early) {
+    uint d = m->motor_dir_down ? 1u : 0u;
+    int32_t full = m->cal_full_ms[d];
+    int32_t delta;
+
+    m->cal_last_travel_ms[d] = (uint16_t)(now - m->cal_stroke_start);
+
+    if (early) {
+        m->cal_last_cruise_ms[d] = 0;
+        m->cal_early[d]++;
+        delta = -CAL_EARLY_BACKOFF_MS;
+    } else {
+        int32_t cruise = (int32_t)(now - m->cal_cruise_start);
+        m->cal_last_cruise_ms[d] = (uint16_t)cruise;
+        delta = (cruise - (int32_t)g_param.cal_cruise_ms) / (1 << CAL_GAIN_SHIFT);
+        if (delta > CAL_STEP_MAX_MS)  delta = CAL_STEP_MAX_MS;
+        if (delta < -CAL_STEP_MAX_MS) delta = -CAL_STEP_MAX_MS;
+    }
+
+    full += delta;
+    if (full < (int32_t)CAL_FULL_MIN_MS) full = CAL_FULL_MIN_MS;
+    if (full > (int32_t)CAL_FULL_MAX_MS) full = CAL_FULL_MAX_MS;
+    m->cal_full_ms[d] = (uint16_t)full;
+}
+
+// ------------ limit sw : 상태 기록 / 엔드스탑 브레이크 (core1, tick 또는 엔드스탑 IRQ) ------------
+// limit stop logic (m->up_status, m->up_stop, m->down_stop), 디바운스 상태 기준
+static void motor_limit_status(mnq_target_t *m) {
+    int top_sw   = (g_limit_db.state >> m->pins->limit_top) & 1u;   // 눌리면 low
+    int under_sw = (g_limit_db.state >> m->pins->limit_under) & 1u; // 눌리면 low
 
-    // limit stop logic (up_status, up_stop, down_stop)
     if (top_sw == 0) {
         // top limit, 내려갈 때 stop
-        if (up_stop == false && down_stop == true) {
-            up_status = true;  // 올라가있음
+        if (m->up_stop == false && m->down_stop == true) {
+            m->up_status = true;  // 올라가있음
             //motor_set_level(0);
-            up_stop = true;
-            down_stop = false;
+            m->up_stop = true;
+            m->down_stop = false;
         }
     } else if (under_sw == 0) {
         // under limit, 올라갈 때 stop
-        if (up_stop == true && down_stop == false) {
-            up_status = false; // 내려가있음
+        if (m->up_stop == true && m->down_stop == false) {
+            m->up_status = false; // 내려가있음
             //motor_set_level(0);
-            up_stop = false;
-            down_stop = true;
+            m->up_stop = false;
+            m->down_stop = true;
         }
     }
+}
 
-    // motor state
-    switch (g_motor_state) {
-        case MOTOR_IDLE:
-            // 아무것도 안 함
+static void brake_lat_record(uint by, uint64_t edge_us) {
+    if (edge_us == 0) return;
+    uint32_t lat = (uint32_t)(time_us_64() - edge_us);
+    brake_lat_t *b = &g_brake_lat[by];
+    if (b->n == 0 || lat < b->min_us) b->min_us = lat;
+    if (lat > b->max_us) b->max_us = lat;
+    b->sum_us += lat;
+    b->n++;
+}
+
+// 가는 방향 끝 도착 (엔드스탑 / 전류 stall) → 브레이크 (ramp 재생 중이면 지금 레벨에서), 이번에 시작했으면 true
+// cruise 전(accel/full/settle)에 도착 → 풀파워가 너무 김 (학습값 감소), re-home 중이면 recovered
+// 걸림 뒤 다시 시작한 스트로크는 중간부터라 학습 안 함
+static bool motor_arrive(mnq_target_t *m, uint32_t now) {
+    uint d = m->motor_dir_down ? 1u : 0u;
+
+    switch (m->motor_state) {
+        case MOTOR_RAMP_UP:
+        case MOTOR_FULL:
+        case MOTOR_RAMP_CRUISE:
+            if (m->cur_retry == 0) cal_stroke_done(m, now, true);
             break;
 
-        case MOTOR_RAMP_UP: {
-            uint32_t elapsed = now - g_motor_state_start_ms;
-            uint32_t target = PWM_RAMP_UP_STEP * elapsed;
-            if (target > PWM_MAX_LEVEL) target = PWM_MAX_LEVEL;
-            motor_set_level((uint16_t)target);
-            if (g_motor_level >= PWM_MAX_LEVEL) {
-                g_motor_state = MOTOR_FULL;
-                g_motor_state_start_ms = now;
-            }
+        case MOTOR_CRUISE:
+            if (m->cur_retry == 0) cal_stroke_done(m, now, false);
+            break;
+
+        case MOTOR_FAULT_REHOME:
+            // 엔드스탑 확인 → 정상 정지 (학습값은 그대로)
+            m->fault_recovered[d]++;
             break;
+
+        default:
+            return false;
+    }
+
+    motor_enter(m, MOTOR_RAMP_STOP, now);
+    return true;
+}
+
+// 가는 방향 엔드스탑이 눌려 있으면 브레이크, 엣지 → 브레이크 지연 기록
+static bool motor_endstop(mnq_target_t *m, uint32_t now, uint by) {
+    uint d = m->motor_dir_down ? 1u : 0u;
+    uint pin = d ? m->pins->limit_top : m->pins->limit_under;
+    if ((g_limit_db.state >> pin) & 1u) return false;
+    if (!motor_arrive(m, now)) return false;
+
+    brake_lat_record(by, m->limit_edge_us[d]);
+    m->limit_edge_us[d] = 0;
+    return true;
+}
+
+// 눌림 확인 (core1 alarm, 하강엣지 CONFIRM_US 뒤) : user_data = target × 2 + [0 = under, 1 = top]
+static int64_t limit_confirm_cb(alarm_id_t id, void *user_data) {
+    (void)id;
+    uint idx = (uint)(uintptr_t)user_data;
+    mnq_target_t *m = &g_mnq[idx >> 1];
+    uint e = idx & 1u;
+    uint pin = e ? m->pins->limit_top : m->pins->limit_under;
+
+    m->limit_alarm[e] = 0;
+    if (!gpio_get(pin)) {
+        // 눌림 확정 : 디바운스 상태도 바로 눌림으로 (tick 카운트는 처음부터)
+        uint32_t bit = 1u << pin;
+        g_limit_db.state &= ~bit;
+        vcount_clear(&g_limit_db.cnt, bit);
+        motor_limit_status(m);
+        motor_endstop(m, g_motor_tick, BRAKE_BY_IRQ);
+    } else {
+        g_limit_glitch++;
+        m->limit_edge_us[e] = 0;
+    }
+
+    gpio_set_irq_enabled(pin, GPIO_IRQ_EDGE_FALL, true);
+    return 0;
+}
+
+// 리밋 스위치 하강엣지 (core1 GPIO IRQ) : 엣지 시각 기록, 확인 끝날 때까지 그 핀 IRQ 끔 (채터링 동안 IRQ 1번)
+// trace 기록 중이면 리밋 핀 양 엣지도 여기서 기록, 채터링도 남기도록 확인 중에 IRQ를 끄지 않음
+static void limit_irq_callback(uint gpio, uint32_t events) {
+    uint64_t t_us = time_us_64();
+    gpio_trace_irq(gpio, events, t_us);
+    if (LIMIT_IRQ_CONFIRM_US == 0 || !(events & GPIO_IRQ_EDGE_FALL)) return;
+
+    for (uint t = 0; t < MNQ_TARGET_COUNT; t++) {
+        mnq_target_t *m = &g_mnq[t];
+        for (uint e = 0; e < 2u; e++) {
+            uint pin = e ? m->pins->limit_top : m->pins->limit_under;
+            if (pin != gpio || m->limit_alarm[e] != 0) continue;
+
+            if (m->limit_edge_us[e] == 0) m->limit_edge_us[e] = t_us;
+            if (!gpio_trace_active()) gpio_set_irq_enabled(pin, GPIO_IRQ_EDGE_FALL, false);
+            m->limit_alarm[e] = alarm_pool_add_alarm_in_us(g_core1_pool, LIMIT_IRQ_CONFIRM_US, limit_confirm_cb,
+                                                           (void *)(uintptr_t)(t * 2u + e), true);
+            if (m->limit_alarm[e] <= 0) {
+                // alarm 슬롯 없음 → tick 디바운스에 맡김
+                m->limit_alarm[e] = 0;
+                gpio_set_irq_enabled(pin, GPIO_IRQ_EDGE_FALL, true);
+            }
         }
+    }
+}
 
-        case MOTOR_FULL: {
-            uint32_t elapsed = now - g_motor_state_start_ms;
-            uint32_t full_ms = g_motor_dir_down ? FULL_POWER_MS_DOWN : FULL_POWER_MS_UP;
-            if (elapsed >= full_ms) {
-                g_motor_state = MOTOR_RAMP_CRUISE;
-                g_motor_state_start_ms = now;
-            } else {
-                motor_set_level(PWM_MAX_LEVEL);
+// trace 채널 리밋 핀 양 엣지 IRQ (core1 tick, g_trace_req)
+static void limit_trace_enable(void) {
+    gpio_set_irq_enabled_with_callback(LIMIT_SW_TOP, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true, &limit_irq_callback);
+    gpio_set_irq_enabled_with_callback(LIMIT_SW_UNDER, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true, &limit_irq_callback);
+}
+
+// ------------ 전류 감지 : stall 판정 처리 (core1 tick) ------------
+// 예상 이동 시간의 CURRENT_END_PCT% 뒤(re-home 중이면 언제든) → 끝 도착, 그 전 → 걸림
+static void motor_current_event(mnq_target_t *m, uint32_t now) {
+    uint d = m->motor_dir_down ? 1u : 0u;
+    bool late = m->cur_retry == 0 &&
+                (now - m->cal_stroke_start) * 100u >= travel_expect_ms(m, m->motor_dir_down) * CURRENT_END_PCT;
+
+    if (m->motor_state == MOTOR_FAULT_REHOME || late) {
+        if (motor_arrive(m, now)) m->cur_end[d]++;
+        return;
+    }
+
+    m->cur_jam_n[d]++;
+    if (m->cur_retry >= CURRENT_JAM_RETRY) {
+        // 다시 시작을 다 씀 → 그 자리에서 정지 (도착으로 알림, target은 계속 운용)
+        m->cur_jam_abort[d]++;
+        motor_enter(m, MOTOR_RAMP_STOP, now);
+        return;
+    }
+    m->cur_jam = true;
+    motor_enter(m, MOTOR_FAULT_BRAKE, now);
+}
+
+// 새 ADC 샘플 (round robin, 변환 k의 입력 = k % 입력 수 = target)을 target별 검출기에
+static void motor_current_poll(uint32_t now) {
+    const uint16_t *s;
+    uint64_t idx;
+    uint32_t n;
+    uint inputs = adc_sampler_inputs();
+
+    while ((n = adc_sampler_read(&s, &idx)) > 0) {
+        for (uint t = 0; t < MNQ_TARGET_COUNT; t++) {
+            mnq_target_t *m = &g_mnq[t];
+            if (!m->cur.armed) continue;
+
+            // 이 block에서 입력 t의 첫 샘플
+            uint32_t k0 = (uint32_t)((t + inputs - idx % inputs) % inputs);
+            if (k0 >= n) continue;
+            csense_event_t ev;
+            if (csense_feed(&m->cur, s + k0, (n - k0 + inputs - 1u) / inputs, inputs, (idx + k0) / inputs, &ev)) {
+                motor_current_event(m, now);
             }
-            break;
         }
+    }
+}
+
+// ------------ motor update (비차단, 주기적으로 호출) ------------
+static void motor_update(mnq_target_t *m, uint32_t now) {
+    // limit sw 상태 (tick 디바운스 값, 엔드스탑 IRQ가 먼저 확정했으면 이미 반영됨)
+    motor_limit_status(m);
+
+    // 가는 방향 엔드스탑 → 브레이크 (엔드스탑 IRQ가 이미 브레이크를 시작했으면 아무것도 안 함)
+    motor_endstop(m, now, BRAKE_BY_TICK);
+
+    uint32_t elapsed = now - m->motor_state_start_ms;
+
+    // travel watchdog : 제한 시간 안에 엔드스탑이 안 눌림 → 복구 시퀀스 (브레이크부터)
+    uint d = m->motor_dir_down ? 1u : 0u;
+    bool driving = m->motor_state == MOTOR_RAMP_UP || m->motor_state == MOTOR_FULL ||
+                   m->motor_state == MOTOR_RAMP_CRUISE || m->motor_state == MOTOR_CRUISE;
+    if (driving && now - m->cal_stroke_start >= m->travel_timeout_ms) {
+        m->fault_timeout[d]++;
+        motor_enter(m, MOTOR_FAULT_BRAKE, now);
+        elapsed = 0;
+    }
+
+    switch (m->motor_state) {
+        case MOTOR_IDLE:
+            // 아무것도 안 함
+            break;
+
+        case MOTOR_RAMP_UP:
+        case MOTOR_RAMP_CRUISE:
+        case MOTOR_RAMP_STOP:
+        case MOTOR_FAULT_BRAKE:
+            motor_ramp_tick(m, now);
+            break;
 
-        case MOTOR_RAMP_CRUISE: {
-            uint32_t elapsed = now - g_motor_state_start_ms;
-            int32_t level = (int32_t)PWM_MAX_LEVEL - (int32_t)elapsed * (int32_t)PWM_RAMP_DOWN_STEP;
-            if (level < (int32_t)PWM_LOW_LEVEL) level = PWM_LOW_LEVEL;
-            motor_set_level((uint16_t)level);
-            if (g_motor_level <= PWM_LOW_LEVEL) {
-                g_motor_state = MOTOR_CRUISE;
+        case MOTOR_FULL:
+            if (elapsed >= m->cal_full_ms[m->motor_dir_down ? 1 : 0]) {
+                motor_enter(m, MOTOR_RAMP_CRUISE, now);
             }
             break;
-        }
 
-        case MOTOR_CRUISE: {
-            motor_set_level(PWM_LOW_LEVEL);
-            // 엔드스탑 스위치 감지되면 브레이크 단계로
-            if (g_motor_dir_down) {
-                // 내려가는 중 → LIMIT_SW_TOP이 눌리면 (0)
-                if (top_sw == 0) {
-                    g_motor_state = MOTOR_RAMP_STOP;
-                    g_motor_state_start_ms = now;
-                }
+        case MOTOR_CRUISE:
+            // 엔드스탑은 위 motor_endstop에서
+            motor_set_level(m, motor_cruise_level(m));
+            break;
+
+        case MOTOR_FAULT_PROBE: {
+            uint start_pin = m->motor_dir_down ? m->pins->limit_under : m->pins->limit_top;
+            bool at_start = ((g_limit_db.state >> start_pin) & 1u) == 0;
+            if ((elapsed >= FAULT_PROBE_MS || at_start) && m->cur_jam) {
+                // 걸림에서 물러남 → 스트로크 처음(accel)부터 다시
+                uint8_t retry = (uint8_t)(m->cur_retry + 1u);
+                motor_start_move(m, m->motor_dir_down, now);
+                m->cur_retry = retry;
+            } else if (elapsed >= FAULT_PROBE_MS || at_start) {
+                motor_set_level(m, 0);
+                motor_enter(m, MOTOR_FAULT_REHOME, now);
+                gpio_put(m->pins->dir, m->motor_dir_down ? 1 : 0);
             } else {
-                // 올라가는 중 → LIMIT_SW_UNDER가 눌리면 (0)
-                if (under_sw == 0) {
-                    g_motor_state = MOTOR_RAMP_STOP;
-                    g_motor_state_start_ms = now;
-                }
+                motor_set_level(m, motor_cruise_level(m));
             }
             break;
         }
 
-        case MOTOR_RAMP_STOP: {
-            uint32_t elapsed = now - g_motor_state_start_ms;
-            int32_t level_start = (int32_t)PWM_LOW_LEVEL;
-            int32_t level = level_start - (int32_t)elapsed * (int32_t)PWM_BRAKE_STEP;
-            if (level <= 0) {
-                motor_set_level(0);
-                g_motor_state = MOTOR_IDLE;
-                g_motor_just_stopped = true;
-            } else {
-                motor_set_level((uint16_t)level);
+        case MOTOR_FAULT_REHOME:
+            // 엔드스탑이 눌리면 위 motor_endstop에서 정상 정지
+            if (elapsed >= FAULT_REHOME_MS) {
+                // 스위치가 끝까지 안 눌림 → 끝에 닿은 것으로 보고 정지 (target은 계속 운용)
+                m->fault_blind[d]++;
+                motor_enter(m, MOTOR_IDLE, now);
+                m->motor_just_stopped = true;
+                motor_set_level(m, 0);
+            } else if (elapsed >= FAULT_PAUSE_MS) {
+                motor_set_level(m, motor_cruise_level(m));
             }
             break;
-        }
 
         default:
-            g_motor_state = MOTOR_IDLE;
-            motor_set_level(0);
+            motor_enter(m, MOTOR_IDLE, now);
+            motor_set_level(m, 0);
             break;
     }
 }
 
-// ------------ HIT out (현재 사용 X 기능만) ------------
-static void hits_clear(void) {
-    hit1_on = hit2_on = hit3_on = false;
-    gpio_put(HIT_1, 0);
-    gpio_put(HIT_2, 0);
-    gpio_put(HIT_3, 0);
-}
-
 //  ------------ body shot, head shot 시의 동작은 추후 사용을 위해 주석 형태로 남겨둠 ------------
 /*
+static bool hit1_on = false;
+static bool hit2_on = false;
+static bool hit3_on = false;
+
 static void on_body_shot_once(void) {
     // 3-1) 몸통샷 한 번이면 HIT_1 high
     hit1_on = true;
@@ -328,60 +1156,89 @@ static void on_head_shot(void) {
 }
 */
 
-// MNQ가 내려갈 때 HIT 전부 초기화 (3-4)
-/*
-static void on_mnq_down_reset_hits(void) {
-    hits_clear();
+// ------------ target 상태 / 핀 lookup 초기화 ------------
+static void mnq_init(void) {
+    for (uint i = 0; i < 32; i++) {
+        g_pin_target[i] = PIN_NONE;
+        g_pin_role[i] = PIN_ROLE_BODY;
+    }
+    g_limit_mask = 0;
+
+    for (uint t = 0; t < MNQ_TARGET_COUNT; t++) {
+        mnq_target_t *m = &g_mnq[t];
+        const mnq_pins_t *pins = &g_mnq_pins[t];
+
+        m->pins = pins;
+        m->phase = PHASE_READY_UP;
+        m->motor_state = MOTOR_IDLE;
+        m->profile = &MOTION_PROFILE_UP;
+        m->ramp_out = -1;
+        m->ramp_dma = false;
+        m->up_stop = true;
+        m->down_stop = false;
+        m->up_status = true;
+
+        g_pin_target[pins->detect_head] = (uint8_t)t;
+        g_pin_role[pins->detect_head] = PIN_ROLE_HEAD;
+        for (uint b = 0; b < 2; b++) {
+            g_pin_target[pins->detect_body[b]] = (uint8_t)t;
+            g_pin_role[pins->detect_body[b]] = PIN_ROLE_BODY;
+        }
+        g_limit_mask |= (1u << pins->limit_top) | (1u << pins->limit_under);
+    }
 }
-*/
 
 // ------------ GPIO set ------------
+static void detect_pin_setup(uint pin) {
+    gpio_init(pin);
+    gpio_set_dir(pin, GPIO_IN);
+    gpio_pull_down(pin);
+    gpio_set_irq_enabled_with_callback(pin, GPIO_IRQ_EDGE_RISE, true, &gpio_irq_callback);
+    irq_guard_add_pin(pin, GPIO_IRQ_EDGE_RISE);
+}
+
+static void limit_pin_setup(uint pin) {
+    gpio_init(pin);
+    gpio_set_dir(pin, GPIO_IN);
+    gpio_pull_up(pin);
+}
+
 static void gpio_setup(void) {
     // LED
     gpio_init(LED);
     gpio_set_dir(LED, GPIO_OUT);
 
-    gpio_init(DETECT_1);
-    gpio_set_dir(DETECT_1, GPIO_IN);
-    gpio_pull_down(DETECT_1);
-    gpio_set_irq_enabled_with_callback(DETECT_1, GPIO_IRQ_EDGE_RISE, true, &gpio_irq_callback);
-
-    gpio_init(DETECT_2);
-    gpio_set_dir(DETECT_2, GPIO_IN);
-    gpio_pull_down(DETECT_2);
-    gpio_set_irq_enabled(DETECT_2, GPIO_IRQ_EDGE_RISE, true);
-
-    gpio_init(DETECT_3);
-    gpio_set_dir(DETECT_3, GPIO_IN);
-    gpio_pull_down(DETECT_3);
-    gpio_set_irq_enabled(DETECT_3, GPIO_IRQ_EDGE_RISE, true);
+    float div = (float)PICO_SYS_CLK / ((255 + 1.0f) * MNQ_PWM_FREQ_HZ);
+    if (div < 1.0f)   div = 1.0f;
+    if (div > 255.0f) div = 255.0f;
 
-    gpio_init(MNQ_DIR);
-    gpio_set_dir(MNQ_DIR, GPIO_OUT);
-    gpio_put(MNQ_DIR, 0);
+    irq_guard_init(DETECT_IRQ_HOLDOFF_US);
 
-    // PWM SET
-    gpio_set_function(MNQ_PWM_PIN, GPIO_FUNC_PWM);
-    slice_num = pwm_gpio_to_slice_num(MNQ_PWM_PIN);
+    for (uint t = 0; t < MNQ_TARGET_COUNT; t++) {
+        mnq_target_t *m = &g_mnq[t];
+        const mnq_pins_t *pins = m->pins;
 
-    pwm_set_wrap(slice_num, 255);
+        detect_pin_setup(pins->detect_body[0]);
+        detect_pin_setup(pins->detect_head);
+        detect_pin_setup(pins->detect_body[1]);
 
-    float div = (float)PICO_SYS_CLK / ((255 + 1.0f) * MNQ_PWM_FREQ_HZ);
-    if (div < 1.0f)   div = 1.0f;
-    if (div > 255.0f) div = 255.0f;
+        gpio_init(pins->dir);
+        gpio_set_dir(pins->dir, GPIO_OUT);
+        gpio_put(pins->dir, 0);
 
-    pwm_set_clkdiv(slice_num, div);
+        // PWM SET (target마다 다른 slice)
+        gpio_set_function(pins->pwm, GPIO_FUNC_PWM);
+        m->slice_num = pwm_gpio_to_slice_num(pins->pwm);
 
-    pwm_set_gpio_level(MNQ_PWM_PIN, 0);
-    pwm_set_enabled(slice_num, true);
+        pwm_set_wrap(m->slice_num, 255);
+        pwm_set_clkdiv(m->slice_num, div);
 
-    gpio_init(LIMIT_SW_UNDER);
-    gpio_set_dir(LIMIT_SW_UNDER, GPIO_IN);
-    gpio_pull_up(LIMIT_SW_UNDER);
+        pwm_set_gpio_level(pins->pwm, 0);
+        pwm_set_enabled(m->slice_num, true);
 
-    gpio_init(LIMIT_SW_TOP);
-    gpio_set_dir(LIMIT_SW_TOP, GPIO_IN);
-    gpio_pull_up(LIMIT_SW_TOP);
+        limit_pin_setup(pins->limit_under);
+        limit_pin_setup(pins->limit_top);
+    }
 
     // HIT output
     gpio_init(HIT_1);
@@ -395,105 +1252,268 @@ static void gpio_setup(void) {
     gpio_init(HIT_3);
     gpio_set_dir(HIT_3, GPIO_OUT);
     gpio_put(HIT_3, 0);
+
+    // GPIO trace 채널 (target 0) : 0~2 = DETECT_1/2/3, 3 = LIMIT_SW_TOP, 4 = LIMIT_SW_UNDER
+    // 리밋 핀은 core1 limit_irq_callback이 기록 (core0는 이 핀 IRQ를 안 켬)
+    static const uint trace_pins[] = { DETECT_1, DETECT_2, DETECT_3, LIMIT_SW_TOP, LIMIT_SW_UNDER };
+    gpio_trace_init(trace_pins, sizeof(trace_pins) / sizeof(trace_pins[0]));
+    gpio_trace_set_remote(LIMIT_SW_TOP);
+    gpio_trace_set_remote(LIMIT_SW_UNDER);
 }
 
-// ------------ detect input / MNQ state ------------
-static void mnq_state_update(uint32_t now) {
-    // MNQ가 올라가 있으면 LED HIGH, 내려가 있으면 LOW
-    // phase 기준 단순 처리
-    if (g_phase == PHASE_READY_UP || g_phase == PHASE_HOLD_UP || g_phase == PHASE_MOVING_DOWN) {
-        gpio_put(LED, 1);
+// ------------ 파라미터 + travel calibration : flash 저장/복원 (core0) ------------
+static bool cal_full_valid(uint32_t full_ms) {
+    return full_ms >= CAL_FULL_MIN_MS && full_ms <= CAL_FULL_MAX_MS;
+}
+
+static void param_load(void) {
+    // 저장값 없음 → profile 기본값
+    for (uint t = 0; t < MNQ_TARGET_COUNT; t++) {
+        g_cal_saved[t][0] = MOTION_PROFILE_UP.full_ticks;
+        g_cal_saved[t][1] = MOTION_PROFILE_DOWN.full_ticks;
+    }
+    param_store_init(&g_param_store, PARAM_STORE_FLASH_OFFSET, g_param_desc, g_param.v,
+                     sizeof(g_param_desc) / sizeof(g_param_desc[0]), g_cal_saved, sizeof(g_cal_saved));
+    param_store_load(&g_param_store);
+
+    for (uint t = 0; t < MNQ_TARGET_COUNT; t++) {
+        if (!cal_full_valid(g_cal_saved[t][0])) g_cal_saved[t][0] = MOTION_PROFILE_UP.full_ticks;
+        if (!cal_full_valid(g_cal_saved[t][1])) g_cal_saved[t][1] = MOTION_PROFILE_DOWN.full_ticks;
+        g_mnq[t].cal_full_ms[0] = g_cal_saved[t][0];
+        g_mnq[t].cal_full_ms[1] = g_cal_saved[t][1];
+    }
+}
+
+// 학습값만 갱신 (파라미터는 저장된 값 그대로, p save 전의 RAM 변경은 저장 안 함)
+static void cal_save_if_changed(void) {
+    bool changed = (g_param_store.slot < 0);
+    for (uint t = 0; t < MNQ_TARGET_COUNT; t++) {
+        for (int d = 0; d < 2; d++) {
+            uint32_t now_v = g_mnq[t].cal_full_ms[d], saved = g_cal_saved[t][d];
+            uint32_t diff = now_v > saved ? now_v - saved : saved - now_v;
+            if (diff >= CAL_SAVE_DELTA_MS) changed = true;
+        }
+    }
+    if (!changed) return;
+
+    uint16_t prev[MNQ_TARGET_COUNT][2];
+    for (uint t = 0; t < MNQ_TARGET_COUNT; t++) {
+        for (int d = 0; d < 2; d++) {
+            prev[t][d] = g_cal_saved[t][d];
+            g_cal_saved[t][d] = g_mnq[t].cal_full_ms[d];
+        }
+    }
+
+    // 빈 page 슬롯에 기록, sector erase는 슬롯이 다 찼을 때만 (호출 쪽에서 모든 모터가 정지일 때만 부름)
+    if (param_store_save(&g_param_store, false)) {
+        g_cal_save_count++;
     } else {
-        gpio_put(LED, 0);
+        for (uint t = 0; t < MNQ_TARGET_COUNT; t++) {
+            g_cal_saved[t][0] = prev[t][0];
+            g_cal_saved[t][1] = prev[t][1];
+        }
     }
+}
 
-    // 모터가 막 멈췄을 경우 처리
-    if (g_motor_just_stopped) {
-        g_motor_just_stopped = false;
+static void cal_print(void) {
+    for (uint t = 0; t < MNQ_TARGET_COUNT; t++) {
+        const mnq_target_t *m = &g_mnq[t];
+        if (MNQ_TARGET_COUNT > 1) printf("[%u] ", t);
+        printf("cal: full down=%u up=%u ms, last travel down=%u up=%u ms, cruise down=%u up=%u ms, early down=%lu up=%lu, saved %lu\n",
+               m->cal_full_ms[1], m->cal_full_ms[0],
+               m->cal_last_travel_ms[1], m->cal_last_travel_ms[0],
+               m->cal_last_cruise_ms[1], m->cal_last_cruise_ms[0],
+               (unsigned long)m->cal_early[1], (unsigned long)m->cal_early[0],
+               (unsigned long)g_cal_save_count);
+    }
+}
 
-        if (g_phase == PHASE_MOVING_DOWN) {
-            // 다 내려갔을 시 3초 대기
-            g_phase = PHASE_HOLD_DOWN;
-            g_phase_deadline_ms = now + HOLD_DOWN_MS;
+static void fault_print(void) {
+    for (uint t = 0; t < MNQ_TARGET_COUNT; t++) {
+        const mnq_target_t *m = &g_mnq[t];
+        if (MNQ_TARGET_COUNT > 1) printf("[%u] ", t);
+        printf("fault: timeout down=%lu up=%lu, recovered down=%lu up=%lu, blind down=%lu up=%lu\n",
+               (unsigned long)m->fault_timeout[1], (unsigned long)m->fault_timeout[0],
+               (unsigned long)m->fault_recovered[1], (unsigned long)m->fault_recovered[0],
+               (unsigned long)m->fault_blind[1], (unsigned long)m->fault_blind[0]);
+    }
+}
 
-            // 내려갈 때 모든 HIT LOW 초기화
-            // hits_clear();
-            body_shot_count = 0;
-        } else if (g_phase == PHASE_MOVING_UP) {
-            // 다 올라왔을 시 1초 대기
-            g_phase = PHASE_HOLD_UP;
-            g_phase_deadline_ms = now + HOLD_UP_MS;
+static void endstop_print(void) {
+    if (LIMIT_IRQ_CONFIRM_US == 0) {
+        printf("endstop: irq off (tick debounce %u ms)\n", LIMIT_DEBOUNCE_TICKS);
+        return;
+    }
+    printf("endstop: confirm=%luus glitch=%lu\n", (unsigned long)LIMIT_IRQ_CONFIRM_US, (unsigned long)g_limit_glitch);
+    static const char *const by_name[2] = { "tick", "irq" };
+    for (uint by = 0; by < 2u; by++) {
+        brake_lat_t b = g_brake_lat[by];
+        if (b.n == 0) {
+            printf("  brake by %s: n=0\n", by_name[by]);
+            continue;
+        }
+        printf("  brake by %s: n=%lu switch->brake min=%lu max=%lu mean=%lu us\n", by_name[by],
+               (unsigned long)b.n, (unsigned long)b.min_us, (unsigned long)b.max_us,
+               (unsigned long)(b.sum_us / b.n));
+    }
+}
+
+static void current_print(void) {
+    if (!MOTOR_CURRENT_SENSE) return;
+    if (!g_current_on) {
+        printf("current: off (no adc dma channel)\n");
+        return;
+    }
+    for (uint t = 0; t < MNQ_TARGET_COUNT; t++) {
+        const mnq_target_t *m = &g_mnq[t];
+        if (MNQ_TARGET_COUNT > 1) printf("[%u] ", t);
+        printf("current: peak down=%u up=%u (max %u/%u), stall end down=%lu up=%lu, jam down=%lu up=%lu, abort down=%lu up=%lu\n",
+               m->cur_peak_last[1], m->cur_peak_last[0], m->cur_peak_max[1], m->cur_peak_max[0],
+               (unsigned long)m->cur_end[1], (unsigned long)m->cur_end[0],
+               (unsigned long)m->cur_jam_n[1], (unsigned long)m->cur_jam_n[0],
+               (unsigned long)m->cur_jam_abort[1], (unsigned long)m->cur_jam_abort[0]);
+    }
+    adc_sampler_dump();
+}
+
+// ------------ detect input / MNQ state ------------
+// core1 명령 queue (자리가 날 때까지 대기, core1은 바로 꺼내서 tick으로 넘김)
+static void mnq_send_cmd(uint t, uint32_t code) {
+    uint32_t msg = MNQ_MSG(t, code);
+    queue_add_blocking(&g_motor_cmd_q, &msg);
+}
+
+static void mnq_send_down(uint t, uint64_t trigger_us) {
+    mnq_target_t *m = &g_mnq[t];
+    m->down_trigger_us = trigger_us;
+    mnq_send_cmd(t, MOTOR_CMD_DOWN);    // 내려가기
+    m->phase = PHASE_MOVING_DOWN;
+}
+
+// 탄 감지 엣지 1개 (해당 target이 READY_UP일 때만)
+static void mnq_on_edge(const edge_event_t *e) {
+    uint t = g_pin_target[e->pin];
+    mnq_target_t *m = &g_mnq[t];
+    if (m->phase != PHASE_READY_UP) return;
+
+    if (g_pin_role[e->pin] == PIN_ROLE_HEAD) {
+        // head shot = DETECT_2 상승엣지 한 번으로 바로 내려가기
+        m->body_shot_count = 0;
+
+        // on_head_shot();  // HIT_3 high
+        mnq_send_down(t, e->t_us);
+    } else {
+        // body shot (DETECT_1 or DETECT_3)
+        m->body_shot_count++;
+
+        if (m->body_shot_count == 1) {
+            // body shot 1회 : 아직 내려가진 않음
+            // on_body_shot_once();   // HIT_1 high
+        } else {
+            // body shot 2회 : 내려가기
+            // on_body_shot_twice();  // HIT_2 high
+            mnq_send_down(t, e->t_us);
         }
     }
+}
+
+static void mnq_phase_update(uint t, uint32_t now) {
+    mnq_target_t *m = &g_mnq[t];
 
-    switch (g_phase) {
+    switch (m->phase) {
         case PHASE_READY_UP:
-            // 이 상태에서만 탄 감지 사용
-            if (detect2_rise) {
-                // head shot = DETECT_2 상승엣지 한 번으로 바로 내려가기
-                detect2_rise = false;
-                body_shot_count = 0;
-
-                // on_head_shot();  // HIT_3 high
-                motor_start_move(true, now);  // 내려가기
-                g_phase = PHASE_MOVING_DOWN;
-            } else if (detect1_rise || detect3_rise) {
-                // body shot
-                bool trig1 = detect1_rise;
-                bool trig3 = detect3_rise;
-                detect1_rise = false;
-                detect3_rise = false;
-
-                body_shot_count++;
-
-                if (body_shot_count == 1) {
-                    // body shot 1회 : 아직 내려가진 않음
-                    // on_body_shot_once();   // HIT_1 high
-                } else {
-                    // body shot 2회 : 내려가기
-                    // on_body_shot_twice();  // HIT_2 high
-                    motor_start_move(true, now);  // 내려가기
-                    g_phase = PHASE_MOVING_DOWN;
-                }
-                (void)trig1;
-                (void)trig3;
-            }
+            // 이 상태에서만 탄 감지 사용 (mnq_on_edge)
             break;
 
         case PHASE_MOVING_DOWN:
-            // 모터_update에서 엔드스탑 감지 후 정지 → 상단의 g_motor_just_stopped 처리에서 PHASE_HOLD_DOWN으로 전환됨
+            // core1 모터_update에서 엔드스탑 감지 후 정지 → MOTOR_EVT_AT_BOTTOM 처리에서 PHASE_HOLD_DOWN으로 전환됨
             break;
 
         case PHASE_HOLD_DOWN:
             // 내려간 상태에서 3초 대기, 신호 무시
-            if ((int32_t)(g_phase_deadline_ms - now) <= 0) {
+            if ((int32_t)(m->phase_deadline_ms - now) <= 0) {
                 // 3초 후 자동으로 다시 올라가기 시작
-                motor_start_move(false, now); // 올라가기
-                g_phase = PHASE_MOVING_UP;
+                mnq_send_cmd(t, MOTOR_CMD_UP);  // 올라가기
+                m->phase = PHASE_MOVING_UP;
             }
             break;
 
         case PHASE_MOVING_UP:
-            // 모터_update에서 엔드스탑 감지 후 정지 → 상단 처리에서 PHASE_HOLD_UP 으로 전환
+            // core1 모터_update에서 엔드스탑 감지 후 정지 → MOTOR_EVT_AT_TOP 처리에서 PHASE_HOLD_UP 으로 전환
             break;
 
         case PHASE_HOLD_UP:
             // 올라온 뒤 1초 대기 후 다시 READY_UP (신호 수신 재개)
-            if ((int32_t)(g_phase_deadline_ms - now) <= 0) {
-                g_phase = PHASE_READY_UP;
-                body_shot_count = 0;
+            if ((int32_t)(m->phase_deadline_ms - now) <= 0) {
+                m->phase = PHASE_READY_UP;
+                m->body_shot_count = 0;
             }
             break;
 
         default:
-            g_phase = PHASE_READY_UP;
+            m->phase = PHASE_READY_UP;
             break;
     }
+}
+
+static bool mnq_any_moving(void) {
+    for (uint t = 0; t < MNQ_TARGET_COUNT; t++) {
+        if (g_mnq[t].phase == PHASE_MOVING_DOWN || g_mnq[t].phase == PHASE_MOVING_UP) return true;
+    }
+    return false;
+}
+
+static void mnq_state_update(uint32_t now) {
+    // 모든 MNQ가 올라가 있으면 LED HIGH, 하나라도 내려가 있으면 LOW
+    // phase 기준 단순 처리
+    bool all_up = true;
+    for (uint t = 0; t < MNQ_TARGET_COUNT; t++) {
+        mnq_phase_t ph = g_mnq[t].phase;
+        if (!(ph == PHASE_READY_UP || ph == PHASE_HOLD_UP || ph == PHASE_MOVING_DOWN)) all_up = false;
+    }
+    gpio_put(LED, all_up ? 1 : 0);
+
+    // core1에서 모터가 멈췄다고 알려온 경우 처리
+    uint32_t msg;
+    while (queue_try_remove(&g_motor_evt_q, &msg)) {
+        uint32_t t = MNQ_MSG_TARGET(msg);
+        uint32_t evt = MNQ_MSG_CODE(msg);
+        if (t >= MNQ_TARGET_COUNT) continue;
+        mnq_target_t *m = &g_mnq[t];
+
+        if (evt == MOTOR_EVT_AT_BOTTOM && m->phase == PHASE_MOVING_DOWN) {
+            // 다 내려갔을 시 3초 대기
+            m->phase = PHASE_HOLD_DOWN;
+            m->phase_deadline_ms = now + g_param.hold_down_ms;
+
+            // 학습값이 바뀌었으면 flash 기록 (아래에서 모든 모터가 멈췄을 때)
+            g_cal_pending = true;
+
+            m->body_shot_count = 0;
+        } else if (evt == MOTOR_EVT_AT_TOP && m->phase == PHASE_MOVING_UP) {
+            // 다 올라왔을 시 1초 대기
+            m->phase = PHASE_HOLD_UP;
+            m->phase_deadline_ms = now + g_param.hold_up_ms;
+        }
+    }
+
+    // flash 기록 동안 core1 tick이 멈추므로 움직이는 모터가 하나도 없을 때만 기록 (학습값, p save)
+    if ((g_cal_pending || param_store_save_pending(&g_param_store)) && !mnq_any_moving()) {
+        g_cal_pending = false;
+        cal_save_if_changed();
+        param_store_service(&g_param_store);
+    }
+
+    // 쌓인 엣지 이벤트를 한 번에 꺼냄 (READY_UP이 아닌 target의 엣지는 그대로 버려서 신호 무시)
+    edge_event_t ev[EDGE_DRAIN_BATCH];
+    uint32_t ev_n = edge_ring_drain(&g_edge_ring, ev, EDGE_DRAIN_BATCH);
+
+    for (uint32_t i = 0; i < ev_n; i++) {
+        if (ev[i].edge != GPIO_IRQ_EDGE_RISE) continue;
+        mnq_on_edge(&ev[i]);
+    }
 
-    // READY_UP 이외 상태에서는 DETECT_x 플래그를 그냥 비워서 신호 무시
-    if (g_phase != PHASE_READY_UP) {
-        detect1_rise = false;
-        detect2_rise = false;
-        detect3_rise = false;
+    for (uint t = 0; t < MNQ_TARGET_COUNT; t++) {
+        mnq_phase_update(t, now);
     }
 }
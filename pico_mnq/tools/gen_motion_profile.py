@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+# MNQ 모터 motion profile 테이블 생성기
+# - 구간(가속 / 감속 / 브레이크)마다 1 tick(1ms)당 PWM 레벨을 미리 계산해서 C 헤더로 출력
+# - 펌웨어는 tick마다 테이블 값 하나만 읽음 (계산 없음)
+# - jerk = 0.0 이면 직선 ramp (기존 사다리꼴), 1.0 이면 가속도가 삼각형인 S-curve
+#
+# 사용법:
+#   python3 tools/gen_motion_profile.py > motion_profile_table.h
+#   python3 tools/gen_motion_profile.py -o motion_profile_table.h
+
+import argparse
+import sys
+
+PWM_MAX_LEVEL = 255
+
+# 기존 사다리꼴 (참고용):
+#   accel  0 → 255, 51 tick (1ms에 5씩)
+#   full   DOWN 800 tick, UP 1200 tick
+#   settle 255 → 150, 105 tick (1ms에 1씩)
+#   brake  150 → 0, 50 tick (1ms에 3씩)
+#
+# S-curve로 시작/끝이 부드러워져 엔드스탑 진입 레벨(cruise)을 150 → 180으로 올림
+PROFILES = [
+    # name, peak, accel(ticks, jerk), full_ticks, cruise, settle(ticks, jerk), brake(ticks, jerk)
+    dict(name="down", peak=255, accel=(60, 1.0), full_ticks=800,
+         cruise=180, settle=(75, 1.0), brake=(50, 1.0)),
+    dict(name="up", peak=255, accel=(60, 1.0), full_ticks=1200,
+         cruise=180, settle=(75, 1.0), brake=(50, 1.0)),
+]
+
+# 가속도 적분 분할 수
+INTEGRATE_STEPS = 4096
+
+
+def s_curve(x, jerk):
+    """0..1 구간 진행률 (x: 0..1 시간)
+
+    가속도를 사다리꼴로 둠: 앞 jerk/2 동안 증가, 가운데 일정, 뒤 jerk/2 동안 감소
+    jerk = 0 이면 가속도 일정 → 직선
+    """
+    if jerk <= 0.0:
+        return x
+    tj = jerk / 2.0
+
+    def accel(t):
+        if t < tj:
+            return t / tj
+        if t > 1.0 - tj:
+            return (1.0 - t) / tj
+        return 1.0
+
+    # 사다리꼴 적분 (전체 면적으로 정규화)
+    n = INTEGRATE_STEPS
+    total = 0.0
+    part = 0.0
+    for i in range(n):
+        t = (i + 0.5) / n
+        a = accel(t)
+        total += a
+        if t < x:
+            part += a
+    return part / total
+
+
+def segment(start, end, ticks, jerk):
+    """start → end 까지 ticks 동안의 레벨, [k] = k+1 tick 뒤 레벨 (마지막 값 = end)"""
+    if ticks < 1:
+        raise ValueError("segment ticks must be >= 1")
+    out = []
+    for k in range(1, ticks + 1):
+        u = s_curve(k / ticks, jerk)
+        level = start + (end - start) * u
+        out.append(int(round(level)))
+    out[-1] = end
+    return out
+
+
+def c_array(name, values):
+    lines = ["static const uint8_t %s[%d] = {" % (name, len(values))]
+    for i in range(0, len(values), 16):
+        chunk = ", ".join("%3d" % v for v in values[i:i + 16])
+        lines.append("    %s," % chunk)
+    lines.append("};")
+    return lines
+
+
+def generate():
+    out = []
+    out.append("#ifndef MOTION_PROFILE_TABLE_H")
+    out.append("#define MOTION_PROFILE_TABLE_H")
+    out.append("")
+    out.append("// 자동 생성 파일: tools/gen_motion_profile.py 로 다시 만들 것 (직접 수정 금지)")
+    out.append("// [k] = 구간 시작 후 k+1 tick(ms) 뒤 PWM 레벨")
+    out.append("")
+    out.append('#include "motion_profile.h"')
+
+    for p in PROFILES:
+        peak = p["peak"]
+        cruise = p["cruise"]
+        if not (0 < cruise <= peak <= PWM_MAX_LEVEL):
+            raise ValueError("%s: need 0 < cruise <= peak <= %d" % (p["name"], PWM_MAX_LEVEL))
+
+        accel = segment(0, peak, *p["accel"])
+        settle = segment(peak, cruise, *p["settle"])
+        brake = segment(cruise, 0, *p["brake"])
+        n = p["name"]
+
+        out.append("")
+        out.append("// ------------ %s : 0 → %d (%d ms, jerk %.2f), %d 유지 %d ms, → %d (%d ms, jerk %.2f), 브레이크 %d ms (jerk %.2f) ------------"
+                   % (n, peak, p["accel"][0], p["accel"][1], peak, p["full_ticks"],
+                      cruise, p["settle"][0], p["settle"][1], p["brake"][0], p["brake"][1]))
+        out.extend(c_array("mp_%s_accel" % n, accel))
+        out.append("")
+        out.extend(c_array("mp_%s_settle" % n, settle))
+        out.append("")
+        out.extend(c_array("mp_%s_brake" % n, brake))
+        out.append("")
+        out.append("static const motion_profile_t MOTION_PROFILE_%s = {" % n.upper())
+        out.append("    .accel = mp_%s_accel,   .accel_len = %d," % (n, len(accel)))
+        out.append("    .full_ticks = %d," % p["full_ticks"])
+        out.append("    .settle = mp_%s_settle, .settle_len = %d," % (n, len(settle)))
+        out.append("    .cruise = %d," % cruise)
+        out.append("    .brake = mp_%s_brake,   .brake_len = %d," % (n, len(brake)))
+        out.append("};")
+
+    out.append("")
+    out.append("#endif")
+    return "\r\n".join(out)
+
+
+def main():
+    ap = argparse.ArgumentParser(description="MNQ motion profile table generator")
+    ap.add_argument("-o", "--output", help="output header (default: stdout)")
+    args = ap.parse_args()
+
+    text = generate()
+    if args.output:
+        with open(args.output, "w", newline="") as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,72 @@
+#ifndef VCOUNT_H
+#define VCOUNT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+세로(vertical) 카운터 : GPIO 32개의 카운터를 bit-plane으로 저장, 모든 채널을 mask 연산 몇 번으로 동시에 갱신
+- b[k] 의 bit n = 채널(GPIO) n 카운터의 k번째 bit → 카운터 범위 0 ~ (1 << VCOUNT_BITS) - 1
+- 채널 수와 상관없이 갱신 비용 일정 (gpio_get_all() 1회 + 연산 몇 번)
+- vdebounce : 상태와 다른 샘플이 n회 연속이면 상태 반전 (대칭 디바운스, 리밋 스위치 등)
+(header only)
+*/
+
+#ifndef VCOUNT_BITS
+#define VCOUNT_BITS     4u
+#endif
+
+#define VCOUNT_MAX      ((1u << VCOUNT_BITS) - 1u)
+
+typedef struct {
+    uint32_t b[VCOUNT_BITS];
+} vcount_t;
+
+// mask bit 카운터 = 0
+static inline void vcount_clear(vcount_t *c, uint32_t mask) {
+    for (uint32_t k = 0; k < VCOUNT_BITS; k++) c->b[k] &= ~mask;
+}
+
+// mask bit 카운터 += 1 (ripple carry, VCOUNT_MAX에서 0으로 넘어가므로 호출 쪽에서 n <= VCOUNT_MAX로 끊을 것)
+static inline void vcount_inc(vcount_t *c, uint32_t mask) {
+    uint32_t carry = mask;
+    for (uint32_t k = 0; k < VCOUNT_BITS && carry; k++) {
+        uint32_t next = c->b[k] & carry;
+        c->b[k] ^= carry;
+        carry = next;
+    }
+}
+
+// 카운터 == n 인 bit mask
+static inline uint32_t vcount_eq(const vcount_t *c, uint32_t n) {
+    uint32_t eq = ~0u;
+    for (uint32_t k = 0; k < VCOUNT_BITS; k++) {
+        eq &= ((n >> k) & 1u) ? c->b[k] : ~c->b[k];
+    }
+    return eq;
+}
+
+// ------------ 대칭 디바운스 ------------
+typedef struct {
+    vcount_t cnt;
+    uint32_t state;         // 확정 상태
+} vdebounce_t;
+
+static inline void vdebounce_init(vdebounce_t *d, uint32_t sample) {
+    for (uint32_t k = 0; k < VCOUNT_BITS; k++) d->cnt.b[k] = 0;
+    d->state = sample;
+}
+
+// 샘플 1회, 이번에 상태가 바뀐 bit 반환 (n : 1 ~ VCOUNT_MAX)
+static inline uint32_t vdebounce_update(vdebounce_t *d, uint32_t sample, uint32_t n) {
+    uint32_t diff = sample ^ d->state;
+    vcount_clear(&d->cnt, ~diff);       // 상태와 같으면 카운트 처음부터
+    vcount_inc(&d->cnt, diff);
+
+    uint32_t flip = vcount_eq(&d->cnt, n) & diff;
+    d->state ^= flip;
+    vcount_clear(&d->cnt, flip);
+    return flip;
+}
+
+#endif